@@ -144,7 +144,8 @@ enum Capability {
   HasMixerExpo,
   HasBatMeterRange,
   DangerousFunctions,
-  HasModelCategories
+  HasModelCategories,
+  CapabilitiesCount   // must stay last, size of the capability tables
 };
 
 class EEPROMInterface
@@ -151,6 +151,30 @@ QVector<const MixData *> ModelData::mixes(int channel) const
   return result;
 }
 
+QVector<QVector<int>> ModelData::exposByInput(int inputs) const
+{
+  QVector<QVector<int>> result(inputs);
+  for (int i=0; i<CPN_MAX_EXPOS; i++) {
+    const ExpoData & ed = expoData[i];
+    if ((int)ed.chn < inputs && ed.mode != 0) {
+      result[ed.chn] << i;
+    }
+  }
+  return result;
+}
+
+QVector<QVector<int>> ModelData::mixesByChannel(int channels) const
+{
+  QVector<QVector<int>> result(channels);
+  for (int i=0; i<CPN_MAX_MIXERS; i++) {
+    const MixData & md = mixData[i];
+    if (md.destCh > 0 && (int)md.destCh <= channels) {
+      result[md.destCh-1] << i;
+    }
+  }
+  return result;
+}
+
 void ModelData::removeInput(const int idx, bool clearName)
 {
   unsigned int chn = expoData[idx].chn;
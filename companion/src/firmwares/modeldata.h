@@ -144,6 +144,9 @@ class ModelData {
 
     QVector<const ExpoData *> expos(int input) const;
     QVector<const MixData *> mixes(int channel) const;
+    // indexes of the lines of each input / output channel, in a single pass
+    QVector<QVector<int>> exposByInput(int inputs) const;
+    QVector<QVector<int>> mixesByChannel(int channels) const;
 
     bool      used;
     int       category;
@@ -416,7 +416,15 @@ Firmware * OpenTxFirmware::getFirmwareVariant(const QString &id)
   }
 }
 
-int OpenTxFirmware::getCapability(::Capability capability)
+void OpenTxFirmware::initCapabilities()
+{
+  static_assert(sizeof(capabilities) / sizeof(capabilities[0]) == CapabilitiesCount, "one slot per capability");
+  for (int i = 0; i < CapabilitiesCount; i++) {
+    capabilities[i] = computeCapability((::Capability)i);
+  }
+}
+
+int OpenTxFirmware::computeCapability(::Capability capability)
 {
   switch (capability) {
     case Models:
@@ -516,7 +524,7 @@ int OpenTxFirmware::getCapability(::Capability capability)
         return 12;
     case CustomAndSwitches:
       if (IS_ARM(board))
-        return getCapability(LogicalSwitches);
+        return computeCapability(LogicalSwitches);
       else
         return 15/*4bits*/- 9/*sw positions*/;
     case LogicalSwitchesExt:
@@ -91,6 +91,7 @@ class OpenTxFirmware: public Firmware
       Firmware(parent, id, parent->getName(), parent->getBoard())
     {
       setEEpromInterface(parent->getEEpromInterface());
+      initCapabilities();
     }
 
     OpenTxFirmware(const QString & id, const QString & name, const Board::Type board):
@@ -119,6 +120,7 @@ class OpenTxFirmware: public Firmware
       addTTSLanguage("pt");
       addTTSLanguage("se");
       addTTSLanguage("sk");
+      initCapabilities();
     }
 
     virtual Firmware * getFirmwareVariant(const QString & id);
@@ -129,7 +131,10 @@ class OpenTxFirmware: public Firmware
 
     virtual QString getFirmwareUrl();
 
-    virtual int getCapability(Capability);
+    virtual int getCapability(Capability capability)
+    {
+      return capabilities[capability];
+    }
 
     virtual QString getAnalogInputName(unsigned int index);
 
@@ -141,6 +146,14 @@ class OpenTxFirmware: public Firmware
 
     QString getFirmwareBaseUrl();
 
+    // capabilities only depend on the board and the id, which never change,
+    // so they are computed once instead of on each of the many UI lookups
+    int capabilities[CapabilitiesCount];
+
+    void initCapabilities();
+
+    int computeCapability(Capability);
+
 };
 
 void registerOpenTxFirmwares();
@@ -68,53 +68,70 @@ InputsPanel::~InputsPanel()
 }
 
 void InputsPanel::update()
+{
+  // source and curve names may have been changed on other tabs
+  rowsText.clear();
+  updateRows();
+}
+
+/**
+  @brief Updates the list in place, only the lines whose contents changed get new HTML
+*/
+void InputsPanel::updateRows()
 {
   lock = true;
-  ExposlistWidget->clear();
+  const QVector<QVector<int>> inputs = model->exposByInput(inputsCount);
+  QHash<QByteArray, QString> text;
+  int row = 0;
+  ExposlistWidget->clearSelection();
   for (int i=0; i < inputsCount; ++i) {
-    bool filled = false;
-    for (uint j=0; j < CPN_MAX_EXPOS; ++j) {
-      const ExpoData & ed = model->expoData[j];
-      if ((int)ed.chn == i && ed.mode) {
-        AddInputLine(j);
-        filled = true;
-      }
+    const QVector<int> & expos = inputs.at(i);
+    if (expos.isEmpty()) {
+      setInputLine(row++, -i-1, false, false, text);
     }
-    if (!filled) {
-      AddInputLine(-i-1);
+    for (int j=0; j < expos.size(); ++j) {
+      setInputLine(row++, expos.at(j), j == 0, j < expos.size() - 1, text);
     }
   }
+  ExposlistWidget->truncate(row);
+  rowsText.swap(text);
   lock = false;
 }
 
 
 /**
-  @brief Creates new input line (list item) and adds it to the list widget
+  @brief Sets the input line (list item) of the given row
 
   @note Input lines are now HTML formated because they use same widget as mixers.
 
+  @param[in] row    row of the list widget, a new item is appended if it does not exist yet
   @param[in] dest   defines which input line to create.
                     If dest < 0 then create empty input slot for input -dest ( dest=-6 -> Input05)
                     if dest >=0 then create used input based on model input data from slot dest (dest=4 -> model expoData[4])
+  @param[in] text   HTML of the lines of this update, the HTML of the previous one is reused when the contents did not change
 */
-void InputsPanel::AddInputLine(int dest)
+void InputsPanel::setInputLine(int row, int dest, bool newChan, bool hasSibs, QHash<QByteArray, QString> & text)
 {
   QByteArray qba(1, (quint8)dest);
   unsigned destId = abs(dest);
-  bool newChan = false;
-  bool hasSibs = false;
+  int chn = -dest - 1;
   if (dest >= 0 && dest < CPN_MAX_EXPOS) {
     //add input data
     const ExpoData &md = model->expoData[dest];
     qba.append((const char*)&md, sizeof(ExpoData));
     destId = md.chn + 1;
-    const QVector<const ExpoData *> expos = model->expos(md.chn);
-    newChan = (expos.constFirst() == &md);
-    hasSibs = (expos.constLast() != &md);
+    chn = md.chn;
   }
-  QListWidgetItem *itm = new QListWidgetItem(getInputText(dest, newChan));
-  itm->setData(Qt::UserRole, qba);
-  ExposlistWidget->addItem(itm, destId, newChan, hasSibs);
+
+  // the expo slot itself does not change the HTML, the input name does
+  QByteArray key = (dest < 0 ? qba : qba.mid(1));
+  key.append((char)newChan).append(model->inputNames[chn], sizeof(model->inputNames[chn]));
+  QString str = rowsText.value(key);
+  if (!rowsText.contains(key))
+    str = getInputText(dest, newChan);
+  text.insert(key, str);
+
+  ExposlistWidget->setRow(row, str, qba, destId, newChan, hasSibs);
 }
 
 
@@ -186,14 +203,14 @@ void InputsPanel::gm_openExpo(int index)
       if (firmware->getCapability(VirtualInputs))
         strncpy(model->inputNames[mixd.chn], inputName.toLatin1().data(), 4);
       emit modified();
-      update();
+      updateRows();
     }
     else {
       if (expoInserted) {
         gm_deleteExpo(index);
       }
       expoInserted=false;
-      update();
+      updateRows();
     }
 }
 
@@ -242,7 +259,7 @@ void InputsPanel::exposDelete(bool ask)
     if ((ret == QMessageBox::Yes) || (!ask)) {
         exposDeleteList(list, ask);
         emit modified();
-        update();
+        updateRows();
     }
 }
 
@@ -313,7 +330,7 @@ void InputsPanel::pasteExpoMimeData(const QMimeData * mimeData, int destIdx)
     }
 
     emit modified();
-    update();
+    updateRows();
   }
 }
 
@@ -461,7 +478,7 @@ void InputsPanel::moveExpoList(bool down)
   }
   if (mod) {
     emit modified();
-    update();
+    updateRows();
   }
   setSelectedByExpoList(highlightList);
 }
@@ -497,7 +514,7 @@ void InputsPanel::clearExpos()
   if (QMessageBox::question(this, tr("Clear Inputs?"), tr("Really clear all the inputs?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
     model->clearInputs();
     emit modified();
-    update();
+    updateRows();
   }
 }
 
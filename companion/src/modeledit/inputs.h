@@ -58,6 +58,7 @@ class InputsPanel : public ModelPanel
     MixersListWidget *ExposlistWidget;
     int inputsCount;
     ModelPrinter modelPrinter;
+    QHash<QByteArray, QString> rowsText;  // HTML of the lines, by line contents
 
     int getExpoIndex(unsigned int dch);
     bool gm_insertExpo(int idx);
@@ -68,7 +69,8 @@ class InputsPanel : public ModelPanel
     QList<int> createExpoListFromSelected();
     void setSelectedByExpoList(QList<int> list);
     void pasteExpoMimeData(const QMimeData * mimeData, int destIdx);
-    void AddInputLine(int dest);
+    void updateRows();
+    void setInputLine(int row, int dest, bool newChan, bool hasSibs, QHash<QByteArray, QString> & text);
     QString getInputText(int dest, bool newChan);
 
 };
@@ -87,7 +87,41 @@ void MixersListWidget::keyPressEvent(QKeyEvent *event)
 
 void MixersListWidget::addItem(QListWidgetItem * item, const unsigned & rowId, bool topLevel, bool hasSib)
 {
-  Qt::ItemFlags f = item->flags();
+  setItemGroup(item, rowId, topLevel, hasSib);
+  QListWidget::addItem(item);
+  //qDebug() << rowId << topLevel << hasSib << item->data(GroupHeaderRole).toUInt();
+}
+
+/**
+    @brief Updates the item of the given row in place, or appends a new one
+
+    Roles set to an unchanged value emit nothing, so the view only repaints the rows which were touched.
+*/
+void MixersListWidget::setRow(int row, const QString & text, const QByteArray & data, const unsigned & rowId, bool topLevel, bool hasSib)
+{
+  QListWidgetItem * itm = item(row);
+  if (!itm) {
+    itm = new QListWidgetItem(text);
+    itm->setData(Qt::UserRole, data);
+    addItem(itm, rowId, topLevel, hasSib);
+    return;
+  }
+
+  itm->setText(text);
+  itm->setData(Qt::UserRole, data);
+  setItemGroup(itm, rowId, topLevel, hasSib);
+}
+
+void MixersListWidget::truncate(int rows)
+{
+  while (count() > rows) {
+    delete takeItem(count() - 1);
+  }
+}
+
+void MixersListWidget::setItemGroup(QListWidgetItem * item, const unsigned & rowId, bool topLevel, bool hasSib)
+{
+  Qt::ItemFlags f = item->flags() | Qt::ItemIsDragEnabled;
   f |= Qt::ItemIsDropEnabled;
 
   quint8 hdrRole = 0;
@@ -100,12 +134,11 @@ void MixersListWidget::addItem(QListWidgetItem * item, const unsigned & rowId, b
   else
     f &= ~Qt::ItemIsDragEnabled;  // prevent drag of empty items
 
+  // setting an unchanged value does not emit anything
   item->setData(GroupIdRole, rowId);
   item->setData(GroupHeaderRole, hdrRole);
-  item->setFlags(f);
-
-  QListWidget::addItem(item);
-  //qDebug() << rowId << topLevel << hasSib << item->data(GroupHeaderRole).toUInt();
+  if (item->flags() != f)
+    item->setFlags(f);
 }
 
 /**
@@ -42,6 +42,8 @@ class MixersListWidget : public QListWidget
 
   public slots:
     void addItem(QListWidgetItem *item, const unsigned & rowId, bool topLevel = false, bool hasSib = false);
+    void setRow(int row, const QString & text, const QByteArray & data, const unsigned & rowId, bool topLevel = false, bool hasSib = false);
+    void truncate(int rows);
     bool dropMimeData(int index, const QMimeData *data, Qt::DropAction action);
     void zoomView();
 
@@ -52,6 +54,8 @@ class MixersListWidget : public QListWidget
     QString itemMimeFmt;
     bool expo;
 
+    void setItemGroup(QListWidgetItem *item, const unsigned & rowId, bool topLevel, bool hasSib);
+
 };
 
 /**
@@ -63,52 +63,69 @@ MixesPanel::~MixesPanel()
 }
 
 void MixesPanel::update()
+{
+  // channel, input and curve names may have been changed on other tabs
+  rowsText.clear();
+  updateRows();
+}
+
+/**
+  @brief Updates the list in place, only the lines whose contents changed get new HTML
+*/
+void MixesPanel::updateRows(bool clearSelection)
 {
   lock = true;
-  mixersListWidget->clear();
-  for (int i=0; i < firmware->getCapability(Outputs); ++i) {
-    bool filled = false;
-    for (int j=0; j < firmware->getCapability(Mixes); ++j) {
-      const MixData & mix = model->mixData[j];
-      if ((int)mix.destCh == i+1) {
-        AddMixerLine(j);
-        filled = true;
-      }
+  const int outputs = firmware->getCapability(Outputs);
+  const QVector<QVector<int>> channels = model->mixesByChannel(outputs);
+  QHash<QByteArray, QString> text;
+  int row = 0;
+  if (clearSelection)
+    mixersListWidget->clearSelection();
+  for (int i=0; i < outputs; ++i) {
+    const QVector<int> & mixes = channels.at(i);
+    if (mixes.isEmpty()) {
+      setMixerLine(row++, -i-1, false, false, text);
     }
-    if (!filled) {
-      AddMixerLine(-i-1);
+    for (int j=0; j < mixes.size(); ++j) {
+      setMixerLine(row++, mixes.at(j), j == 0, j < mixes.size() - 1, text);
     }
   }
+  mixersListWidget->truncate(row);
+  rowsText.swap(text);
   lock = false;
 }
 
 /**
-  @brief Creates new mixer line (list item) and adds it to the list widget
+  @brief Sets the mixer line (list item) of the given row
 
   @note Mixer lines are now HTML formated in order to support bold text.
 
+  @param[in] row    row of the list widget, a new item is appended if it does not exist yet
   @param[in] dest   defines which mixer line to create.
                     If dest < 0 then create empty channel slot fo channel -dest ( dest=-2 -> CH2)
                     if dest >=0 then create used channel based on model mix data from slot dest (dest=4 -> model mix[4])
+  @param[in] text   HTML of the lines of this update, the HTML of the previous one is reused when the contents did not change
 */
-void MixesPanel::AddMixerLine(int dest)
+void MixesPanel::setMixerLine(int row, int dest, bool newChan, bool hasSibs, QHash<QByteArray, QString> & text)
 {
   QByteArray qba(1, (quint8)dest);
   unsigned destId = abs(dest);
-  bool newChan = false;
-  bool hasSibs = false;
   if (dest >= 0) {
     //add mix data
     const MixData & md = model->mixData[dest];
     qba.append((const char*)&md, sizeof(MixData));
     destId = md.destCh;
-    const QVector<const MixData *> mixes = model->mixes(md.destCh-1);
-    newChan = (mixes.constFirst() == &md);
-    hasSibs = (mixes.constLast() != &md);
   }
-  QListWidgetItem *itm = new QListWidgetItem(getMixerText(dest, newChan));
-  itm->setData(Qt::UserRole, qba);
-  mixersListWidget->addItem(itm, destId, newChan, hasSibs);
+
+  // the mix slot itself does not change the HTML
+  QByteArray key = (dest < 0 ? qba : qba.mid(1));
+  key.append((char)newChan).append((char)highlightedSource);
+  QString str = rowsText.value(key);
+  if (!rowsText.contains(key))
+    str = getMixerText(dest, newChan);
+  text.insert(key, str);
+
+  mixersListWidget->setRow(row, str, qba, destId, newChan, hasSibs);
 }
 
 /**
@@ -179,14 +196,14 @@ void MixesPanel::gm_openMix(int index)
   if(g->exec()) {
     model->mixData[index] = mixd;
     emit modified();
-    update();
+    updateRows();
   }
   else {
     if (mixInserted) {
       gm_deleteMix(index);
     }
     mixInserted = false;
-    update();
+    updateRows();
   }
 }
 
@@ -269,7 +286,7 @@ void MixesPanel::mixersDelete(bool ask)
   if ((ret == QMessageBox::Yes) || (!ask)) {
     mixersDeleteList(list);
     emit modified();
-    update();
+    updateRows();
   }
 }
 
@@ -323,7 +340,7 @@ void MixesPanel::pasteMixerMimeData(const QMimeData * mimeData, int destIdx)
     }
 
     emit modified();
-    update();
+    updateRows();
   }
 }
 
@@ -373,10 +390,7 @@ void MixesPanel::mixerHighlight()
   }
   highlightedSource = ( (int)highlightedSource ==  dest) ? 0 : dest;
   // qDebug() << "MixesPanel::mixerHighlight(): " << highlightedSource ;
-  for(int i=0; i<mixersListWidget->count(); i++) {
-    int t = mixersListWidget->item(i)->data(Qt::UserRole).toByteArray().at(0);
-    mixersListWidget->item(i)->setText(getMixerText(t, 0));
-  }
+  updateRows(false);
 }
 
 void MixesPanel::mixerAdd()
@@ -506,7 +520,7 @@ void MixesPanel::moveMixUp()
     highlightList << gm_moveMix(idx, false);
   }
   emit modified();
-  update();
+  updateRows();
   setSelectedByMixList(highlightList);
 }
 
@@ -518,7 +532,7 @@ void MixesPanel::moveMixDown()
     highlightList << gm_moveMix(idx, true);
   }
   emit modified();
-  update();
+  updateRows();
   setSelectedByMixList(highlightList);
 }
 
@@ -527,6 +541,6 @@ void MixesPanel::clearMixes()
   if (QMessageBox::question(this, tr("Clear Mixes?"), tr("Really clear all the mixes?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes) {
     model->clearMixes();
     emit modified();
-    update();
+    updateRows();
   }
 }
@@ -63,6 +63,7 @@ class MixesPanel : public ModelPanel
     bool mixInserted;
     unsigned int highlightedSource;
     ModelPrinter modelPrinter;
+    QHash<QByteArray, QString> rowsText;  // HTML of the lines, by line contents
 
     int getMixerIndex(unsigned int dch);
     bool gm_insertMix(int idx);
@@ -72,7 +73,8 @@ class MixesPanel : public ModelPanel
     void mixersDeleteList(QList<int> list);
     QList<int> createMixListFromSelected();
     void setSelectedByMixList(QList<int> list);
-    void AddMixerLine(int dest);
+    void updateRows(bool clearSelection = true);
+    void setMixerLine(int row, int dest, bool newChan, bool hasSibs, QHash<QByteArray, QString> & text);
     QString getMixerText(int dest, bool newChannel);
 };
 
@@ -22,9 +22,16 @@
 
 #include <QApplication>
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QMutexLocker>
 #include <QDirIterator>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QtEndian>
 #include <QDebug>
 
 #if (QT_VERSION < QT_VERSION_CHECK(5, 5, 0))
@@ -41,6 +48,256 @@
 #define PRINT_SEP()           PRINT_INFO(QString(80, '='))
 
 #define SYNC_MAX_ERRORS         50  // give up after this many errors per destination
+#define SYNC_HASH_CHUNK_SIZE    (256 * 1024)  // read buffer per hashing thread
+#define SYNC_MANIFEST_MAGIC     0x4F545853  // "OTXS"
+#define SYNC_MANIFEST_VERSION   1
+
+/*
+ * SyncHasher
+ */
+
+#define XXH_PRIME64_1   0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2   0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3   0x165667B19E3779F9ULL
+#define XXH_PRIME64_4   0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5   0x27D4EB2F165667C5ULL
+
+static inline quint64 xxhRotl(quint64 x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline quint64 xxhRound(quint64 acc, quint64 input)
+{
+  acc += input * XXH_PRIME64_2;
+  acc = xxhRotl(acc, 31);
+  return acc * XXH_PRIME64_1;
+}
+
+static inline quint64 xxhMergeRound(quint64 acc, quint64 val)
+{
+  acc ^= xxhRound(0, val);
+  return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+SyncHasher::SyncHasher(quint64 seed)
+{
+  reset(seed);
+}
+
+void SyncHasher::reset(quint64 seed)
+{
+  this->seed = seed;
+  v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+  v[1] = seed + XXH_PRIME64_2;
+  v[2] = seed;
+  v[3] = seed - XXH_PRIME64_1;
+  totalLen = 0;
+  bufferSize = 0;
+}
+
+void SyncHasher::update(const char * data, qint64 len)
+{
+  const uchar * p = reinterpret_cast<const uchar *>(data);
+  const uchar * end = p + len;
+
+  totalLen += len;
+
+  if (bufferSize + len < 32) {
+    memcpy(buffer + bufferSize, p, len);
+    bufferSize += len;
+    return;
+  }
+
+  if (bufferSize) {
+    int fill = 32 - bufferSize;
+    memcpy(buffer + bufferSize, p, fill);
+    for (int i = 0; i < 4; i++)
+      v[i] = xxhRound(v[i], qFromLittleEndian<quint64>(buffer + i * 8));
+    p += fill;
+    bufferSize = 0;
+  }
+
+  while (p + 32 <= end) {
+    for (int i = 0; i < 4; i++)
+      v[i] = xxhRound(v[i], qFromLittleEndian<quint64>(p + i * 8));
+    p += 32;
+  }
+
+  if (p < end) {
+    bufferSize = end - p;
+    memcpy(buffer, p, bufferSize);
+  }
+}
+
+quint64 SyncHasher::digest() const
+{
+  quint64 h;
+
+  if (totalLen >= 32) {
+    h = xxhRotl(v[0], 1) + xxhRotl(v[1], 7) + xxhRotl(v[2], 12) + xxhRotl(v[3], 18);
+    for (int i = 0; i < 4; i++)
+      h = xxhMergeRound(h, v[i]);
+  }
+  else {
+    h = seed + XXH_PRIME64_5;
+  }
+
+  h += totalLen;
+
+  const uchar * p = buffer;
+  const uchar * end = buffer + bufferSize;
+  while (p + 8 <= end) {
+    h ^= xxhRound(0, qFromLittleEndian<quint64>(p));
+    h = xxhRotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h ^= quint64(qFromLittleEndian<quint32>(p)) * XXH_PRIME64_1;
+    h = xxhRotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+    p += 4;
+  }
+  while (p < end) {
+    h ^= (*p++) * XXH_PRIME64_5;
+    h = xxhRotl(h, 11) * XXH_PRIME64_1;
+  }
+
+  h ^= h >> 33;
+  h *= XXH_PRIME64_2;
+  h ^= h >> 29;
+  h *= XXH_PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+/*
+ * SyncManifest
+ */
+
+SyncManifest::SyncManifest(const QString & rootPath):
+  rootPath(rootPath),
+  dirty(false)
+{
+}
+
+QString SyncManifest::fileName() const
+{
+  // manifests are kept with the local app cache, never on the synchronized folders themselves
+  QString key = QString::fromLatin1(QCryptographicHash::hash(QDir(rootPath).absolutePath().toUtf8(), QCryptographicHash::Md5).toHex());
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) % "/sync/" % key % ".manifest";
+}
+
+bool SyncManifest::load()
+{
+  entries.clear();
+  dirty = false;
+
+  if (rootPath.isEmpty())
+    return false;
+
+  QFile file(fileName());
+  if (!file.open(QFile::ReadOnly))
+    return false;
+
+  QDataStream in(&file);
+  quint32 magic, version;
+  in >> magic >> version;
+  if (magic != SYNC_MANIFEST_MAGIC || version != SYNC_MANIFEST_VERSION)
+    return false;
+
+  quint32 count;
+  in >> count;
+  entries.reserve(count);
+  for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+    QString path;
+    Entry entry;
+    in >> path >> entry.size >> entry.mtime >> entry.hash;
+    entries.insert(path, entry);
+  }
+
+  if (in.status() != QDataStream::Ok) {
+    qWarning() << "Discarding corrupted sync manifest" << file.fileName();
+    entries.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool SyncManifest::save()
+{
+  if (!dirty || rootPath.isEmpty())
+    return true;
+
+  QString path = fileName();
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QSaveFile file(path);
+  if (!file.open(QFile::WriteOnly))
+    return false;
+
+  QDataStream out(&file);
+  out << quint32(SYNC_MANIFEST_MAGIC) << quint32(SYNC_MANIFEST_VERSION) << quint32(entries.size());
+  for (QHash<QString, Entry>::const_iterator it = entries.constBegin(); it != entries.constEnd(); ++it)
+    out << it.key() << it->size << it->mtime << it->hash;
+
+  if (!file.commit())
+    return false;
+
+  dirty = false;
+  return true;
+}
+
+bool SyncManifest::lookup(const QString & relPath, const QFileInfo & info, quint64 & hash) const
+{
+  QHash<QString, Entry>::const_iterator it = entries.constFind(relPath);
+  if (it == entries.constEnd() || it->size != info.size() || it->mtime != info.lastModified().toMSecsSinceEpoch())
+    return false;
+  hash = it->hash;
+  return true;
+}
+
+void SyncManifest::update(const QString & relPath, const QFileInfo & info, quint64 hash)
+{
+  Entry entry = { info.size(), info.lastModified().toMSecsSinceEpoch(), hash };
+  entries.insert(relPath, entry);
+  dirty = true;
+}
+
+/*
+ * SyncHashTask
+ */
+
+class SyncHashTask : public QRunnable
+{
+  public:
+    struct Job {
+      QString path;
+      quint64 hash;
+      bool ok;
+    };
+
+    SyncHashTask(Job * job, QAtomicInt * abort, QAtomicInteger<qint64> * bytesCounter):
+      job(job),
+      abort(abort),
+      bytesCounter(bytesCounter)
+    {
+    }
+
+    virtual void run()
+    {
+      job->ok = SyncProcess::hashFile(job->path, job->hash, abort, bytesCounter);
+    }
+
+  protected:
+    Job * job;
+    QAtomicInt * abort;
+    QAtomicInteger<qint64> * bytesCounter;
+};
+
+/*
+ * SyncProcess
+ */
 
 SyncProcess::SyncProcess(const QString & folderA, const QString & folderB, const int & syncDirection, const int & compareType, const qint64 & maxFileSize, const bool dryRun):
   folder1(folderA),
@@ -48,6 +305,11 @@ SyncProcess::SyncProcess(const QString & folderA, const QString & folderB, const
   direction((SyncDirection)syncDirection),
   ctype((SyncCompareType)compareType),
   maxFileSize(qMax<qint64>(0, maxFileSize)),
+  bytesCopied(0),
+  bytesSkipped(0),
+  bytesHashed(0),
+  abortHashing(0),
+  hashTime(0),
   dryRun(dryRun),
   stopping(false)
 {
@@ -71,6 +333,7 @@ void SyncProcess::stop()
 {
   QMutexLocker locker(&stopReqMutex);
   stopping = true;
+  abortHashing.storeRelease(1);
 }
 
 bool SyncProcess::isStopRequsted()
@@ -82,6 +345,14 @@ bool SyncProcess::isStopRequsted()
 void SyncProcess::run()
 {
   count = index = created = updated = skipped = errored = 0;
+  bytesCopied = bytesSkipped = hashTime = 0;
+  bytesHashed.storeRelease(0);
+  hashCache.clear();
+
+  manifest1 = SyncManifest(folder1);
+  manifest1.load();
+  manifest2 = SyncManifest(folder2);
+  manifest2.load();
 
   emit started();
   emit progressStep(index);
@@ -129,11 +400,144 @@ void SyncProcess::run()
 
 void SyncProcess::finish()
 {
-  QString endStr = testRunStr % tr("Synchronization finished. ") % reportTemplate;
+  abortHashing.storeRelease(1);
+  if (!manifest1.save() || !manifest2.save())
+    qWarning() << "Could not save sync manifests";
+
+  QString endStr = testRunStr % tr("Synchronization finished. ") % reportTemplate % "<br>" % throughputReport();
   emit statusMessage(endStr.arg(created).arg(updated).arg(skipped).arg(errored).arg(errored ? "red" : "black"));
   emit finished();
 }
 
+QString SyncProcess::throughputReport() const
+{
+  const double mb = 1024.0 * 1024.0;
+  qint64 hashed = bytesHashed.loadAcquire();
+  QString rate = hashTime > 0 ? QString::number(hashed / mb / (hashTime / 1000.0), 'f', 1) : QString("-");
+  return tr("Copied: <b>%1 MB</b>; Unchanged: <b>%2 MB</b>; Hashed: <b>%3 MB</b> (%4 MB/s)")
+      .arg(bytesCopied / mb, 0, 'f', 1).arg(bytesSkipped / mb, 0, 'f', 1).arg(hashed / mb, 0, 'f', 1).arg(rate);
+}
+
+SyncManifest & SyncProcess::manifestFor(const QDir & folder)
+{
+  return (folder.absolutePath() == QDir(folder1).absolutePath() ? manifest1 : manifest2);
+}
+
+bool SyncProcess::hashFile(const QString & path, quint64 & hash, QAtomicInt * abort, QAtomicInteger<qint64> * bytesCounter)
+{
+  QFile file(path);
+  if (!file.open(QFile::ReadOnly))
+    return false;
+
+  QByteArray buffer(SYNC_HASH_CHUNK_SIZE, Qt::Uninitialized);
+  SyncHasher hasher;
+  qint64 len;
+  while ((len = file.read(buffer.data(), buffer.size())) > 0) {
+    if (abort && abort->loadAcquire())
+      return false;
+    hasher.update(buffer.constData(), len);
+    if (bytesCounter)
+      bytesCounter->fetchAndAddRelaxed(len);
+  }
+  if (len < 0)
+    return false;
+
+  hash = hasher.digest();
+  return true;
+}
+
+bool SyncProcess::getFileHash(const QString & relPath, const QFileInfo & info, SyncManifest & manifest, quint64 & hash)
+{
+  QString path = info.absoluteFilePath();
+  QHash<QString, quint64>::const_iterator it = hashCache.constFind(path);
+  if (it != hashCache.constEnd()) {
+    hash = it.value();
+    return true;
+  }
+  if (manifest.lookup(relPath, info, hash)) {
+    hashCache.insert(path, hash);
+    return true;
+  }
+  // not pre-hashed (eg. a file which appeared during sync), do it now
+  if (!hashFile(path, hash, NULL, &bytesHashed))
+    return false;
+  hashCache.insert(path, hash);
+  manifest.update(relPath, info, hash);
+  return true;
+}
+
+// Hash, in parallel, all the files which need a content comparison and are not already known by the manifests
+void SyncProcess::hashCandidates(const QStringList & entries, const QDir & source, const QDir & destination)
+{
+  SyncManifest & srcManifest = manifestFor(source);
+  SyncManifest & dstManifest = manifestFor(destination);
+  bool checkDate = (ctype == OVERWR_NEWER_IF_DIFF || ctype == OVERWR_NEWER_ALWAYS);
+  QVector<SyncHashTask::Job> jobs;
+  QVector<QString> jobRelPaths;
+  QVector<SyncManifest *> jobManifests;
+  qint64 totalBytes = 0;
+
+  foreach (const QString & entry, entries) {
+    QString relPath = source.relativeFilePath(entry);
+    QFileInfo sourceInfo(source.absoluteFilePath(entry));
+    QFileInfo destInfo(destination.absoluteFilePath(relPath));
+    if (!sourceInfo.isFile() || !destInfo.isFile() || sourceInfo.size() != destInfo.size())
+      continue;
+    if (checkDate && sourceInfo.lastModified() <= destInfo.lastModified())
+      continue;
+
+    const QFileInfo * infos[2] = { &sourceInfo, &destInfo };
+    SyncManifest * manifests[2] = { &srcManifest, &dstManifest };
+    for (int i = 0; i < 2; i++) {
+      QString path = infos[i]->absoluteFilePath();
+      quint64 hash;
+      if (hashCache.contains(path))
+        continue;
+      if (manifests[i]->lookup(relPath, *infos[i], hash)) {
+        hashCache.insert(path, hash);
+        continue;
+      }
+      SyncHashTask::Job job = { path, 0, false };
+      jobs.append(job);
+      jobRelPaths.append(relPath);
+      jobManifests.append(manifests[i]);
+      totalBytes += infos[i]->size();
+    }
+  }
+
+  if (jobs.isEmpty())
+    return;
+
+  const double mb = 1024.0 * 1024.0;
+  QString statusStr = testRunStr % tr("Comparing %1 files: %2 of %3 MB (%4 MB/s)");
+  QThreadPool pool;
+  pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+  abortHashing.storeRelease(0);
+  qint64 startBytes = bytesHashed.loadAcquire();
+  hashTimer.start();
+
+  // jobs vector is not resized from here on, tasks keep pointers into it
+  for (int i = 0; i < jobs.size(); i++)
+    pool.start(new SyncHashTask(&jobs[i], &abortHashing, &bytesHashed));
+
+  while (!pool.waitForDone(100)) {
+    qint64 done = bytesHashed.loadAcquire() - startBytes;
+    qint64 elapsed = qMax<qint64>(1, hashTimer.elapsed());
+    emit statusMessage(statusStr.arg(jobs.size()).arg(done / mb, 0, 'f', 1).arg(totalBytes / mb, 0, 'f', 1).arg(done / mb / (elapsed / 1000.0), 0, 'f', 1));
+    QApplication::processEvents();
+    if (isStopRequsted())
+      abortHashing.storeRelease(1);
+  }
+  hashTime += hashTimer.elapsed();
+
+  for (int i = 0; i < jobs.size(); i++) {
+    if (!jobs[i].ok)
+      continue;  // updateEntry() will retry and report the error
+    hashCache.insert(jobs[i].path, jobs[i].hash);
+    jobManifests[i]->update(jobRelPaths[i], QFileInfo(jobs[i].path), jobs[i].hash);
+  }
+}
+
 int SyncProcess::getFilesCount(const QString & directory)
 {
   if (!QFile::exists(directory))
@@ -156,24 +560,35 @@ void SyncProcess::updateDir(const QString & source, const QString & destination)
 
   PRINT_INFO(testRunStr % tr("Starting synchronization: %1 -&gt; %2<br>").arg(source, destination));
 
+  QStringList entries;
   QDirIterator it(source, dirFilters, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
   while (it.hasNext() && !isStopRequsted()) {
     it.next();
-    ++index;
-    emit statusMessage(statusStr.arg(index).arg(count).arg(reportTemplate.arg(created).arg(updated).arg(skipped).arg(errored).arg(errored ? "red" : "black")));
-    emit progressStep(index);
     if (maxFileSize && it.fileInfo().isFile() && it.fileInfo().size() > maxFileSize) {
       PRINT_SKIP(tr("Skipping large file: %1 (%2KB)").arg(it.fileName()).arg(int(it.fileInfo().size() / 1024)));
+      ++index;
       ++skipped;
+      bytesSkipped += it.fileInfo().size();
     }
     else {
-      updateEntry(it.filePath(), source, destination);
-      if (errored - counts[3] > SYNC_MAX_ERRORS) {
-        PRINT_ERROR(tr("<br><b>Too many errors, giving up.<b>"));
-        break;
-      }
+      entries.append(it.filePath());
     }
-    QApplication::processEvents();
+  }
+
+  if ((ctype == OVERWR_NEWER_IF_DIFF || ctype == OVERWR_IF_DIFF) && !isStopRequsted())
+    hashCandidates(entries, source, destination);
+
+  for (int i = 0; i < entries.size() && !isStopRequsted(); i++) {
+    ++index;
+    emit statusMessage(statusStr.arg(index).arg(count).arg(reportTemplate.arg(created).arg(updated).arg(skipped).arg(errored).arg(errored ? "red" : "black")));
+    emit progressStep(index);
+    updateEntry(entries.at(i), source, destination);
+    if (errored - counts[3] > SYNC_MAX_ERRORS) {
+      PRINT_ERROR(tr("<br><b>Too many errors, giving up.<b>"));
+      break;
+    }
+    if (!(i % 16))
+      QApplication::processEvents();
   }
 
   QString endStr = "<br>" % testRunStr % tr("Finished synchronizing %1 -&gt; %2 :<br>&nbsp;&nbsp;&nbsp;&nbsp; %3").arg(source, destination, reportTemplate);
@@ -213,34 +628,42 @@ bool SyncProcess::updateEntry(const QString & entry, const QDir & source, const
   bool checkContent = (ctype == OVERWR_NEWER_IF_DIFF || ctype == OVERWR_IF_DIFF);
   bool existed = false;
 
+  SyncManifest & srcManifest = manifestFor(source);
+  SyncManifest & dstManifest = manifestFor(destination);
+  quint64 srcHash = 0;
+  bool srcHashKnown = false;
+
   if (destExists && checkDate) {
     if (sourceInfo.lastModified() <= destInfo.lastModified()) {
       PRINT_SKIP(tr("Skipping older file: %1").arg(srcPath));
       ++skipped;
+      bytesSkipped += sourceInfo.size();
       return true;
     }
     checkDate = false;
   }
 
   if (destExists && checkContent) {
-    if (!sourceFile.open(QFile::ReadOnly)) {
-      PRINT_ERROR(tr("Could not open source file '%1': %2").arg(srcPath, sourceFile.errorString()));
-      ++errored;
-      return false;
-    }
-    if (!destinationFile.open(QFile::ReadOnly)) {
-      PRINT_ERROR(tr("Could not open destination file '%1': %2").arg(destPath, destinationFile.errorString()));
-      ++errored;
-      return false;
-    }
-
-    bool skip =  QCryptographicHash::hash(sourceFile.readAll(), QCryptographicHash::Md5) == QCryptographicHash::hash(destinationFile.readAll(), QCryptographicHash::Md5);
-    sourceFile.close();
-    destinationFile.close();
-    if (skip) {
-      PRINT_SKIP(tr("Skipping identical file: %1").arg(srcPath));
-      ++skipped;
-      return true;
+    // different sizes means different contents, no need to read anything
+    if (sourceInfo.size() == destInfo.size()) {
+      quint64 destHash;
+      if (!getFileHash(relPath, sourceInfo, srcManifest, srcHash)) {
+        PRINT_ERROR(tr("Could not read source file '%1'").arg(srcPath));
+        ++errored;
+        return false;
+      }
+      srcHashKnown = true;
+      if (!getFileHash(relPath, destInfo, dstManifest, destHash)) {
+        PRINT_ERROR(tr("Could not read destination file '%1'").arg(destPath));
+        ++errored;
+        return false;
+      }
+      if (srcHash == destHash) {
+        PRINT_SKIP(tr("Skipping identical file: %1").arg(srcPath));
+        ++skipped;
+        bytesSkipped += sourceInfo.size();
+        return true;
+      }
     }
     checkContent = false;
   }
@@ -263,6 +686,13 @@ bool SyncProcess::updateEntry(const QString & entry, const QDir & source, const
       ++errored;
       return false;
     }
+    bytesCopied += sourceInfo.size();
+    if (!dryRun && srcHashKnown) {
+      // the copy has the same contents with a new time stamp
+      QFileInfo copiedInfo(destPath);
+      hashCache.insert(copiedInfo.absoluteFilePath(), srcHash);
+      dstManifest.update(relPath, copiedInfo, srcHash);
+    }
 
     if (existed)
       ++updated;
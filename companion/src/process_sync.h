@@ -22,9 +22,60 @@
 #define _PROCESS_SYNC_H_
 
 #include <QObject>
+#include <QAtomicInt>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
 #include <QMutex>
 #include <QString>
+#include <QVector>
+
+/*
+ * Incremental 64-bit xxHash (XXH64), fed in chunks so files can be hashed
+ * with a fixed size buffer regardless of their size.
+ */
+class SyncHasher
+{
+  public:
+    explicit SyncHasher(quint64 seed = 0);
+    void reset(quint64 seed = 0);
+    void update(const char * data, qint64 len);
+    quint64 digest() const;
+
+  protected:
+    quint64 v[4];
+    quint64 seed;
+    quint64 totalLen;
+    uchar buffer[32];
+    int bufferSize;
+};
+
+/*
+ * Per-folder cache of file hashes, keyed by relative path.
+ * An entry is only trusted while the size and modification time of the file still match.
+ */
+class SyncManifest
+{
+  public:
+    struct Entry {
+      qint64 size;
+      qint64 mtime;
+      quint64 hash;
+    };
+
+    explicit SyncManifest(const QString & rootPath = QString());
+    bool load();
+    bool save();
+    bool lookup(const QString & relPath, const QFileInfo & info, quint64 & hash) const;
+    void update(const QString & relPath, const QFileInfo & info, quint64 hash);
+    QString fileName() const;
+
+  protected:
+    QString rootPath;
+    QHash<QString, Entry> entries;
+    bool dirty;
+};
 
 class SyncProcess : public QObject
 {
@@ -52,6 +103,8 @@ class SyncProcess : public QObject
                 const qint64 & maxFileSize = 5*1024*1024,
                 const bool dryRun = false);
 
+    static bool hashFile(const QString & path, quint64 & hash, QAtomicInt * abort = NULL, QAtomicInteger<qint64> * bytesCounter = NULL);
+
   public slots:
     void run();
     void stop();
@@ -70,6 +123,10 @@ class SyncProcess : public QObject
     int getFilesCount(const QString & directory);
     void updateDir(const QString & source, const QString & destination);
     bool updateEntry(const QString & entry, const QDir & source, const QDir & destination);
+    void hashCandidates(const QStringList & entries, const QDir & source, const QDir & destination);
+    bool getFileHash(const QString & relPath, const QFileInfo & info, SyncManifest & manifest, quint64 & hash);
+    SyncManifest & manifestFor(const QDir & folder);
+    QString throughputReport() const;
 
     QString folder1;
     QString folder2;
@@ -86,6 +143,15 @@ class SyncProcess : public QObject
     int updated;
     int skipped;
     int errored;
+    qint64 bytesCopied;
+    qint64 bytesSkipped;
+    QAtomicInteger<qint64> bytesHashed;
+    QAtomicInt abortHashing;
+    QElapsedTimer hashTimer;
+    qint64 hashTime;  // ms
+    SyncManifest manifest1;
+    SyncManifest manifest2;
+    QHash<QString, quint64> hashCache;  // absolute path -> hash for the current run
     bool dryRun;
     bool stopping;
 };
@@ -47,12 +47,6 @@ RadioOutputsWidget::RadioOutputsWidget(SimulatorInterface * simulator, Firmware
   // link the channels and mixes display horizontal scroll
   connect(ui->channelsScroll->horizontalScrollBar(), &QScrollBar::sliderMoved, ui->mixersScroll->horizontalScrollBar(), &QScrollBar::setValue);
   connect(ui->mixersScroll->horizontalScrollBar(), &QScrollBar::sliderMoved, ui->channelsScroll->horizontalScrollBar(), &QScrollBar::setValue);
-
-  connect(m_simulator, &SimulatorInterface::channelOutValueChange, this, &RadioOutputsWidget::onChannelOutValueChange);
-  connect(m_simulator, &SimulatorInterface::channelMixValueChange, this, &RadioOutputsWidget::onChannelMixValueChange);
-  connect(m_simulator, &SimulatorInterface::virtualSwValueChange, this, &RadioOutputsWidget::onVirtSwValueChange);
-  connect(m_simulator, &SimulatorInterface::gVarValueChange, this, &RadioOutputsWidget::onGVarValueChange);
-  connect(m_simulator, &SimulatorInterface::phaseChanged, this, &RadioOutputsWidget::onPhaseChanged);
 }
 
 RadioOutputsWidget::~RadioOutputsWidget()
@@ -299,6 +293,39 @@ QWidget * RadioOutputsWidget::createLogicalSwitch(QWidget * parent, int switchNo
   return swtch;
 }
 
+void RadioOutputsWidget::updateOutputs(const SimulatorInterface::TxOutputsDelta & delta)
+{
+  const SimulatorInterface::TxOutputs & outputs = delta.values;
+
+  if (delta.changed.chans) {
+    for (int i=0; i < CPN_MAX_CHNOUT; i++) {
+      if (delta.changed.chans & ((quint32)1 << i)) {
+        onChannelOutValueChange(i, outputs.chans[i], delta.chanLimit);
+        onChannelMixValueChange(i, outputs.ex_chans[i], 512 * 2 * 2);
+      }
+    }
+  }
+
+  if (delta.changed.vsw) {
+    for (int i=0; i < CPN_MAX_LOGICAL_SWITCHES; i++) {
+      if (delta.changed.vsw & ((quint64)1 << i))
+        onVirtSwValueChange(i, outputs.vsw[i]);
+    }
+  }
+
+  for (int fm=0; fm < CPN_MAX_FLIGHT_MODES; fm++) {
+    if (!delta.changed.gvars[fm])
+      continue;
+    for (int gv=0; gv < CPN_MAX_GVARS; gv++) {
+      if (delta.changed.gvars[fm] & ((quint16)1 << gv))
+        onGVarValueChange(gv, outputs.gvars[fm][gv]);
+    }
+  }
+
+  if (delta.changed.phase)
+    onPhaseChanged(outputs.phase);
+}
+
 void RadioOutputsWidget::onChannelOutValueChange(quint8 index, qint32 value, qint32 limit)
 {
   if (m_channelsMap.contains(index)) {
@@ -358,7 +385,7 @@ void RadioOutputsWidget::onGVarValueChange(quint8 index, qint32 value)
   //qDebug() << index << value << gv.mode << gv.value << gv.prec << gv.unit;
 }
 
-void RadioOutputsWidget::onPhaseChanged(qint32 phase, const QString &)
+void RadioOutputsWidget::onPhaseChanged(qint32 phase)
 {
   QPalette::ColorRole fgrole, bgrole;
   QLabel * lbl;
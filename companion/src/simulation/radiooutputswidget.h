@@ -48,6 +48,8 @@ class RadioOutputsWidget : public QWidget
     explicit RadioOutputsWidget(SimulatorInterface * simulator, Firmware * firmware, QWidget * parent = 0);
     ~RadioOutputsWidget();
 
+    void updateOutputs(const SimulatorInterface::TxOutputsDelta & delta);
+
   public slots:
     void start();
     //void stop();
@@ -56,13 +58,13 @@ class RadioOutputsWidget : public QWidget
   protected slots:
     void saveState();
     void restoreState();
+
+  protected:
     void onChannelOutValueChange(quint8 index, qint32 value, qint32 limit);
     void onChannelMixValueChange(quint8 index, qint32 value, qint32 limit);
     void onVirtSwValueChange(quint8 index, qint32 value);
     void onGVarValueChange(quint8 index, qint32 value);
-    void onPhaseChanged(qint32 phase, const QString &);
-
-  protected:
+    void onPhaseChanged(qint32 phase);
     void changeEvent(QEvent *e);
     void setupChannelsDisplay(bool mixes = false);
     void setupLsDisplay();
@@ -118,6 +118,48 @@ class SimulatorInterface : public QObject
       // bool beep;
     };
 
+    // One tick worth of outputs: a full snapshot plus flags telling which values changed since the last delta read by the GUI
+    struct TxOutputsDelta {
+      struct Changes {
+        quint32 chans;                        // bit per channel, chans[] and/or ex_chans[]
+        quint64 vsw;                          // bit per logical switch
+        quint32 trims;                        // bit per trim
+        quint16 gvars[CPN_MAX_FLIGHT_MODES];  // bit per gvar, per flight mode
+        bool trimRange;
+        bool phase;
+
+        void clear() { memset(this, 0, sizeof(Changes)); }
+        bool any() const
+        {
+          if (chans || vsw || trims || trimRange || phase)
+            return true;
+          for (int i=0; i < CPN_MAX_FLIGHT_MODES; i++) {
+            if (gvars[i])
+              return true;
+          }
+          return false;
+        }
+        void merge(const Changes & other)
+        {
+          chans |= other.chans;
+          vsw |= other.vsw;
+          trims |= other.trims;
+          for (int i=0; i < CPN_MAX_FLIGHT_MODES; i++)
+            gvars[i] |= other.gvars[i];
+          trimRange |= other.trimRange;
+          phase |= other.phase;
+        }
+      };
+
+      TxOutputsDelta() { clear(); }
+      void clear() { memset(this, 0, sizeof(TxOutputsDelta)); }
+
+      TxOutputs values;
+      Changes changed;
+      qint32 chanLimit;                       // channel outputs range, depends on extended limits
+      char phaseName[16];
+    };
+
     virtual ~SimulatorInterface() {}
 
     virtual QString name() = 0;
@@ -127,6 +169,9 @@ class SimulatorInterface : public QObject
     virtual uint8_t getSensorInstance(uint16_t id, uint8_t defaultValue = 0) = 0;
     virtual uint16_t getSensorRatio(uint16_t id) = 0;
     virtual const int getCapability(Capability cap) = 0;
+    // Thread safe, returns false if no new outputs were published since the last call
+    virtual bool getOutputsDelta(TxOutputsDelta & delta) = 0;
+
   public slots:
 
     virtual void init() = 0;
@@ -157,14 +202,7 @@ class SimulatorInterface : public QObject
     void heartbeat(qint32 loops, qint64 timestamp);
     void runtimeError(const QString & error);
     void lcdChange(bool backlightEnable);
-    void phaseChanged(qint8 phase, const QString & name);
-    void channelOutValueChange(quint8 index, qint32 value, qint32 limit);
-    void channelMixValueChange(quint8 index, qint32 value, qint32 limit);
-    void virtualSwValueChange(quint8 index, qint32 value);
-    void trimValueChange(quint8 index, qint32 value);
-    void trimRangeChange(quint8 index, qint32 min, qint16 max);
-    void gVarValueChange(quint8 index, qint32 value);
-    void outputValueChange(int type, quint8 index, qint32 value);
+    void outputsChanged();  // at most one pending at a time, fetch the values with getOutputsDelta()
 };
 
 class SimulatorFactory {
@@ -137,6 +137,7 @@ SimulatorMainWindow::SimulatorMainWindow(QWidget *parent, const QString & firmwa
   connect(ui->actionReloadRadioData, &QAction::triggered, this, &SimulatorMainWindow::simulatorRestart);
 
   connect(ui->actionReloadLua, &QAction::triggered, m_simulator, &SimulatorInterface::setLuaStateReloadPermanentScripts);
+  connect(m_simulator, &SimulatorInterface::outputsChanged, this, &SimulatorMainWindow::onSimulatorOutputsChanged);
 
   if (m_outputsWidget) {
     connect(this, &SimulatorMainWindow::simulatorStart, m_outputsWidget, &RadioOutputsWidget::start);
@@ -510,3 +511,16 @@ void SimulatorMainWindow::showHelp(bool show)
   msgBox->setModal(false);
   msgBox->show();
 }
+
+void SimulatorMainWindow::onSimulatorOutputsChanged()
+{
+  // fetch the latest outputs once and hand them to all the widgets which display them
+  SimulatorInterface::TxOutputsDelta delta;
+  if (!m_simulator->getOutputsDelta(delta))
+    return;
+
+  if (m_simulatorWidget)
+    m_simulatorWidget->updateOutputs(delta);
+  if (m_outputsWidget)
+    m_outputsWidget->updateOutputs(delta);
+}
@@ -81,6 +81,7 @@ class SimulatorMainWindow : public QMainWindow
     void toggleRadioDocked(bool dock);
     void openJoystickDialog(bool);
     void showHelp(bool show);
+    void onSimulatorOutputsChanged();
 
   protected:
     void createDockWidgets();
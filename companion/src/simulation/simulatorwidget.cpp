@@ -118,10 +118,10 @@ SimulatorWidget::SimulatorWidget(QWidget * parent, SimulatorInterface * simulato
   connect(vJoyRight, &VirtualJoystickWidget::valueChange, this, &SimulatorWidget::onRadioWidgetValueChange);
   connect(this, &SimulatorWidget::stickModeChange, vJoyLeft, &VirtualJoystickWidget::loadDefaultsForMode);
   connect(this, &SimulatorWidget::stickModeChange, vJoyRight, &VirtualJoystickWidget::loadDefaultsForMode);
-  connect(simulator, &SimulatorInterface::trimValueChange, vJoyLeft, &VirtualJoystickWidget::setTrimValue);
-  connect(simulator, &SimulatorInterface::trimValueChange, vJoyRight, &VirtualJoystickWidget::setTrimValue);
-  connect(simulator, &SimulatorInterface::trimRangeChange, vJoyLeft, &VirtualJoystickWidget::setTrimRange);
-  connect(simulator, &SimulatorInterface::trimRangeChange, vJoyRight, &VirtualJoystickWidget::setTrimRange);
+  connect(this, &SimulatorWidget::trimValueChange, vJoyLeft, &VirtualJoystickWidget::setTrimValue);
+  connect(this, &SimulatorWidget::trimValueChange, vJoyRight, &VirtualJoystickWidget::setTrimValue);
+  connect(this, &SimulatorWidget::trimRangeChange, vJoyLeft, &VirtualJoystickWidget::setTrimRange);
+  connect(this, &SimulatorWidget::trimRangeChange, vJoyRight, &VirtualJoystickWidget::setTrimRange);
 
   connect(this, &SimulatorWidget::simulatorInit, simulator, &SimulatorInterface::init);
   connect(this, &SimulatorWidget::simulatorStart, simulator, &SimulatorInterface::start);
@@ -133,7 +133,6 @@ SimulatorWidget::SimulatorWidget(QWidget * parent, SimulatorInterface * simulato
   connect(simulator, &SimulatorInterface::started, this, &SimulatorWidget::onSimulatorStarted);
   connect(simulator, &SimulatorInterface::heartbeat, this, &SimulatorWidget::onSimulatorHeartbeat);
   connect(simulator, &SimulatorInterface::runtimeError, this, &SimulatorWidget::onSimulatorError);
-  connect(simulator, &SimulatorInterface::phaseChanged, this, &SimulatorWidget::onPhaseChanged);
 
   m_timer.setInterval(SIMULATOR_INTERFACE_HEARTBEAT_PERIOD * 6);
   connect(&m_timer, &QTimer::timeout, this, &SimulatorWidget::onTimerEvent);
@@ -616,8 +615,8 @@ void SimulatorWidget::setupRadioWidgets()
       c = 0;
     ui->VCGridLayout->addWidget(tw, 0, c++, 1, 1);
 
-    connect(simulator, &SimulatorInterface::trimValueChange, tw, &RadioTrimWidget::setTrimValue);
-    connect(simulator, &SimulatorInterface::trimRangeChange, tw, &RadioTrimWidget::setTrimRangeQual);
+    connect(this, &SimulatorWidget::trimValueChange, tw, &RadioTrimWidget::setTrimValue);
+    connect(this, &SimulatorWidget::trimRangeChange, tw, &RadioTrimWidget::setTrimRangeQual);
     m_radioWidgets.append(tw);
   }
 
@@ -759,6 +758,26 @@ void SimulatorWidget::onPhaseChanged(qint32 phase, const QString & name)
   setWindowTitle(windowName + tr(" - Flight Mode %1 (#%2)").arg(name).arg(phase));
 }
 
+void SimulatorWidget::updateOutputs(const SimulatorInterface::TxOutputsDelta & delta)
+{
+  const SimulatorInterface::TxOutputs & outputs = delta.values;
+
+  for (int i=0; i < CPN_MAX_TRIMS; i++) {
+    if (delta.changed.trims & ((quint32)1 << i))
+      emit trimValueChange(i, outputs.trims[i]);
+  }
+
+  if (delta.changed.trimRange)
+    emit trimRangeChange(Board::TRIM_AXIS_COUNT, -outputs.trimRange, outputs.trimRange);
+
+  if (delta.changed.phase) {
+    QString name(delta.phaseName);
+    if (name.isEmpty())
+      name = QString::number(outputs.phase);
+    onPhaseChanged(outputs.phase, name);
+  }
+}
+
 void SimulatorWidget::onRadioWidgetValueChange(const RadioWidget::RadioWidgetType type, const int index, int value)
 {
   //qDebug() << type << index << value;
@@ -75,6 +75,7 @@ class SimulatorWidget : public QWidget
     void setUiAreaStyle(const QString & style);
     void captureScreenshot(bool);
     void setupJoysticks();
+    void updateOutputs(const SimulatorInterface::TxOutputsDelta & delta);
 
     QString getSdPath()   const { return sdCardPath; }
     QString getDataPath() const { return radioDataPath; }
@@ -98,6 +99,8 @@ class SimulatorWidget : public QWidget
     void simulatorStop();
     void simulatorSdPathChange(const QString & sdPath, const QString & dataPath);
     void simulatorVolumeGainChange(const int gain);
+    void trimValueChange(int index, int value);
+    void trimRangeChange(int index, int min, int max);
 
   private slots:
     virtual void mousePressEvent(QMouseEvent *event);
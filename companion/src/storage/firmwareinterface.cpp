@@ -25,6 +25,7 @@
 #include "storage.h"
 
 #include <QFile>
+#include <QVector>
 
 #define FW_MARK     "FW"
 #define VERS_MARK   "VERS"
@@ -47,18 +48,19 @@ FirmwareInterface::FirmwareInterface(const QString & filename):
 {
   if (!filename.isEmpty()) {
     QFile file(filename);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
-      QTextStream inputStream(&file);
-      flashSize = HexInterface(inputStream).load((uint8_t *)flash.data(), FSIZE_MAX);
-      file.close();
+    if (file.open(QIODevice::ReadOnly)) {
+      // try HEX first, then raw binary
+      flashSize = HexInterface::load(file, (uint8_t *)flash.data(), FSIZE_MAX);
       if (flashSize == 0) {
-        file.open(QIODevice::ReadOnly);
+        file.seek(0);
         flashSize = file.read((char *)flash.data(), FSIZE_MAX);
       }
+      file.close();
     }
   }
 
   if (flashSize > 0) {
+    scanMarkers();
     flavour = seekLabel(FW_MARK);
     version = seekLabel(VERS_MARK);
     if (version.startsWith("opentx-")) {
@@ -81,44 +83,32 @@ FirmwareInterface::FirmwareInterface(const QString & filename):
     }
 
     versionId = version2index(version);
-    seekSplash();
     isValidFlag = !version.isEmpty();
   }
 }
 
-QString FirmwareInterface::seekString(const QString & string)
+QString FirmwareInterface::readString(int start)
 {
   QString result = "";
 
-  int start = flash.indexOf(string);
-  if (start > 0) {
-    start += string.length();
-    int end = -1;
-    for (int i=start; i<start+50; i++) {
-      char c = flash.at(i);
-      if (c == '\0' || c == '\036') {
-        end = i;
-        break;
-      }
-    }
-    if (end > 0) {
-      result = flash.mid(start, (end - start)).trimmed();
+  int end = -1;
+  for (int i=start; i<start+50 && i<flash.size(); i++) {
+    char c = flash.at(i);
+    if (c == '\0' || c == '\036') {
+      end = i;
+      break;
     }
   }
+  if (end > 0) {
+    result = flash.mid(start, (end - start)).trimmed();
+  }
 
   return result;
 }
 
 QString FirmwareInterface::seekLabel(const QString & label)
 {
-  QString result = seekString(label + "\037\033:");
-  if (result.isEmpty()) {
-    result = seekString(label + "\037\075:"); // This is for Horus
-  }
-  if (!result.isEmpty()) {
-    return result;
-  }
-  return seekString(label + ":");
+  return labels.value(label, -1) > 0 ? readString(labels.value(label)) : QString("");
 }
 
 QString FirmwareInterface::getFlavour() const
@@ -148,94 +138,145 @@ bool FirmwareInterface::isHardwareCompatible(const FirmwareInterface &previousFi
   return (newFlavour == previousFlavour);
 }
 
-bool FirmwareInterface::seekSplash(QByteArray splash)
-{
-  int start = flash.indexOf(splash);
-  if (start>0) {
-    splashOffset = start;
-    splashSize = splash.size();
-    return true;
-  }
-  else {
-    return false;
-  }
-}
-
-bool FirmwareInterface::seekSplash(QByteArray sps, QByteArray spe, int size)
-{
-  int start = 0;
-  while (start>=0) {
-    start = flash.indexOf(sps, start+1);
-    if (start>0) {
-      int end = start + sps.size() + size;
-      if (end == flash.indexOf(spe, end)) {
-        splashOffset = start + sps.size();
-        splashSize = end - start - sps.size();
-        return true;
-      }
-      else {
-        qDebug() << flash.indexOf(spe, start) << end << sps.size() << spe;
-      }
-    }
-  }
-  return false;
-}
-
 #define OTX_SPS_9X      "SPS\0\200\100"
 #define OTX_SPS_TARANIS "SPS\0\324\100"
 #define OTX_SPS_SIZE    6
 #define OTX_SPE         "SPE"
 #define OTX_SPE_SIZE    4
 
-void FirmwareInterface::seekSplash()
+/*
+ * Finds the first occurrence of a set of patterns in a single pass over the flash image.
+ * A pattern may require an end marker exactly <size> bytes after it (splash start/end markers).
+ */
+class FlashScanner
 {
-  splashSize = 0;
-  splashOffset = 0;
-  splashWidth = SPLASH_WIDTH;
-  splashHeight = SPLASH_HEIGHT;
-  splash_format = QImage::Format_Mono;
+  public:
+    explicit FlashScanner(const QByteArray & data):
+      data(data)
+    {
+    }
 
-  if (seekSplash(QByteArray((const char *)gr9x_splash, sizeof(gr9x_splash))) || seekSplash(QByteArray((const char *)gr9xv4_splash, sizeof(gr9xv4_splash)))) {
-    return;
-  }
+    int addPattern(const QByteArray & pattern, const QByteArray & endMarker = QByteArray(), int size = 0)
+    {
+      Pattern p = { pattern, endMarker, size, -1 };
+      patterns.append(p);
+      return patterns.size() - 1;
+    }
 
-  if (seekSplash(QByteArray((const char *)er9x_splash, sizeof(er9x_splash)))) {
-    return;
-  }
+    void scan()
+    {
+      // patterns are indexed by their first byte
+      QVector<int> buckets[256];
+      for (int i=0; i < patterns.size(); i++)
+        buckets[(uint8_t)patterns[i].pattern.at(0)].append(i);
+
+      const char * base = data.constData();
+      int size = data.size();
+      int remaining = patterns.size();
+
+      // a match at offset 0 is never valid (same as the old indexOf() based lookups)
+      for (int pos=1; pos < size && remaining; pos++) {
+        QVector<int> & bucket = buckets[(uint8_t)base[pos]];
+        for (int j=0; j < bucket.size(); j++) {
+          Pattern & p = patterns[bucket[j]];
+          if (p.position >= 0 || pos + p.pattern.size() > size || memcmp(base + pos, p.pattern.constData(), p.pattern.size()))
+            continue;
+          if (!p.endMarker.isEmpty()) {
+            int end = pos + p.pattern.size() + p.size;
+            if (end + p.endMarker.size() > size || memcmp(base + end, p.endMarker.constData(), p.endMarker.size()))
+              continue;
+          }
+          p.position = pos;
+          remaining--;
+        }
+      }
+    }
 
-  if (seekSplash(QByteArray((const char *)opentx_splash, sizeof(opentx_splash)))) {
-    return;
-  }
+    int position(int id) const
+    {
+      return patterns[id].position;
+    }
 
-  if (seekSplash(QByteArray((const char *)opentxtaranis_splash, sizeof(opentxtaranis_splash)))) {
-    splashWidth = SPLASHX9D_WIDTH;
-    splashHeight = SPLASHX9D_HEIGHT;
-    splash_format = QImage::Format_Indexed8;
-    return;
-  }
+  protected:
+    struct Pattern {
+      QByteArray pattern;
+      QByteArray endMarker;
+      int size;
+      int position;
+    };
 
-  if (seekSplash(QByteArray((const char *)ersky9x_splash, sizeof(ersky9x_splash)))) {
-    return;
-  }
+    const QByteArray & data;
+    QVector<Pattern> patterns;
+};
 
-  if (seekSplash(QByteArray(OTX_SPS_9X, OTX_SPS_SIZE), QByteArray(OTX_SPE, OTX_SPE_SIZE), 1024)) {
-    return;
+void FirmwareInterface::scanMarkers()
+{
+  static const char * const labelNames[] = { FW_MARK, VERS_MARK, DATE_MARK, TIME_MARK, EEPR_MARK };
+  // in order of preference, the second one is for Horus
+  static const char * const labelSuffixes[] = { "\037\033:", "\037\075:", ":" };
+  const int labelsCount = sizeof(labelNames) / sizeof(labelNames[0]);
+  const int suffixesCount = sizeof(labelSuffixes) / sizeof(labelSuffixes[0]);
+
+  struct SplashPattern {
+    int id;
+    int offset;       // value added to the position of the match
+    uint size;        // 0 for the size of the pattern (or the distance to the end marker)
+    bool x9d;
+  };
+
+  FlashScanner scanner(flash);
+  int labelIds[labelsCount][suffixesCount];
+  for (int i=0; i < labelsCount; i++) {
+    for (int j=0; j < suffixesCount; j++)
+      labelIds[i][j] = scanner.addPattern(QByteArray(labelNames[i]) + labelSuffixes[j]);
   }
 
-  if (seekSplash(QByteArray(OTX_SPS_TARANIS, OTX_SPS_SIZE), QByteArray(OTX_SPE, OTX_SPE_SIZE), 6784)) {
-    splashWidth = SPLASHX9D_WIDTH;
-    splashHeight = SPLASHX9D_HEIGHT;
-    splash_format = QImage::Format_Indexed8;
-    return;
+  // in order of preference
+  const SplashPattern splashPatterns[] = {
+    { scanner.addPattern(QByteArray((const char *)gr9x_splash, sizeof(gr9x_splash))), 0, sizeof(gr9x_splash), false },
+    { scanner.addPattern(QByteArray((const char *)gr9xv4_splash, sizeof(gr9xv4_splash))), 0, sizeof(gr9xv4_splash), false },
+    { scanner.addPattern(QByteArray((const char *)er9x_splash, sizeof(er9x_splash))), 0, sizeof(er9x_splash), false },
+    { scanner.addPattern(QByteArray((const char *)opentx_splash, sizeof(opentx_splash))), 0, sizeof(opentx_splash), false },
+    { scanner.addPattern(QByteArray((const char *)opentxtaranis_splash, sizeof(opentxtaranis_splash))), 0, sizeof(opentxtaranis_splash), true },
+    { scanner.addPattern(QByteArray((const char *)ersky9x_splash, sizeof(ersky9x_splash))), 0, sizeof(ersky9x_splash), false },
+    { scanner.addPattern(QByteArray(OTX_SPS_9X, OTX_SPS_SIZE), QByteArray(OTX_SPE, OTX_SPE_SIZE), 1024), OTX_SPS_SIZE, 1024, false },
+    { scanner.addPattern(QByteArray(OTX_SPS_TARANIS, OTX_SPS_SIZE), QByteArray(OTX_SPE, OTX_SPE_SIZE), 6784), OTX_SPS_SIZE, 6784, true },
+    { scanner.addPattern(QByteArray(ERSKY9X_SPS, sizeof(ERSKY9X_SPS)), QByteArray(ERSKY9X_SPE, sizeof(ERSKY9X_SPE)), 1030), sizeof(ERSKY9X_SPS), 1030, false },
+    { scanner.addPattern(QByteArray(ERSPLASH_MARKER, sizeof(ERSPLASH_MARKER))), sizeof(ERSPLASH_MARKER), sizeof(er9x_splash), false },
+  };
+
+  scanner.scan();
+
+  labels.clear();
+  for (int i=0; i < labelsCount; i++) {
+    for (int j=0; j < suffixesCount; j++) {
+      int pos = scanner.position(labelIds[i][j]);
+      if (pos > 0 && !readString(pos + strlen(labelNames[i]) + strlen(labelSuffixes[j])).isEmpty()) {
+        labels.insert(labelNames[i], pos + strlen(labelNames[i]) + strlen(labelSuffixes[j]));
+        break;
+      }
+    }
   }
 
-  if (seekSplash(QByteArray(ERSKY9X_SPS, sizeof(ERSKY9X_SPS)), QByteArray(ERSKY9X_SPE, sizeof(ERSKY9X_SPE)), 1030)) {
-    return;
-  }
+  splashSize = 0;
+  splashOffset = 0;
+  splashWidth = SPLASH_WIDTH;
+  splashHeight = SPLASH_HEIGHT;
+  splash_format = QImage::Format_Mono;
 
-  if (seekSplash(QByteArray(ERSPLASH_MARKER, sizeof(ERSPLASH_MARKER)))) {
-    splashOffset += sizeof(ERSPLASH_MARKER);
-    splashSize = sizeof(er9x_splash);
+  for (unsigned i=0; i < sizeof(splashPatterns) / sizeof(splashPatterns[0]); i++) {
+    const SplashPattern & sp = splashPatterns[i];
+    int pos = scanner.position(sp.id);
+    if (pos > 0) {
+      splashOffset = pos + sp.offset;
+      splashSize = sp.size;
+      if (sp.x9d) {
+        splashWidth = SPLASHX9D_WIDTH;
+        splashHeight = SPLASHX9D_HEIGHT;
+        splash_format = QImage::Format_Indexed8;
+      }
+      break;
+    }
   }
 }
 
@@ -24,6 +24,7 @@
 #include <QString>
 #include <QImage>
 #include <QByteArray>
+#include <QMap>
 
 #define SPLASH_WIDTH (128)
 #define SPLASH_HEIGHT (64)
@@ -62,11 +63,9 @@ class FirmwareInterface
   private:
     QByteArray flash;
     uint flashSize;
-    QString seekString(const QString & string);
+    QString readString(int start);
     QString seekLabel(const QString & label);
-    void seekSplash();
-    bool seekSplash(QByteArray sps, QByteArray spe, int size);
-    bool seekSplash(QByteArray splash);
+    void scanMarkers();
     QString filename;
     QString date;
     QString time;
@@ -76,6 +75,7 @@ class FirmwareInterface
     QString eepromId;
     int eepromVersion;
     int eepromVariant;
+    QMap<QString, int> labels;  // label -> offset of its value
     QByteArray splash;
     uint splashOffset;
     uint splashSize;
@@ -20,70 +20,124 @@
 
 #include "hexinterface.h"
 
+#include <QFile>
+
 HexInterface::HexInterface(QTextStream &stream):
   stream(stream)
 {
 }
 
-int HexInterface::getValueFromLine(const QString &line, int pos, int len)
+// hex digit value for each character, -1 for anything else
+static const int8_t hexDigits[256] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+   0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+// returns the byte value of the 2 hex digits at p, or -1
+static inline int hexByte(const uint8_t * p)
 {
-    bool ok;
-    int hex = line.mid(pos,len).toInt(&ok, 16);
-    return ok ? hex : -1;
+  int hi = hexDigits[p[0]];
+  int lo = hexDigits[p[1]];
+  return (hi < 0 || lo < 0) ? -1 : (hi << 4) | lo;
 }
 
 int HexInterface::load(uint8_t *data, int maxsize)
 {
+  QByteArray input = stream.readAll().toLatin1();
+  return parse(input.constData(), input.size(), data, maxsize);
+}
+
+int HexInterface::load(QFile & file, uint8_t * output, int maxsize)
+{
+  qint64 size = file.size();
+  uchar * map = size > 0 ? file.map(0, size) : NULL;
+  if (map) {
+    int result = parse((const char *)map, size, output, maxsize);
+    file.unmap(map);
+    return result;
+  }
+
+  QByteArray input = file.readAll();
+  return parse(input.constData(), input.size(), output, maxsize);
+}
+
+int HexInterface::parse(const char * input, qint64 inputSize, uint8_t * data, int maxsize)
+{
+  const uint8_t * p = (const uint8_t *)input;
+  const uint8_t * end = p + inputSize;
   int result = 0;
   int offset = 0;
-  while (!stream.atEnd()) {
-    QString line = stream.readLine();
-
-    if(line.left(1)!=":") continue;
-    
-    int byteCount = getValueFromLine(line,1);
-    int address = getValueFromLine(line,3,4);
-    int recType = getValueFromLine(line,7);
-    if (recType==0x02) {
-        offset+=0x010000;
+
+  while (p < end) {
+    const uint8_t * eol = (const uint8_t *)memchr(p, '\n', end - p);
+    if (!eol)
+      eol = end;
+
+    if (*p != ':') {
+      p = eol + 1;
+      continue;
     }
-    if(byteCount<0 || address<0 || recType<0)
+
+    // ':' + byte count + address + record type + checksum
+    const uint8_t * field = p + 1;
+    if (eol - field < 10)
+      return 0;
+
+    int byteCount = hexByte(field);
+    int addrHi = hexByte(field + 2);
+    int addrLo = hexByte(field + 4);
+    int recType = hexByte(field + 6);
+    if (byteCount < 0 || addrHi < 0 || addrLo < 0 || recType < 0)
+      return 0;
+    if (eol - field < 10 + byteCount * 2)
       return 0;
 
-    QByteArray ba;
-    ba.clear();
-
-    quint8 chkSum = 0;
-    chkSum -= byteCount;
-    chkSum -= recType;
-    chkSum -= address & 0xFF;
-    chkSum -= address >> 8;
-    for(int i=0; i<byteCount; i++)
-    {
-        quint8 v = getValueFromLine(line,(i*2)+9) & 0xFF;
-        chkSum -= v;
-        ba.append(v);
+    int address = (addrHi << 8) | addrLo;
+    if (recType == 0x02) {
+      offset += 0x010000;
     }
 
-    quint8 retV = getValueFromLine(line,(byteCount*2)+9) & 0xFF;
-    if(chkSum!=retV)
+    if (address + offset + byteCount > maxsize)
       return 0;
 
-    if (address+offset + byteCount <= maxsize) {
-      if (recType == 0x00) { //data record - ba holds record
-        memcpy(&data[address+offset],ba.data(),byteCount);
-        result = std::max(result, address+offset+byteCount);
-      }
+    uint8_t chkSum = -(byteCount + recType + addrHi + addrLo);
+    uint8_t * dest = &data[address + offset];
+    field += 8;
+    for (int i=0; i < byteCount; i++, field += 2) {
+      int v = hexByte(field);
+      if (v < 0)
+        return 0;
+      chkSum -= v;
+      if (recType == 0x00) // data record
+        dest[i] = v;
     }
-    else {
+
+    if (hexByte(field) != chkSum)
       return 0;
-    }
+
+    if (recType == 0x00)
+      result = std::max(result, address + offset + byteCount);
+
+    p = eol + 1;
   }
-  
+
   return result;
 }
 
-
 bool HexInterface::save(const uint8_t * data, const int size)
 {
   int addr = 0;
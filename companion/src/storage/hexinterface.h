@@ -24,6 +24,8 @@
 #include <inttypes.h>
 #include <QTextStream>
 
+class QFile;
+
 class HexInterface {
   public:
     HexInterface(QTextStream &stream);
@@ -31,9 +33,13 @@ class HexInterface {
     int load(uint8_t * output, int maxsize);
     bool save(const uint8_t * data, const int size);
 
+    // Byte level parser, returns the size of the decoded image or 0 on error
+    static int parse(const char * input, qint64 inputSize, uint8_t * output, int maxsize);
+    // Parses an already opened file, memory-mapped when possible
+    static int load(QFile & file, uint8_t * output, int maxsize);
+
   protected:
 
-    int getValueFromLine(const QString &line, int pos, int len=2);
     QString iHEXLine(const quint8 * data, quint32 addr, quint8 len);
     QString iHEXExtRec(quint8 bank);
 
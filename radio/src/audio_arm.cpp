@@ -860,6 +860,11 @@ bool AudioQueue::isPlaying(uint8_t id)
 
 void AudioQueue::playTone(uint16_t freq, uint16_t len, uint16_t pause, uint8_t flags, int8_t freqIncr)
 {
+#if defined(SIMU)
+  if (simuAudioHook)
+    simuAudioHook(freq, NULL);
+#endif
+
 #if defined(SIMU) && !defined(SIMU_AUDIO)
   return;
 #endif
@@ -895,6 +900,8 @@ void AudioQueue::playFile(const char * filename, uint8_t flags, uint8_t id)
 {
 #if defined(SIMU)
   TRACE("playFile(\"%s\", flags=%x, id=%d)", filename, flags, id);
+  if (simuAudioHook)
+    simuAudioHook(0, filename);
   if (strlen(filename) > AUDIO_FILENAME_MAXLEN) {
     TRACE("file name too long! maximum length is %d characters", AUDIO_FILENAME_MAXLEN);
     return;
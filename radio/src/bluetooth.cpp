@@ -114,12 +114,15 @@ void bluetoothProcessTrainerFrame(const uint8_t * bluetoothBuffer)
 {
   TRACE("");
 
+  int16_t * channels = trainerBeginSnapshot();
+
   for (uint8_t channel=0, i=1; channel<8; channel+=2, i+=3) {
     // +-500 != 512, but close enough.
-    ppmInput[channel] = bluetoothBuffer[i] + ((bluetoothBuffer[i+1] & 0xf0) << 4) - 1500;
-    ppmInput[channel+1] = ((bluetoothBuffer[i+1] & 0x0f) << 4) + ((bluetoothBuffer[i+2] & 0xf0) >> 4) + ((bluetoothBuffer[i+2] & 0x0f) << 8) - 1500;
+    channels[channel] = bluetoothBuffer[i] + ((bluetoothBuffer[i+1] & 0xf0) << 4) - 1500;
+    channels[channel+1] = ((bluetoothBuffer[i+1] & 0x0f) << 4) + ((bluetoothBuffer[i+2] & 0xf0) >> 4) + ((bluetoothBuffer[i+2] & 0x0f) << 8) - 1500;
   }
 
+  trainerPublishSnapshot(TRAINER_INPUT_BLUETOOTH, 8);
   ppmInputValidityTimer = PPM_IN_VALID_TIMEOUT;
 }
 
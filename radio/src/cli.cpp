@@ -20,6 +20,7 @@
 
 #include "opentx.h"
 #include "diskio.h"
+#include "cli_stream.h"
 #include <ctype.h>
 #include <malloc.h>
 #include <new>
@@ -151,7 +152,7 @@ int cliRead(const char ** argv)
 
   while (true) {
     UINT read;
-    result = f_read(&file, buffer, sizeof(buffer), &read);
+    result = f_read(&file, buffer, bufferSize, &read);
     if (result == FR_OK) {
       if (read == 0) {
         // end of file
@@ -410,6 +411,11 @@ void testDrawText()
   lcdDrawText(0, LCD_H/2, "The quick brown fox jumps over the lazy dog", TEXT_COLOR);
 }
 
+void testDrawTextNumbers()
+{
+  lcdDrawText(0, LCD_H/2, "-123.45 678.90", TEXT_COLOR|DBLSIZE);
+}
+
 void testDrawTextVertical()
 {
   lcdDrawText(30, LCD_H, "The quick brown fox ", TEXT_COLOR|VERTICAL);
@@ -466,6 +472,7 @@ int cliTestGraphics()
   result += RUN_GRAPHICS_TEST(testDrawFilledRectangle, 1000);
   result += RUN_GRAPHICS_TEST(testDrawBlackOverlay, 1000);
   result += RUN_GRAPHICS_TEST(testDrawText, 1000);
+  result += RUN_GRAPHICS_TEST(testDrawTextNumbers, 1000);
   result += RUN_GRAPHICS_TEST(testDrawTextVertical, 1000);
   result += RUN_GRAPHICS_TEST(testClear, 1000);
 
@@ -771,6 +778,11 @@ int cliMemoryInfo(const char ** argv)
   serialPrint("\tExtra   %u", e);
   serialPrint("------------");
   serialPrint("\tTotal   %u", s + w + e);
+  serialPrint("\nLua bitmaps cache:");
+  serialPrint("\tentries   %u", luaBitmapsCacheStats.entries);
+  serialPrint("\thits      %u", luaBitmapsCacheStats.hits);
+  serialPrint("\tmisses    %u", luaBitmapsCacheStats.misses);
+  serialPrint("\tevictions %u", luaBitmapsCacheStats.evictions);
 #endif
 #endif
   return 0;
@@ -1228,6 +1240,7 @@ const CliCommand cliCommands[] = {
   { "help", cliHelp, "[<command>]" },
   { "debugvars", cliDebugVars, "" },
   { "repeat", cliRepeat, "<interval> <command>" },
+  { "stream", cliStream, "file <filename> | sd <start sector> <sectors count> | mem <address> <size> | test <size> | traces on|off | timers" },
 #if defined(JITTER_MEASURE)
   { "jitter", cliShowJitter, "" },
 #endif
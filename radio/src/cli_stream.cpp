@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "opentx.h"
+#include "cli_stream.h"
+#include "crc.h"
+
+// no progress on the serial line during this time aborts a transfer
+#define CLI_STREAM_TIMEOUT_MS          1000
+
+uint8_t cliStreamTracesEnabled = false;
+
+static uint8_t cliStreamSequence = 0;
+#if defined(SIMU)
+static pthread_mutex_t cliStreamFrameMutex = PTHREAD_MUTEX_INITIALIZER;
+#else
+static volatile uint8_t cliStreamFrameBusy = false;
+#endif
+
+// read buffer of the bulk transfers, aligned for the SD card DMA
+static uint8_t __ALIGNED(4) cliStreamBuffer[CLI_FRAME_DATA_SIZE];
+
+// Frames from the CLI task and traces from the other tasks must not interleave
+static bool cliStreamLockFrame()
+{
+#if defined(SIMU)
+  // the traces come from the firmware threads
+  bool result = (pthread_mutex_trylock(&cliStreamFrameMutex) == 0);
+#else
+  uint32_t prim = __get_PRIMASK();
+  __disable_irq();
+  bool result = !cliStreamFrameBusy;
+  cliStreamFrameBusy = true;
+  if (!prim) __enable_irq();
+#endif
+  return result;
+}
+
+static void cliStreamUnlockFrame()
+{
+#if defined(SIMU)
+  pthread_mutex_unlock(&cliStreamFrameMutex);
+#else
+  cliStreamFrameBusy = false;
+#endif
+}
+
+static bool cliStreamWrite(const uint8_t * data, uint32_t length, bool wait)
+{
+  uint32_t idle = 0;
+  // the AUX serial gets everything at once, only the USB serial is retried
+  uint32_t count = serialWrite(data, length);
+  while (count < length) {
+    data += count;
+    length -= count;
+    if (count == 0) {
+      if (!wait || idle >= CLI_STREAM_TIMEOUT_MS)
+        return false;
+      RTOS_WAIT_MS(2);
+      idle += 2;
+    }
+    else {
+      idle = 0;
+    }
+    count = serialWriteUsb(data, length);
+  }
+  return true;
+}
+
+// The payload is given in two parts to avoid copying the data after its header
+static bool cliStreamFrame(uint8_t type, const void * header, uint32_t headerLength, const void * data, uint32_t dataLength, bool wait=true)
+{
+  while (!cliStreamLockFrame()) {
+    if (!wait)
+      return false;
+    RTOS_WAIT_MS(2);
+  }
+
+  uint32_t length = headerLength + dataLength;
+  uint8_t frameHeader[CLI_FRAME_HEADER_SIZE] = { CLI_FRAME_SYNC1, CLI_FRAME_SYNC2, type, cliStreamSequence++, uint8_t(length), uint8_t(length >> 8) };
+  uint16_t crc = crc16(CRC_1021, &frameHeader[2], CLI_FRAME_HEADER_SIZE - 2);
+  crc = crc16(CRC_1021, (const uint8_t *)header, headerLength, crc);
+  crc = crc16(CRC_1021, (const uint8_t *)data, dataLength, crc);
+  uint8_t frameCrc[CLI_FRAME_CRC_SIZE] = { uint8_t(crc), uint8_t(crc >> 8) };
+
+  bool result = cliStreamWrite(frameHeader, CLI_FRAME_HEADER_SIZE, wait) &&
+                cliStreamWrite((const uint8_t *)header, headerLength, wait) &&
+                cliStreamWrite((const uint8_t *)data, dataLength, wait) &&
+                cliStreamWrite(frameCrc, CLI_FRAME_CRC_SIZE, wait);
+
+  cliStreamUnlockFrame();
+  return result;
+}
+
+static void cliStreamPut32(uint8_t * buffer, uint32_t value)
+{
+  buffer[0] = value;
+  buffer[1] = value >> 8;
+  buffer[2] = value >> 16;
+  buffer[3] = value >> 24;
+}
+
+static bool cliStreamData(uint32_t offset, const uint8_t * data, uint32_t length)
+{
+  uint8_t header[4];
+  cliStreamPut32(header, offset);
+  return cliStreamFrame(CLI_FRAME_DATA, header, sizeof(header), data, length);
+}
+
+static int cliStreamEnd(uint8_t status, uint32_t bytes, uint32_t start)
+{
+  uint8_t payload[9];
+  payload[0] = status;
+  cliStreamPut32(&payload[1], bytes);
+  cliStreamPut32(&payload[5], RTOS_GET_MS() - start);
+  cliStreamFrame(CLI_FRAME_END, payload, sizeof(payload), NULL, 0);
+  return status == CLI_STREAM_OK ? 0 : -1;
+}
+
+// Never blocks, a trace which does not fit is dropped
+void cliStreamTrace(const char * text, uint32_t length)
+{
+  if (length > CLI_FRAME_MAX_PAYLOAD)
+    length = CLI_FRAME_MAX_PAYLOAD;
+  cliStreamFrame(CLI_FRAME_TRACE, text, length, NULL, 0, false);
+}
+
+static bool cliStreamArgument(const char ** argv, int index, uint32_t * value)
+{
+  if (!argv[index] || *argv[index] == '\0')
+    return false;
+  char * end;
+  *value = strtoul(argv[index], &end, 0);
+  return *end == '\0';
+}
+
+static int cliStreamFile(const char * filename)
+{
+  uint32_t start = RTOS_GET_MS();
+  FIL file;
+  if (f_open(&file, filename, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+    return cliStreamEnd(CLI_STREAM_READ_ERROR, 0, start);
+
+  uint8_t status = CLI_STREAM_OK;
+  uint32_t offset = 0;
+  while (true) {
+    UINT count;
+    if (f_read(&file, cliStreamBuffer, sizeof(cliStreamBuffer), &count) != FR_OK) {
+      status = CLI_STREAM_READ_ERROR;
+      break;
+    }
+    if (count == 0)
+      break;
+    if (!cliStreamData(offset, cliStreamBuffer, count)) {
+      status = CLI_STREAM_TIMEOUT;
+      break;
+    }
+    offset += count;
+  }
+  f_close(&file);
+  return cliStreamEnd(status, offset, start);
+}
+
+#if !defined(SIMU) || defined(SIMU_DISKIO)
+// One 512 bytes sector per frame
+static int cliStreamSectors(uint32_t sector, uint32_t count)
+{
+  uint32_t start = RTOS_GET_MS();
+  uint32_t offset = 0;
+  for (; count > 0; count--, sector++) {
+    if (__disk_read(0, cliStreamBuffer, sector, 1) != RES_OK)
+      return cliStreamEnd(CLI_STREAM_READ_ERROR, offset, start);
+    if (!cliStreamData(offset, cliStreamBuffer, CLI_FRAME_DATA_SIZE))
+      return cliStreamEnd(CLI_STREAM_TIMEOUT, offset, start);
+    offset += CLI_FRAME_DATA_SIZE;
+  }
+  return cliStreamEnd(CLI_STREAM_OK, offset, start);
+}
+#endif
+
+#if !defined(SIMU)
+// Sent straight from memory, SDRAM included
+static int cliStreamMemory(const uint8_t * address, uint32_t size)
+{
+  uint32_t start = RTOS_GET_MS();
+  for (uint32_t offset = 0; offset < size; offset += CLI_FRAME_DATA_SIZE) {
+    if (!cliStreamData(offset, address + offset, min<uint32_t>(size - offset, CLI_FRAME_DATA_SIZE)))
+      return cliStreamEnd(CLI_STREAM_TIMEOUT, offset, start);
+  }
+  return cliStreamEnd(CLI_STREAM_OK, size, start);
+}
+#endif
+
+// Known pattern to check the link and measure its speed
+static int cliStreamTest(uint32_t size)
+{
+  uint32_t start = RTOS_GET_MS();
+  for (uint32_t offset = 0; offset < size; offset += CLI_FRAME_DATA_SIZE) {
+    uint32_t count = min<uint32_t>(size - offset, CLI_FRAME_DATA_SIZE);
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t position = offset + i;
+      cliStreamBuffer[i] = position ^ (position >> 8);
+    }
+    if (!cliStreamData(offset, cliStreamBuffer, count))
+      return cliStreamEnd(CLI_STREAM_TIMEOUT, offset, start);
+  }
+  return cliStreamEnd(CLI_STREAM_OK, size, start);
+}
+
+#if defined(DEBUG_TIMERS)
+static int cliStreamTimers()
+{
+  uint32_t start = RTOS_GET_MS();
+  uint32_t length = 0;
+  for (int n = 0; n < DEBUG_TIMERS_COUNT; n++) {
+    uint8_t nameLength = min<uint32_t>(strlen(debugTimerNames[n]), 32);
+    if (length + 1 + nameLength + 8 > sizeof(cliStreamBuffer))
+      break;
+    cliStreamBuffer[length++] = nameLength;
+    memcpy(&cliStreamBuffer[length], debugTimerNames[n], nameLength);
+    length += nameLength;
+    cliStreamPut32(&cliStreamBuffer[length], debugTimers[n].getMin());
+    cliStreamPut32(&cliStreamBuffer[length + 4], debugTimers[n].getMax());
+    length += 8;
+    debugTimers[n].reset();
+  }
+  cliStreamFrame(CLI_FRAME_TIMERS, cliStreamBuffer, length, NULL, 0);
+  return cliStreamEnd(CLI_STREAM_OK, length, start);
+}
+#endif
+
+int cliStream(const char ** argv)
+{
+  uint32_t start = RTOS_GET_MS();
+  const char * what = argv[1] ? argv[1] : "";
+
+  if (!strcmp(what, "file")) {
+    if (argv[2] && *argv[2])
+      return cliStreamFile(argv[2]);
+  }
+#if !defined(SIMU) || defined(SIMU_DISKIO)
+  else if (!strcmp(what, "sd")) {
+    uint32_t sector, count;
+    if (cliStreamArgument(argv, 2, &sector) && cliStreamArgument(argv, 3, &count))
+      return cliStreamSectors(sector, count);
+  }
+#endif
+#if !defined(SIMU)
+  else if (!strcmp(what, "mem")) {
+    uint32_t address, size;
+    if (cliStreamArgument(argv, 2, &address) && cliStreamArgument(argv, 3, &size))
+      return cliStreamMemory((const uint8_t *)address, size);
+  }
+#endif
+  else if (!strcmp(what, "test")) {
+    uint32_t size;
+    if (cliStreamArgument(argv, 2, &size))
+      return cliStreamTest(size);
+  }
+  else if (!strcmp(what, "traces")) {
+    if (argv[2] && (!strcmp(argv[2], "on") || !strcmp(argv[2], "off"))) {
+      cliStreamTracesEnabled = !strcmp(argv[2], "on");
+      return cliStreamEnd(CLI_STREAM_OK, 0, start);
+    }
+  }
+#if defined(DEBUG_TIMERS)
+  else if (!strcmp(what, "timers")) {
+    return cliStreamTimers();
+  }
+#endif
+  else {
+    return cliStreamEnd(CLI_STREAM_UNSUPPORTED, 0, start);
+  }
+  return cliStreamEnd(CLI_STREAM_INVALID_ARGUMENT, 0, start);
+}
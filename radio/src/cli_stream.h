@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _CLI_STREAM_H_
+#define _CLI_STREAM_H_
+
+#include <inttypes.h>
+
+// Binary frames of the CLI streaming mode, decoded by tools/cli-stream.py:
+//   A5 5A <type> <seq> <length:16> <payload> <crc:16>
+// Values are little endian, the CRC (CRC_1021) covers the type, sequence,
+// length and payload. Text written between frames is left as is.
+#define CLI_FRAME_SYNC1                0xA5
+#define CLI_FRAME_SYNC2                0x5A
+#define CLI_FRAME_HEADER_SIZE          6
+#define CLI_FRAME_CRC_SIZE             2
+#define CLI_FRAME_DATA_SIZE            512
+#define CLI_FRAME_MAX_PAYLOAD          (4 + CLI_FRAME_DATA_SIZE)
+
+enum CliFrameType {
+  CLI_FRAME_DATA = 1,   // <offset:32> <data>
+  CLI_FRAME_END,        // <status:8> <bytes:32> <duration ms:32>
+  CLI_FRAME_TRACE,      // text
+  CLI_FRAME_TIMERS,     // { <name length:8> <name> <min us:32> <max us:32> } ...
+};
+
+enum CliStreamStatus {
+  CLI_STREAM_OK,
+  CLI_STREAM_INVALID_ARGUMENT,
+  CLI_STREAM_READ_ERROR,
+  CLI_STREAM_TIMEOUT,
+  CLI_STREAM_UNSUPPORTED,
+};
+
+// traces are sent in CLI_FRAME_TRACE frames instead of text
+extern uint8_t cliStreamTracesEnabled;
+
+void cliStreamTrace(const char * text, uint32_t length);
+int cliStream(const char ** argv);
+
+#endif // _CLI_STREAM_H_
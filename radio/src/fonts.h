@@ -36,6 +36,17 @@ extern BitmapBuffer * fontCache[2];
 void loadFontCache();
 #endif
 
+// Glyph spans: for each row a list of opcodes (kind in the 2 MSB, pixels count in the 6 LSB),
+// ALPHA opcodes are followed by the opacity of each pixel, END terminates the row
+#define GLYPH_SPAN_END                 0x00
+#define GLYPH_SPAN_SKIP                0x40
+#define GLYPH_SPAN_SOLID               0x80
+#define GLYPH_SPAN_ALPHA               0xC0
+#define GLYPH_SPAN_KIND(op)            ((op) & 0xC0)
+#define GLYPH_SPAN_COUNT(op)           ((op) & 0x3F)
+#define GLYPH_SPAN_COUNT_MAX           0x3F
+const uint8_t * getFontGlyphSpans(const uint8_t * font, const uint16_t * spec, int index);
+
 #else
 
 extern const pm_uchar font_5x7[];
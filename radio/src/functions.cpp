@@ -51,26 +51,18 @@ PLAY_FUNCTION(playValue, source_t idx)
 
 #if defined(CPUARM)
   if (idx >= MIXSRC_FIRST_TELEM) {
-    TelemetrySensor & telemetrySensor = g_model.telemetrySensors[(idx-MIXSRC_FIRST_TELEM) / 3];
-    uint8_t attr = 0;
-    if (telemetrySensor.prec > 0) {
-      if (telemetrySensor.prec == 2) {
-        if (val >= 5000) {
-          val = div_and_round(val, 100);
-        }
-        else {
-          val = div_and_round(val, 10);
-          attr = PREC1;
-        }
-      }
-      else {
-        if (val >= 500) {
-          val = div_and_round(val, 10);
-        }
-        else {
-          attr = PREC1;
-        }
-      }
+    div_t qr = div(idx-MIXSRC_FIRST_TELEM, 3);
+    TelemetrySensor & telemetrySensor = g_model.telemetrySensors[qr.quot];
+    TelemetryItem & telemetryItem = telemetryItems[qr.quot];
+    uint8_t attr;
+    if (qr.rem == 0 && val == telemetryItem.value) {
+      TelemetryValuePresentation presentation = telemetryItem.getPresentation(telemetrySensor);
+      val = presentation.announcedValue;
+      attr = presentation.attr;
+    }
+    else {
+      // min / max
+      val = getTelemetryAnnouncedValue(val, telemetrySensor.prec, attr);
     }
     PLAY_NUMBER(val, telemetrySensor.unit == UNIT_CELLS ? UNIT_VOLTS : telemetrySensor.unit, attr);
   }
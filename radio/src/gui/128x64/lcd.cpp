@@ -32,6 +32,27 @@ coord_t lcdNextPos;
 #if defined(CPUARM)
 coord_t lcdLastLeftPos;
 
+// Writes a whole column of pixels, bit n of value / mask is the pixel (x, y+n).
+// x must be on screen and y >= -1, the bottom is clipped
+static void lcdPutColumn(coord_t x, coord_t y, uint64_t value, uint64_t mask)
+{
+  if (y < 0) {
+    value >>= 1;
+    mask >>= 1;
+    y = 0;
+  }
+  else {
+    value <<= (y & 7);
+    mask <<= (y & 7);
+  }
+
+  uint8_t * p = &displayBuf[y / 8 * LCD_W + x];
+  for (; mask && p < DISPLAY_END; p += LCD_W, value >>= 8, mask >>= 8) {
+    uint8_t m = mask;
+    *p = (*p & ~m) | (value & m);
+  }
+}
+
 void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
 {
   bool blink = false;
@@ -52,6 +73,17 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
   uint8_t lines = (height+7)/8;
   assert(lines <= 5);
 
+  // rows drawn for each column, bit 0 is the line above the glyph
+  uint64_t rowsMask = ((uint64_t)1 << (height+1)) - 2;
+  uint64_t glyphMask = ((uint64_t)1 << height) - 1;
+  if (height < 12) {
+    if (inv) rowsMask |= 1;
+    rowsMask |= (uint64_t)1 << (height+1);
+    if (FONTSIZE(flags) == SMLSIZE) glyphMask |= (uint64_t)1 << height;
+  }
+  // unclipped columns are written at once, others pixel by pixel
+  bool columns = !blink && !(flags & VERTICAL) && y >= 0;
+
   for (int8_t i=0; i<width+2; i++) {
     if (x<LCD_W) {
       uint8_t b[5] = { 0 };
@@ -89,6 +121,19 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
         }
       }
 
+      if (columns && x >= 0) {
+        uint64_t value = 0;
+        for (int8_t j=lines-1; j>=0; j--) {
+          value = (value << 8) | b[j];
+        }
+        value = (value & glyphMask) << 1;
+        if (inv) value = ~value;
+        lcdPutColumn(x, y-1, value & rowsMask, rowsMask);
+        x++;
+        lcdNextPos++;
+        continue;
+      }
+
       for (int8_t j=-1; j<=height; j++) {
         bool plot;
         if (j < 0 || ((j == height) && !(FONTSIZE(flags) == SMLSIZE))) {
@@ -67,6 +67,31 @@ uint8_t getPatternWidth(const PatternData * pattern)
   return result;
 }
 
+// Writes a whole column of pixels, bit n of value / mask is the pixel (x, y+n).
+// x must be on screen and y >= -1, the bottom is clipped
+static void lcdPutColumn(coord_t x, coord_t y, uint64_t value, uint64_t mask)
+{
+  // two pixels per byte, the even line in the low nibble
+  static const uint8_t nibbles[4] = { 0x00, 0x0F, 0xF0, 0xFF };
+
+  if (y < 0) {
+    value >>= 1;
+    mask >>= 1;
+    y = 0;
+  }
+  else if (y & 1) {
+    value <<= 1;
+    mask <<= 1;
+    y--;
+  }
+
+  uint8_t * p = &displayBuf[y / 2 * LCD_W + x];
+  for (; mask && p < DISPLAY_END; p += LCD_W, value >>= 2, mask >>= 2) {
+    uint8_t m = nibbles[mask & 3];
+    *p = (*p & ~m) | (nibbles[value & 3] & m);
+  }
+}
+
 void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
 {
   bool blink = false;
@@ -87,6 +112,17 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
   uint8_t lines = (height+7)/8;
   assert(lines <= 5);
 
+  // rows drawn for each column, bit 0 is the line above the glyph
+  uint64_t rowsMask = ((uint64_t)1 << (height+1)) - 2;
+  uint64_t glyphMask = ((uint64_t)1 << height) - 1;
+  if (height < 12) {
+    if (inv) rowsMask |= 1;
+    rowsMask |= (uint64_t)1 << (height+1);
+    if (FONTSIZE(flags) == SMLSIZE) glyphMask |= (uint64_t)1 << height;
+  }
+  // unclipped columns are written at once, others pixel by pixel
+  bool columns = !blink && !(flags & VERTICAL) && y >= 0;
+
   for (int8_t i=0; i<(int8_t)(width+2); i++) {
     if (x<LCD_W) {
       uint8_t b[5] = { 0 };
@@ -120,6 +156,19 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
         }
       }
 
+      if (columns && x >= 0) {
+        uint64_t value = 0;
+        for (int8_t j=lines-1; j>=0; j--) {
+          value = (value << 8) | b[j];
+        }
+        value = (value & glyphMask) << 1;
+        if (inv) value = ~value;
+        lcdPutColumn(x, y-1, value & rowsMask, rowsMask);
+        x++;
+        lcdNextPos++;
+        continue;
+      }
+
       for (int8_t j=-1; j<=(int8_t)(height); j++) {
         bool plot;
         if (j < 0 || ((j == height) && !(FONTSIZE(flags) == SMLSIZE))) {
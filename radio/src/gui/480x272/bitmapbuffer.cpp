@@ -527,6 +527,82 @@ uint8_t BitmapBuffer::drawCharWithoutCache(coord_t x, coord_t y, const uint8_t *
   return width;
 }
 
+static void initGlyphColor(GlyphColor & glyphColor, display_t color)
+{
+  RGB_SPLIT(color, red, green, blue);
+  glyphColor.color = color;
+  for (uint8_t opacity=0; opacity<OPACITY_MAX; opacity++) {
+    glyphColor.red[opacity] = red * opacity;
+    glyphColor.green[opacity] = green * opacity;
+    glyphColor.blue[opacity] = blue * opacity;
+  }
+}
+
+// Same result as drawBitmapPattern() for glyphs not clipped horizontally, returns false otherwise
+bool BitmapBuffer::drawGlyphSpans(coord_t x, coord_t y, const uint8_t * spans, coord_t width, coord_t height, const GlyphColor & color)
+{
+  APPLY_OFFSET();
+
+  if (x < xmin || x + width > xmax) {
+    return false;
+  }
+
+  for (coord_t row=0; row<height; row++) {
+    bool visible = (y + row >= ymin && y + row < ymax);
+    display_t * p = visible ? getPixelPtr(x, y + row) : NULL;
+    uint8_t op;
+    while ((op = *spans++) != GLYPH_SPAN_END) {
+      uint8_t count = GLYPH_SPAN_COUNT(op);
+      switch (GLYPH_SPAN_KIND(op)) {
+        case GLYPH_SPAN_SKIP:
+          if (visible)
+            MOVE_PIXEL_RIGHT(p, count);
+          break;
+
+        case GLYPH_SPAN_SOLID:
+          if (visible) {
+            while (count--) {
+              drawPixel(p, color.color);
+              MOVE_TO_NEXT_RIGHT_PIXEL(p);
+            }
+          }
+          break;
+
+        default:
+          if (visible) {
+            for (uint8_t i=0; i<count; i++) {
+              uint8_t opacity = spans[i];
+              uint8_t bgWeight = OPACITY_MAX - opacity;
+              RGB_SPLIT(*p, bgRed, bgGreen, bgBlue);
+              uint16_t r = (bgRed * bgWeight + color.red[opacity]) / OPACITY_MAX;
+              uint16_t g = (bgGreen * bgWeight + color.green[opacity]) / OPACITY_MAX;
+              uint16_t b = (bgBlue * bgWeight + color.blue[opacity]) / OPACITY_MAX;
+              drawPixel(p, RGB_JOIN(r, g, b));
+              MOVE_TO_NEXT_RIGHT_PIXEL(p);
+            }
+          }
+          spans += count;
+          break;
+      }
+    }
+  }
+
+  return true;
+}
+
+uint8_t BitmapBuffer::drawCharWithSpans(coord_t x, coord_t y, const uint8_t * font, const uint16_t * spec, int index, LcdFlags flags, const GlyphColor & color)
+{
+  coord_t offset = spec[index];
+  coord_t width = spec[index+1] - offset;
+  if (width > 0) {
+    const uint8_t * spans = getFontGlyphSpans(font, spec, index);
+    coord_t height = *(((uint16_t *)font)+1);
+    if (!spans || !drawGlyphSpans(x, y, spans, width, height, color))
+      drawBitmapPattern(x, y, font, flags, offset, width);
+  }
+  return width;
+}
+
 uint8_t BitmapBuffer::drawCharWithCache(coord_t x, coord_t y, const BitmapBuffer * font, const uint16_t * spec, int index, LcdFlags flags)
 {
   coord_t offset = spec[index];
@@ -601,6 +677,11 @@ void BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char * s, uint8_t l
     INCREMENT_POS(-width/2);
   }
 
+  GlyphColor glyphColor;
+  if (!fontcache && !(flags & VERTICAL)) {
+    initGlyphColor(glyphColor, lcdColorTable[COLOR_IDX(flags)]);
+  }
+
   coord_t & pos = (flags & VERTICAL) ? y : x;
 
   bool setpos = false;
@@ -625,8 +706,10 @@ void BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char * s, uint8_t l
 #else
       if (fontcache)
         width = drawCharWithCache(x-1, y, fontcache, fontspecs, getMappedChar(c), flags);
-      else
+      else if (flags & VERTICAL)
         width = drawCharWithoutCache(x-1, y, font, fontspecs, getMappedChar(c), flags);
+      else
+        width = drawCharWithSpans(x-1, y, font, fontspecs, getMappedChar(c), flags, glyphColor);
 #endif
       INCREMENT_POS(width);
     }
@@ -59,6 +59,15 @@ struct rect_t {
 
 typedef uint16_t display_t;
 
+// Text colour with its components premultiplied by each opacity level
+struct GlyphColor
+{
+  display_t color;
+  uint16_t red[OPACITY_MAX];
+  uint16_t green[OPACITY_MAX];
+  uint16_t blue[OPACITY_MAX];
+};
+
 enum BitmapFormats
 {
   BMP_RGB565,
@@ -314,6 +323,10 @@ class BitmapBuffer: public BitmapBufferBase<uint16_t>
 
     uint8_t drawCharWithCache(coord_t x, coord_t y, const BitmapBuffer * font, const uint16_t * spec, int index, LcdFlags flags);
 
+    uint8_t drawCharWithSpans(coord_t x, coord_t y, const uint8_t * font, const uint16_t * spec, int index, LcdFlags flags, const GlyphColor & color);
+
+    bool drawGlyphSpans(coord_t x, coord_t y, const uint8_t * spans, coord_t width, coord_t height, const GlyphColor & color);
+
     uint8_t drawChar(coord_t x, coord_t y, const uint8_t * font, const uint16_t * spec, int index, LcdFlags flags);
 
     void drawSizedText(coord_t x, coord_t y, const char * s, uint8_t len, LcdFlags flags=0);
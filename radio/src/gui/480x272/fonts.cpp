@@ -118,3 +118,132 @@ void loadFontCache()
   fontCache[0] = createFontCache(fontsTable[0], TEXT_COLOR, TEXT_BGCOLOR);
   fontCache[1] = createFontCache(fontsTable[0], TEXT_INVERTED_COLOR, TITLE_BGCOLOR);
 }
+
+// Glyph spans are built on first use of each glyph and kept for the lifetime of the firmware,
+// the font patterns are in flash and never change (the colour is applied when drawing)
+
+#define FONT_GLYPH_SPANS_COUNT         8
+#define FONT_GLYPHS_MAX                1024
+
+struct FontGlyphSpans
+{
+  const uint8_t * font;
+  uint16_t count;
+  uint8_t ** glyphs;
+};
+
+static FontGlyphSpans fontGlyphSpans[FONT_GLYPH_SPANS_COUNT];
+
+static FontGlyphSpans * getFontGlyphSpansTable(const uint8_t * font, const uint16_t * spec)
+{
+  for (int i=0; i<FONT_GLYPH_SPANS_COUNT; i++) {
+    FontGlyphSpans * table = &fontGlyphSpans[i];
+    if (table->font == font) {
+      return table;
+    }
+    if (!table->font) {
+      coord_t width = *((uint16_t *)font);
+      uint16_t count = 0;
+      while (count < FONT_GLYPHS_MAX && spec[count] < width) {
+        count++;
+      }
+      table->font = font;
+      if (spec[count] == width) {
+        table->glyphs = new uint8_t *[count];
+        if (table->glyphs) {
+          memset(table->glyphs, 0, count * sizeof(uint8_t *));
+          table->count = count;
+        }
+      }
+      return table;
+    }
+  }
+  return NULL;
+}
+
+static inline uint8_t * writeGlyphSpan(uint8_t * out, uint8_t kind, uint8_t count)
+{
+  if (out)
+    *out = kind + count;
+  return out ? out + 1 : NULL;
+}
+
+// Encodes one row of a glyph, returns the number of bytes (with out == NULL it only counts them)
+static int encodeGlyphRow(uint8_t * out, const uint8_t * q, coord_t width)
+{
+  int size = 0;
+  coord_t col = 0;
+
+  while (col < width) {
+    uint8_t opacity = q[col];
+    uint8_t kind = (opacity == 0 ? GLYPH_SPAN_SKIP : (opacity == OPACITY_MAX ? GLYPH_SPAN_SOLID : GLYPH_SPAN_ALPHA));
+    coord_t end = col + 1;
+    while (end < width && end - col < GLYPH_SPAN_COUNT_MAX) {
+      uint8_t next = q[end];
+      if (kind == GLYPH_SPAN_SKIP ? next != 0 : (kind == GLYPH_SPAN_SOLID ? next != OPACITY_MAX : (next == 0 || next == OPACITY_MAX)))
+        break;
+      end++;
+    }
+    if (kind == GLYPH_SPAN_SKIP && end == width) {
+      // trailing transparent pixels don't need a span
+      break;
+    }
+    out = writeGlyphSpan(out, kind, end - col);
+    size++;
+    if (kind == GLYPH_SPAN_ALPHA) {
+      if (out) {
+        memcpy(out, &q[col], end - col);
+        out += end - col;
+      }
+      size += end - col;
+    }
+    col = end;
+  }
+
+  writeGlyphSpan(out, GLYPH_SPAN_END, 0);
+  return size + 1;
+}
+
+const uint8_t * getFontGlyphSpans(const uint8_t * font, const uint16_t * spec, int index)
+{
+  FontGlyphSpans * table = getFontGlyphSpansTable(font, spec);
+  if (!table || index < 0 || index >= table->count) {
+    return NULL;
+  }
+
+  uint8_t * spans = table->glyphs[index];
+  if (!spans) {
+    coord_t w = *((uint16_t *)font);
+    coord_t height = *(((uint16_t *)font)+1);
+    coord_t offset = spec[index];
+    coord_t width = spec[index+1] - offset;
+
+    for (coord_t row=0; row<height; row++) {
+      const uint8_t * q = font + 4 + row*w + offset;
+      for (coord_t col=0; col<width; col++) {
+        if (q[col] > OPACITY_MAX) {
+          // not a 4bits pattern, it will be drawn pixel by pixel
+          return NULL;
+        }
+      }
+    }
+
+    int size = 0;
+    for (coord_t row=0; row<height; row++) {
+      size += encodeGlyphRow(NULL, font + 4 + row*w + offset, width);
+    }
+
+    spans = new uint8_t[size];
+    if (!spans) {
+      return NULL;
+    }
+
+    uint8_t * out = spans;
+    for (coord_t row=0; row<height; row++) {
+      out += encodeGlyphRow(out, font + 4 + row*w + offset, width);
+    }
+    table->glyphs[index] = spans;
+  }
+
+  return spans;
+}
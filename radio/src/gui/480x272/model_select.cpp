@@ -405,6 +405,8 @@ ModelselectButton::ModelselectButton(ModelselectPage* page, Window * parent, con
                  memcpy(duplicatedFilename, modelCell->modelFilename, sizeof(duplicatedFilename));
                  if (findNextFileIndex(duplicatedFilename, LEN_MODEL_FILENAME, MODELS_PATH)) {
                    sdCopyFile(modelCell->modelFilename, MODELS_PATH, duplicatedFilename, MODELS_PATH);
+                   modelIdIndex.duplicate(modelCell->modelFilename, duplicatedFilename);
+                   modelIdIndex.save();
                    modelslist.addModel(currentCategory, duplicatedFilename);
                    page->updateModels(currentCategory->size() - 1);
                  }
@@ -18,6 +18,7 @@
  * GNU General Public License for more details.
  */
 
+#include <algorithm>
 #include "radio_sdmanager.h"
 #include "opentx.h"
 #include "libwindows.h"
@@ -73,23 +74,52 @@ class FileNameEditWindow : public Page {
 	}
 };
 
+#define SD_MANAGER_COLUMNS             4
+#define SD_MANAGER_READ_BATCH          32 // entries read per cycle
+#define SD_MANAGER_HEADER_HEIGHT       (lineHeight + 2 * lineSpacing)
+
+void SdDirectoryIndex::add(const char * name, uint8_t attributes, uint32_t size)
+{
+  entries.push_back({uint32_t(names.size()), size, attributes});
+  names.insert(names.end(), name, name + strlen(name) + 1);
+}
+
+void SdDirectoryIndex::sort()
+{
+  const char * arena = names.data();
+  std::sort(entries.begin(), entries.end(), [=](const Entry & first, const Entry & second) {
+    if ((first.attributes ^ second.attributes) & AM_DIR)
+      return bool(first.attributes & AM_DIR);
+    return strcasecmp(arena + first.nameOffset, arena + second.nameOffset) < 0;
+  });
+}
+
+int SdDirectoryIndex::find(const char * prefix) const
+{
+  size_t length = strlen(prefix);
+  for (unsigned i = 0; i < entries.size(); i++) {
+    if (!strncasecmp(getName(i), prefix, length))
+      return i;
+  }
+  return -1;
+}
+
 RadioSdManagerPage::RadioSdManagerPage():
   PageTab(SD_IS_HC() ? STR_SDHC_CARD : STR_SD_CARD, ICON_RADIO_SD_BROWSER)
 {
 }
 
-void RadioSdManagerPage::rebuild(Window * window)
+RadioSdManagerPage::~RadioSdManagerPage()
 {
-  coord_t scrollPosition = window->getScrollPositionY();
-  window->clear();
-  build(window);
-  window->setScrollPositionY(scrollPosition);
+  stopReading();
 }
 
-// comparison, not case sensitive.
-bool compare_nocase(const std::string &first, const std::string &second)
+void RadioSdManagerPage::rebuild(Window * window)
 {
-  return strcasecmp(first.c_str(), second.c_str()) < 0;
+  coord_t position = window->getScrollPositionY();
+  window->clear();
+  build(window);
+  scrollPosition = position;
 }
 
 char * getFullPath(const std::string & filename)
@@ -113,154 +143,255 @@ const char * getBasename(const char * path)
 
 void RadioSdManagerPage::build(Window * window)
 {
-  GridNxMLayout grid(4,4);
+  this->window = window;
+  stopReading();
+  index.clear();
+  buttons.clear(); // the buttons were deleted with the window children
+  firstButtonEntry = -1;
+  lastScrollPosition = -1;
+  scrollPosition = 0;
+  // TextEdit doesn't write the last char of the buffer
+  memclear(jumpPrefix, sizeof(jumpPrefix));
+  memclear(lastJumpPrefix, sizeof(lastJumpPrefix));
+
+  // type-ahead: the list jumps to the first entry starting with the typed text
+  new TextEdit(window, {6, lineSpacing, LCD_W / 2, lineHeight}, jumpPrefix, SD_SCREEN_FILE_LENGTH, 0, nullptr, false);
+
+  // the directory is read a few entries per cycle, the list is displayed once sorted
+  if (f_opendir(&dir, ".") == FR_OK) {
+    loading = new StaticText(window, {0, SD_MANAGER_HEADER_HEIGHT + lineHeight, LCD_W, lineHeight}, STR_SD_LOADING, CENTERED);
+    reading = true;
+    firstTime = true;
+  }
+}
+
+void RadioSdManagerPage::checkEvents()
+{
+  if (reading) {
+    readEntries();
+  }
+  else if (window) {
+    checkJump();
+    if (window->getScrollPositionY() != lastScrollPosition) {
+      updateButtons();
+    }
+  }
+}
+
+void RadioSdManagerPage::stopReading()
+{
+  if (reading) {
+    f_closedir(&dir);
+    reading = false;
+  }
+}
+
+void RadioSdManagerPage::readEntries()
+{
   FILINFO fno;
-  DIR dir;
-  std::list<std::string> files;
-  std::list<std::string> directories;
-
-  FRESULT res = f_opendir(&dir, "."); // Open the directory
-  if (res == FR_OK) {
-    // read all entries
-    bool firstTime = true;
-    for (;;) {
-      res = sdReadDir(&dir, &fno, firstTime);
-
-      if (res != FR_OK || fno.fname[0] == 0)
-        break; // Break on error or end of dir
-      if (strlen(fno.fname) > SD_SCREEN_FILE_LENGTH)
-        continue;
-      if (fno.fname[0] == '.' && fno.fname[1] != '.')
-        continue; // Ignore hidden files under UNIX, but not ..
-
-      if (fno.fattrib & AM_DIR) {
-        directories.push_back(fno.fname);
-      }
-      else {
-        files.push_back(fno.fname);
-      }
+
+  for (int i = 0; i < SD_MANAGER_READ_BATCH; i++) {
+    FRESULT res = sdReadDir(&dir, &fno, firstTime);
+    if (res != FR_OK || fno.fname[0] == 0) {
+      // end of dir (or error)
+      stopReading();
+      index.sort();
+      loading->deleteLater();
+      loading = nullptr;
+      GridNxMLayout grid(SD_MANAGER_COLUMNS, SD_MANAGER_COLUMNS);
+      coord_t rows = (index.count() + SD_MANAGER_COLUMNS - 1) / SD_MANAGER_COLUMNS;
+      window->setInnerHeight(SD_MANAGER_HEADER_HEIGHT + grid.getFieldSlot(rows * SD_MANAGER_COLUMNS).y);
+      window->setScrollPositionY(scrollPosition);
+      updateButtons();
+      return;
     }
+    if (strlen(fno.fname) > SD_SCREEN_FILE_LENGTH)
+      continue;
+    if (fno.fname[0] == '.' && fno.fname[1] != '.')
+      continue; // Ignore hidden files under UNIX, but not ..
+    index.add(fno.fname, fno.fattrib, fno.fsize);
+  }
+}
 
-    // sort directories and files
-    directories.sort(compare_nocase);
-    files.sort(compare_nocase);
+// Only the rows on screen have a button, they are moved and reassigned
+// to other entries when the list is scrolled
+void RadioSdManagerPage::updateButtons()
+{
+  GridNxMLayout grid(SD_MANAGER_COLUMNS, SD_MANAGER_COLUMNS);
+  coord_t rowHeight = grid.getRowHeight();
+
+  lastScrollPosition = window->getScrollPositionY();
+  unsigned first = max<coord_t>(0, lastScrollPosition - SD_MANAGER_HEADER_HEIGHT) / rowHeight * SD_MANAGER_COLUMNS;
+  unsigned count = 0;
+  if (first < index.count()) {
+    count = min<unsigned>(index.count() - first, (window->height() / rowHeight + 2) * SD_MANAGER_COLUMNS);
+  }
+
+  if (int(first) == firstButtonEntry && buttons.size() == count) {
+    return;
+  }
+  firstButtonEntry = first;
 
-    for (auto name: directories) {
-      new FileButton(window, grid.getNextFieldSlot(), name, true, [=]() -> uint8_t {
-        f_chdir(name.data());
-        window->clear();
-        build(window);
+  while (buttons.size() > count) {
+    buttons.back()->deleteLater();
+    buttons.pop_back();
+  }
+
+  for (unsigned i = 0; i < count; i++) {
+    unsigned entry = first + i;
+    std::string name = index.getName(entry);
+    bool directory = index.isDirectory(entry);
+    rect_t slot = grid.getFieldSlot(entry);
+    slot.y += SD_MANAGER_HEADER_HEIGHT;
+
+    FileButton * button;
+    if (i < buttons.size()) {
+      button = buttons[i];
+      button->setLeft(slot.x);
+      button->setTop(slot.y);
+      button->setFile(name, directory);
+    }
+    else {
+      button = new FileButton(window, slot, name, directory, nullptr);
+      buttons.push_back(button);
+    }
+
+    if (directory) {
+      button->setPressHandler([=]() -> uint8_t {
+        openDirectory(name);
         return 0;
       });
     }
-    
-    for (auto name: files) {
-      new FileButton(window, grid.getNextFieldSlot(), name, false, [=]() -> uint8_t {
-        auto menu = new Menu();
-        const char * ext = getFileExtension(name.data());
-        char* fullPath = getFullPath(name);
-        if (ext) {
-          if (!strcasecmp(ext, SOUNDS_EXT)) {
-            menu->addLine(STR_PLAY_FILE, [=]() {
-              audioQueue.stopAll();
-              audioQueue.playFile(getFullPath(name), 0, ID_PLAY_FROM_SD_MANAGER);
-            });
-          }
-          else if (isExtensionMatching(ext, BITMAPS_EXT)) {
-            
-          }
-          else if (!strcasecmp(ext, TEXT_EXT)) {
-            menu->addLine(STR_VIEW_TEXT, [=]() {
-              // TODO
-            });
-          }
-          else if (!READ_ONLY() && !strcasecmp(ext, SPORT_FIRMWARE_EXT)) {
-            menu->addLine(STR_FLASH_EXTERNAL_DEVICE, [=]() {
-              FrskyDeviceFirmwareUpdate device(EXTERNAL_MODULE);
-              setModuleUpdateStatus(EXTERNAL_MODULE, true);
-              device.flashFirmware(getFullPath(name));
-              setModuleUpdateStatus(EXTERNAL_MODULE, false);
-              runProgressScreen();
-            });
-          }
+    else {
+      button->setPressHandler([=]() -> uint8_t {
+        openFileMenu(name);
+        return 0;
+      });
+    }
+  }
+}
+
+void RadioSdManagerPage::checkJump()
+{
+  if (strcmp(jumpPrefix, lastJumpPrefix)) {
+    strcpy(lastJumpPrefix, jumpPrefix);
+    int entry = index.find(jumpPrefix);
+    if (entry >= 0) {
+      GridNxMLayout grid(SD_MANAGER_COLUMNS, SD_MANAGER_COLUMNS);
+      window->setScrollPositionY(SD_MANAGER_HEADER_HEIGHT + grid.getFieldSlot(entry).y - lineSpacing);
+    }
+  }
+}
+
+void RadioSdManagerPage::openDirectory(const std::string & name)
+{
+  f_chdir(name.data());
+  window->clear();
+  build(window);
+}
+
+void RadioSdManagerPage::openFileMenu(const std::string & name)
+{
+  auto menu = new Menu();
+  const char * ext = getFileExtension(name.data());
+  char* fullPath = getFullPath(name);
+  if (ext) {
+    if (!strcasecmp(ext, SOUNDS_EXT)) {
+      menu->addLine(STR_PLAY_FILE, [=]() {
+        audioQueue.stopAll();
+        audioQueue.playFile(getFullPath(name), 0, ID_PLAY_FROM_SD_MANAGER);
+      });
+    }
+    else if (isExtensionMatching(ext, BITMAPS_EXT)) {
+      
+    }
+    else if (!strcasecmp(ext, TEXT_EXT)) {
+      menu->addLine(STR_VIEW_TEXT, [=]() {
+        // TODO
+      });
+    }
+    else if (!READ_ONLY() && !strcasecmp(ext, SPORT_FIRMWARE_EXT)) {
+      menu->addLine(STR_FLASH_EXTERNAL_DEVICE, [=]() {
+        FrskyDeviceFirmwareUpdate device(EXTERNAL_MODULE);
+        setModuleUpdateStatus(EXTERNAL_MODULE, true);
+        device.flashFirmware(getFullPath(name));
+        setModuleUpdateStatus(EXTERNAL_MODULE, false);
+        runProgressScreen();
+      });
+    }
 #if defined(LUA)
-          else if (isExtensionMatching(ext, SCRIPTS_EXT)) {
-            menu->addLine(STR_EXECUTE_FILE, [=]() {
-              luaExec(getFullPath(name));
-            });
-          }
+    else if (isExtensionMatching(ext, SCRIPTS_EXT)) {
+      menu->addLine(STR_EXECUTE_FILE, [=]() {
+        luaExec(getFullPath(name));
+      });
+    }
 #endif
 #if defined(MULTIMODULE)
-          else if (!READ_ONLY() && !strcasecmp(ext, MULTI_FIRMWARE_EXT)) {
-            
-            MultiFirmwareInformation information;
-           
-            if (information.readMultiFirmwareInformation(fullPath) == nullptr) {
+    else if (!READ_ONLY() && !strcasecmp(ext, MULTI_FIRMWARE_EXT)) {
+      
+      MultiFirmwareInformation information;
+     
+      if (information.readMultiFirmwareInformation(fullPath) == nullptr) {
 #if defined(INTERNAL_MODULE_MULTI)
-              menu->addLine(STR_FLASH_INTERNAL_MULTI, [=]() {
-                multiFlashFirmware(INTERNAL_MODULE, fullPath, MULTI_TYPE_MULTIMODULE);
-                runProgressScreen();
-              });
+        menu->addLine(STR_FLASH_INTERNAL_MULTI, [=]() {
+          multiFlashFirmware(INTERNAL_MODULE, fullPath, MULTI_TYPE_MULTIMODULE);
+          runProgressScreen();
+        });
 #endif        
-              menu->addLine(STR_FLASH_EXTERNAL_MULTI, [=]() {
-                multiFlashFirmware(EXTERNAL_MODULE, fullPath, MULTI_TYPE_MULTIMODULE);
-                runProgressScreen();
-              });
-            }
+        menu->addLine(STR_FLASH_EXTERNAL_MULTI, [=]() {
+          multiFlashFirmware(EXTERNAL_MODULE, fullPath, MULTI_TYPE_MULTIMODULE);
+          runProgressScreen();
+        });
+      }
 #if defined(PCBNV14)
-            Nv14FirmwareInformation nv14Info;
-            if (nv14Info.read(fullPath) == nullptr && nv14Info.valid()) {
-              menu->addLine(STR_FLASH_INTERNAL_MODULE, [=]() {
-                setModuleUpdateStatus(INTERNAL_MODULE, true);
-                nv14FlashFirmware(fullPath);
-                setModuleUpdateStatus(INTERNAL_MODULE, false);
-                runProgressScreen();
-              });
-            }
+      Nv14FirmwareInformation nv14Info;
+      if (nv14Info.read(fullPath) == nullptr && nv14Info.valid()) {
+        menu->addLine(STR_FLASH_INTERNAL_MODULE, [=]() {
+          setModuleUpdateStatus(INTERNAL_MODULE, true);
+          nv14FlashFirmware(fullPath);
+          setModuleUpdateStatus(INTERNAL_MODULE, false);
+          runProgressScreen();
+        });
+      }
 #endif 
-          }
-          else if (!READ_ONLY() && !strcasecmp(ext, ELRS_FIRMWARE_EXT)) {
-            menu->addLine(STR_FLASH_EXTERNAL_ELRS, [=]() {
-                multiFlashFirmware(EXTERNAL_MODULE, fullPath, MULTI_TYPE_ELRS);
-                runProgressScreen();
-            });
-          }
+    }
+    else if (!READ_ONLY() && !strcasecmp(ext, ELRS_FIRMWARE_EXT)) {
+      menu->addLine(STR_FLASH_EXTERNAL_ELRS, [=]() {
+          multiFlashFirmware(EXTERNAL_MODULE, fullPath, MULTI_TYPE_ELRS);
+          runProgressScreen();
+      });
+    }
 #endif
+  }
+  if (!READ_ONLY()) {
+    menu->addLine(STR_COPY_FILE, [=]() {
+      clipboard.type = CLIPBOARD_TYPE_SD_FILE;
+      f_getcwd(clipboard.data.sd.directory, CLIPBOARD_PATH_LEN);
+      strncpy(clipboard.data.sd.filename, name.c_str(), CLIPBOARD_PATH_LEN-1);
+    });
+    if (clipboard.type == CLIPBOARD_TYPE_SD_FILE) {
+      menu->addLine(STR_PASTE, [=]() {
+        TCHAR lfn[_MAX_LFN+1];
+        f_getcwd(lfn, _MAX_LFN);
+
+        if (strcmp(clipboard.data.sd.directory, lfn)) {  // prevent copying to the same directory
+          POPUP_WARNING(sdCopyFile(clipboard.data.sd.filename, clipboard.data.sd.directory, clipboard.data.sd.filename, lfn));
+          clipboard.type = CLIPBOARD_TYPE_NONE;
         }
-        if (!READ_ONLY()) {
-          menu->addLine(STR_COPY_FILE, [=]() {
-            clipboard.type = CLIPBOARD_TYPE_SD_FILE;
-            f_getcwd(clipboard.data.sd.directory, CLIPBOARD_PATH_LEN);
-            strncpy(clipboard.data.sd.filename, name.c_str(), CLIPBOARD_PATH_LEN-1);
-          });
-          if (clipboard.type == CLIPBOARD_TYPE_SD_FILE) {
-            menu->addLine(STR_PASTE, [=]() {
-              TCHAR lfn[_MAX_LFN+1];
-			        f_getcwd(lfn, _MAX_LFN);
-              
-			        if (strcmp(clipboard.data.sd.directory, lfn)) {  // prevent copying to the same directory
-				        POPUP_WARNING(sdCopyFile(clipboard.data.sd.filename, clipboard.data.sd.directory, clipboard.data.sd.filename, lfn));
-				        clipboard.type = CLIPBOARD_TYPE_NONE;
-			        }
-			        rebuild(window);
-            });
-          }
-          menu->addLine(STR_RENAME_FILE, [=]() {
-            auto few = new FileNameEditWindow(name);
-			      few->setCloseHandler([=]() {
-              rebuild(window);
-            });
-          });
-          menu->addLine(STR_DELETE_FILE, [=]() {
-            f_unlink(getFullPath(name));
-            rebuild(window);
-          });
-        }
-        return 0;
+        rebuild(window);
       });
     }
+    menu->addLine(STR_RENAME_FILE, [=]() {
+      auto few = new FileNameEditWindow(name);
+      few->setCloseHandler([=]() {
+        rebuild(window);
+      });
+    });
+    menu->addLine(STR_DELETE_FILE, [=]() {
+      f_unlink(getFullPath(name));
+      rebuild(window);
+    });
   }
-  window->setInnerHeight(grid.getWindowHeight() + 100);
 }
 
 #if 0
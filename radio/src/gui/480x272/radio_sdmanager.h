@@ -18,14 +18,84 @@
  * GNU General Public License for more details.
  */
 
+#include <vector>
 #include "tabsgroup.h"
 
+class FileButton;
+class StaticText;
+
+// Sorted entries of a directory, directories first. The names are stored
+// one after the other in a single arena to avoid an allocation per entry.
+class SdDirectoryIndex {
+  public:
+    struct Entry {
+      uint32_t nameOffset;
+      uint32_t size;
+      uint8_t attributes;
+    };
+
+    void clear()
+    {
+      names.clear();
+      entries.clear();
+    }
+
+    void add(const char * name, uint8_t attributes, uint32_t size);
+
+    void sort();
+
+    unsigned count() const
+    {
+      return entries.size();
+    }
+
+    const char * getName(unsigned index) const
+    {
+      return &names[entries[index].nameOffset];
+    }
+
+    bool isDirectory(unsigned index) const
+    {
+      return entries[index].attributes & AM_DIR;
+    }
+
+    // index of the first entry starting with prefix (case insensitive), -1 if none
+    int find(const char * prefix) const;
+
+  protected:
+    std::vector<char> names;
+    std::vector<Entry> entries;
+};
+
 class RadioSdManagerPage: public PageTab {
   public:
     RadioSdManagerPage();
 
+    ~RadioSdManagerPage() override;
+
     void build(Window * window) override;
 
+    void checkEvents() override;
+
   protected:
+    Window * window = nullptr;
+    SdDirectoryIndex index;
+    DIR dir;
+    bool reading = false;
+    bool firstTime = false;
+    coord_t scrollPosition = 0;
+    coord_t lastScrollPosition = -1;
+    int firstButtonEntry = -1;
+    StaticText * loading = nullptr;
+    std::vector<FileButton *> buttons;
+    char jumpPrefix[SD_SCREEN_FILE_LENGTH + 1];
+    char lastJumpPrefix[SD_SCREEN_FILE_LENGTH + 1];
+
     void rebuild(Window * window);
+    void stopReading();
+    void readEntries();
+    void updateButtons();
+    void checkJump();
+    void openDirectory(const std::string & name);
+    void openFileMenu(const std::string & name);
 };
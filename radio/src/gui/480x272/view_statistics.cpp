@@ -203,7 +203,18 @@ class DebugBody : public Window {
     DebugBody(Window * parent, const rect_t &rect) :
       Window(parent, rect)
     {
-      setInnerHeight(100); // TODO
+      coord_t y = MENU_CONTENT_TOP + 13 * FH;
+      auto reset = new TextButton(this, {10, y, LCD_W - 20, lineHeight}, "Push to reset");
+      reset->setPressHandler([=]() {
+        maxMixerDuration = 0;
+#if defined(LUA)
+        maxLuaInterval = 0;
+        maxLuaDuration = 0;
+        luaResetScriptsStats();
+#endif
+        return 0;
+      });
+      setInnerHeight(y + lineHeight + 10);
     }
 
     void checkEvents() override
@@ -253,6 +264,39 @@ class DebugBody : public Window {
       lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, "[B]", HEADER_COLOR|SMLSIZE);
       lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaExtraMemoryUsage, LEFT);
       ++line;
+
+      static const char * const luaClassNames[LUA_CLASS_COUNT] = { "[Mix]", "[Fn]", "[Tlm]", "[Fg]", "[W]" };
+      lcdDrawText(MENUS_MARGIN_LEFT, MENU_CONTENT_TOP+line*FH, "Lua max cycle");
+      lcdNextPos = MENU_STATS_COLUMN1 - 20;
+      for (int i=0; i<LUA_CLASS_COUNT; i++) {
+        if (i == LUA_CLASS_FOREGROUND) {
+          // the background classes on the first line, the foreground ones on the next
+          ++line;
+          lcdNextPos = MENU_STATS_COLUMN1 - 20;
+        }
+        lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, luaClassNames[i], HEADER_COLOR|SMLSIZE);
+        lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaSchedulerStats.maxUsed[i], LEFT | (luaSchedulerStats.maxUsed[i] > luaClassBudget[i] ? ALARM_COLOR : 0), 0, NULL, "us");
+      }
+      ++line;
+
+      lcdDrawText(MENUS_MARGIN_LEFT, MENU_CONTENT_TOP+line*FH, "Lua slowest");
+      int slowest = -1;
+      for (int i=0; i<luaScriptsCount; i++) {
+        if (slowest < 0 || scriptInternalData[i].stats.maxDuration > scriptInternalData[slowest].stats.maxDuration) {
+          slowest = i;
+        }
+      }
+      if (slowest >= 0) {
+        const LuaScriptStats & stats = scriptInternalData[slowest].stats;
+        lcdDrawText(MENU_STATS_COLUMN1, MENU_CONTENT_TOP+line*FH+1, "[#]", HEADER_COLOR|SMLSIZE);
+        lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, slowest + 1, LEFT);
+        lcdDrawNumber(lcdNextPos+10, MENU_CONTENT_TOP+line*FH, stats.maxDuration, LEFT, 0, NULL, "us");
+        lcdDrawNumber(lcdNextPos+10, MENU_CONTENT_TOP+line*FH, stats.instructions, LEFT, 0, NULL, "%");
+        lcdDrawNumber(lcdNextPos+10, MENU_CONTENT_TOP+line*FH, stats.allocated, LEFT, 0, NULL, "b");
+      }
+      lcdDrawText(lcdNextPos+20, MENU_CONTENT_TOP+line*FH+1, "[Deferred]", HEADER_COLOR|SMLSIZE);
+      lcdDrawNumber(lcdNextPos+5, MENU_CONTENT_TOP+line*FH, luaSchedulerStats.deferred, LEFT);
+      ++line;
 #endif
 
       lcdDrawText(MENUS_MARGIN_LEFT, MENU_CONTENT_TOP + line * FH, "Tlm RX Errs");
@@ -187,6 +187,13 @@ class FileButton: public Button {
 
     void paint(BitmapBuffer * dc) override;
 
+    void setFile(std::string value, bool isFolder)
+    {
+      text = std::move(value);
+      folder = isFolder;
+      invalidate();
+    }
+
   protected:
     static const std::list<std::string> fileTypeBin;
     static const std::list<std::string> fileTypeAudio;
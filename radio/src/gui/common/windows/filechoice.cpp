@@ -27,7 +27,11 @@ const uint8_t LBM_FOLDER[] = {
 #include "mask_folder.lbm"
 };
 
-extern bool compare_nocase (const std::string& first, const std::string& second);
+// comparison, not case sensitive.
+static bool compare_nocase(const std::string &first, const std::string &second)
+{
+  return strcasecmp(first.c_str(), second.c_str()) < 0;
+}
 
 FileChoice::FileChoice(Window * parent, const rect_t & rect, std::string folder, const char * extension, int maxlen, std::function<std::string()> getValue, std::function<void(std::string)> setValue, bool skipExtension):
   Window(parent, rect),
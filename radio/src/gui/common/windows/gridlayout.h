@@ -115,6 +115,26 @@ class GridNxMLayout {
       return {left, currentY, width, width};
     }
 
+    // Slot of the given field, without moving to the next one
+    rect_t getFieldSlot(coord_t field) const
+    {
+      coord_t width = (LCD_W - (lineMarginRight + lineMarginRight + (columns - 1) * lineSpacing)) / columns;
+      coord_t left = lineMarginLeft + ((width + lineSpacing) * (field % columns));
+      return {left, topMargin + getRowHeight() * (field / columns), width, width};
+    }
+
+    coord_t getRowHeight() const
+    {
+      coord_t width = (LCD_W - (lineMarginRight + lineMarginRight + (columns - 1) * lineSpacing)) / columns;
+      coord_t height = (LCD_H - (topMargin + bottomMargin + (rows - 1) * lineSpacing)) / rows;
+      return (columns == rows ? width : height) + lineSpacing;
+    }
+
+    coord_t getColumns() const
+    {
+      return columns;
+    }
+
     void spacer(coord_t height=lineSpacing)
     {
       currentY += height;
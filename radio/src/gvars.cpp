@@ -48,7 +48,20 @@ void setGVarValue(uint8_t idx, int8_t value)
 uint8_t gvarDisplayTimer = 0;
 uint8_t gvarLastChanged = 0;
 
-uint8_t getGVarFlightMode(uint8_t fm, uint8_t gv) // TODO change params order to be consistent!
+// Resolved flight mode and value of each GVAR for all flight modes, so that
+// the mixer doesn't walk the inheritance chain for each GVAR reference.
+// Covering all flight modes means a flight mode change (or fade) doesn't
+// require any update, only GVAR writes do (see invalidateGVarsCache())
+struct GVarsCache {
+  uint8_t flightMode[MAX_FLIGHT_MODES][MAX_GVARS];
+  int16_t value[MAX_FLIGHT_MODES][MAX_GVARS];
+};
+
+GVarsCache gvarsCache;
+volatile uint32_t gvarsCacheVersion = 1;
+uint32_t gvarsCacheBuiltVersion = 0;
+
+uint8_t resolveGVarFlightMode(uint8_t fm, uint8_t gv)
 {
   for (uint8_t i=0; i<MAX_FLIGHT_MODES; i++) {
     if (fm == 0) return 0;
@@ -61,6 +74,43 @@ uint8_t getGVarFlightMode(uint8_t fm, uint8_t gv) // TODO change params order to
   return 0;
 }
 
+void invalidateGVarsCache()
+{
+  gvarsCacheVersion++;
+}
+
+static inline void checkGVarsCache()
+{
+  uint32_t version = gvarsCacheVersion;
+  if (version != gvarsCacheBuiltVersion) {
+    for (uint8_t fm=0; fm<MAX_FLIGHT_MODES; fm++) {
+      for (uint8_t gv=0; gv<MAX_GVARS; gv++) {
+        uint8_t resolved = resolveGVarFlightMode(fm, gv);
+        gvarsCache.flightMode[fm][gv] = resolved;
+        gvarsCache.value[fm][gv] = GVAR_VALUE(gv, resolved);
+      }
+    }
+    // if a GVAR was written meanwhile the version changed and the cache will be rebuilt next time
+    gvarsCacheBuiltVersion = version;
+  }
+}
+
+uint8_t getGVarFlightMode(uint8_t fm, uint8_t gv) // TODO change params order to be consistent!
+{
+  if (fm >= MAX_FLIGHT_MODES || gv >= MAX_GVARS)
+    return resolveGVarFlightMode(fm, gv);
+  checkGVarsCache();
+  return gvarsCache.flightMode[fm][gv];
+}
+
+static inline int16_t getResolvedGVarValue(uint8_t gv, uint8_t fm)
+{
+  if (fm >= MAX_FLIGHT_MODES || gv >= MAX_GVARS)
+    return GVAR_VALUE(gv, resolveGVarFlightMode(fm, gv));
+  checkGVarsCache();
+  return gvarsCache.value[fm][gv];
+}
+
 int16_t getGVarValue(int8_t gv, int8_t fm)
 {
   int8_t mul = 1;
@@ -68,7 +118,7 @@ int16_t getGVarValue(int8_t gv, int8_t fm)
     gv = -1-gv;
     mul = -1;
   }
-  return GVAR_VALUE(gv, getGVarFlightMode(fm, gv)) * mul;
+  return getResolvedGVarValue(gv, fm) * mul;
 }
 
 int32_t getGVarValuePrec1(int8_t gv, int8_t fm)
@@ -84,7 +134,7 @@ int32_t getGVarValuePrec1(int8_t gv, int8_t fm)
     gv = -1-gv;
     mul = -mul;
   }
-  return GVAR_VALUE(gv, getGVarFlightMode(fm, gv)) * mul;
+  return getResolvedGVarValue(gv, fm) * mul;
 }
 
 void setGVarValue(uint8_t gv, int16_t value, int8_t fm)
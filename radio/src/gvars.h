@@ -46,6 +46,8 @@
     #define SET_GVAR(idx, val, fm)     setGVarValue(idx, val)
   #else
     uint8_t getGVarFlightMode(uint8_t fm, uint8_t gv);
+    uint8_t resolveGVarFlightMode(uint8_t fm, uint8_t gv);
+    void invalidateGVarsCache();
     int16_t getGVarFieldValue(int16_t x, int16_t min, int16_t max, int8_t fm);
     int32_t getGVarFieldValuePrec1(int16_t x, int16_t min, int16_t max, int8_t fm);
     int16_t getGVarValue(int8_t gv, int8_t fm);
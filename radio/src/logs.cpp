@@ -323,18 +323,9 @@ void logsWrite()
             else if (sensor.unit == UNIT_DATETIME) {
               f_printf(&g_oLogFile, "%4d-%02d-%02d %02d:%02d:%02d,", telemetryItem.datetime.year, telemetryItem.datetime.month, telemetryItem.datetime.day, telemetryItem.datetime.hour, telemetryItem.datetime.min, telemetryItem.datetime.sec);
             }
-            else if (sensor.prec == 2) {
-              div_t qr = div((int)telemetryItem.value, 100);
-              if (telemetryItem.value < 0) f_printf(&g_oLogFile, "-");
-              f_printf(&g_oLogFile, "%d.%02d,", abs(qr.quot), abs(qr.rem));
-            }
-            else if (sensor.prec == 1) {
-              div_t qr = div((int)telemetryItem.value, 10);
-              if (telemetryItem.value < 0) f_printf(&g_oLogFile, "-");
-              f_printf(&g_oLogFile, "%d.%d,", abs(qr.quot), abs(qr.rem));
-            }
             else {
-              f_printf(&g_oLogFile, "%d,", telemetryItem.value);
+              f_puts(telemetryItem.getPresentation(sensor).text, &g_oLogFile);
+              f_putc(',', &g_oLogFile);
             }
           }
         }
@@ -198,11 +198,14 @@ static int luaGetRtcTime(lua_State * L)
 static void luaPushLatLon(lua_State* L, TelemetrySensor & telemetrySensor, TelemetryItem & telemetryItem)
 /* result is lua table containing members ["lat"] and ["lon"] as lua_Number (doubles) in decimal degrees */
 {
-  lua_createtable(L, 0, 4);
+  lua_createtable(L, 0, 7);
   lua_pushtablenumber(L, "lat", telemetryItem.gps.latitude * 0.000001); // floating point multiplication is faster than division
   lua_pushtablenumber(L, "pilot-lat", telemetryItem.pilotLatitude * 0.000001);
   lua_pushtablenumber(L, "lon", telemetryItem.gps.longitude * 0.000001);
   lua_pushtablenumber(L, "pilot-lon", telemetryItem.pilotLongitude * 0.000001);
+  lua_pushtableinteger(L, "distance", telemetryItem.gps.distance);
+  lua_pushtablenumber(L, "bearing", telemetryItem.gps.bearing * 0.1);
+  lua_pushtablenumber(L, "speed", telemetryItem.gps.speed * 0.01);
 }
 
 static void luaPushTelemetryDateTime(lua_State* L, TelemetrySensor & telemetrySensor, TelemetryItem & telemetryItem)
@@ -620,6 +623,9 @@ or a name (string) of the source.
  * `lon` (number) longitude, positive is East
  * `pilot-lat` (number) pilot latitude, positive is North
  * `pilot-lon` (number) pilot longitude, positive is East
+ * `distance` (number) distance from the pilot in meters
+ * `bearing` (number) direction from the pilot in degrees, clockwise from the North
+ * `speed` (number) ground speed between the last two positions in m/s
 
 @retval table GPS date/time, see getDateTime()
 
@@ -1358,9 +1364,7 @@ static int luaSerialWrite(lua_State * L)
 #if !defined(SIMU)
   #if defined(USB_SERIAL)
   if (getSelectedUsbMode() == USB_SERIAL_MODE) {
-    size_t wr_len = len;
-    const char* p = str;
-    while(wr_len--) usbSerialPutc(*p++);
+    usbSerialWrite((const uint8_t *)str, len);
   }
   #endif
   #if defined(AUX_SERIAL)
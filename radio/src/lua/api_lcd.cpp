@@ -87,6 +87,25 @@ static int luaLcdDrawPoint(lua_State *L)
   return 0;
 }
 
+static void luaDrawLine(coord_t x1, coord_t y1, coord_t x2, coord_t y2, uint8_t pat, LcdFlags flags)
+{
+  if (x1 > LCD_W || y1 > LCD_H || x2 > LCD_W || y2 > LCD_H)
+    return;
+
+  if (pat == SOLID) {
+    if (x1 == x2) {
+      lcdDrawSolidVerticalLine(x1, y1<y2 ? y1 : y2,  y1<y2 ? (y2-y1)+1 : (y1-y2)+1, flags);
+      return;
+    }
+    else if (y1 == y2) {
+      lcdDrawSolidHorizontalLine(x1<x2 ? x1 : x2, y1, x1<x2 ? (x2-x1)+1 : (x1-x2)+1, flags);
+      return;
+    }
+  }
+
+  lcdDrawLine(x1, y1, x2, y2, pat, flags);
+}
+
 /*luadoc
 @function lcd.drawLine(x1, y1, x2, y2, pattern, flags)
 
@@ -114,22 +133,7 @@ static int luaLcdDrawLine(lua_State *L)
   coord_t y2 = luaL_checkunsigned(L, 4);
   uint8_t pat = luaL_checkunsigned(L, 5);
   LcdFlags flags = luaL_checkunsigned(L, 6);
-
-  if (x1 > LCD_W || y1 > LCD_H || x2 > LCD_W || y2 > LCD_H)
-    return 0;
-
-  if (pat == SOLID) {
-    if (x1 == x2) {
-      lcdDrawSolidVerticalLine(x1, y1<y2 ? y1 : y2,  y1<y2 ? (y2-y1)+1 : (y1-y2)+1, flags);
-      return 0;
-    }
-    else if (y1 == y2) {
-      lcdDrawSolidHorizontalLine(x1<x2 ? x1 : x2, y1, x1<x2 ? (x2-x1)+1 : (x1-x2)+1, flags);
-      return 0;
-    }
-  }
-
-  lcdDrawLine(x1, y1, x2, y2, pat, flags);
+  luaDrawLine(x1, y1, x2, y2, pat, flags);
   return 0;
 }
 
@@ -187,6 +191,14 @@ static int luaLcdGetLeftPos(lua_State *L)
 
 #endif // COLORLCD
 
+static void luaDrawText(int x, int y, const char * s, unsigned int att)
+{
+  #if defined(COLORLCD)
+  if ((att&SHADOWED) && !(att&INVERS)) lcdDrawText(x+1, y+1, s, att&0xFFFF);
+  #endif
+  lcdDrawText(x, y, s, att);
+}
+
 /*luadoc
 @function lcd.drawText(x, y, text [, flags])
 
@@ -217,13 +229,20 @@ static int luaLcdDrawText(lua_State *L)
   int y = luaL_checkinteger(L, 2);
   const char * s = luaL_checkstring(L, 3);
   unsigned int att = luaL_optunsigned(L, 4, 0);
-  #if defined(COLORLCD)
-  if ((att&SHADOWED) && !(att&INVERS)) lcdDrawText(x+1, y+1, s, att&0xFFFF);
-  #endif
-  lcdDrawText(x, y, s, att);
+  luaDrawText(x, y, s, att);
   return 0;
 }
 
+static void luaDrawTimer(int x, int y, int seconds, unsigned int att)
+{
+#if defined(COLORLCD)
+  if (att&SHADOWED) drawTimer(x+1, y+1, seconds, (att&0xFFFF)|LEFT);
+  drawTimer(x, y, seconds, att|LEFT);
+#else
+  drawTimer(x, y, seconds, att|LEFT, att);
+#endif
+}
+
 /*luadoc
 @function lcd.drawTimer(x, y, value [, flags])
 
@@ -248,15 +267,18 @@ static int luaLcdDrawTimer(lua_State *L)
   int y = luaL_checkinteger(L, 2);
   int seconds = luaL_checkinteger(L, 3);
   unsigned int att = luaL_optunsigned(L, 4, 0);
-#if defined(COLORLCD)
-  if (att&SHADOWED) drawTimer(x+1, y+1, seconds, (att&0xFFFF)|LEFT);
-  drawTimer(x, y, seconds, att|LEFT);
-#else
-  drawTimer(x, y, seconds, att|LEFT, att);
-#endif
+  luaDrawTimer(x, y, seconds, att);
   return 0;
 }
 
+static void luaDrawNumber(int x, int y, int val, unsigned int att)
+{
+  #if defined(COLORLCD)
+  if ((att&SHADOWED) && !(att&INVERS)) lcdDrawNumber(x, y, val, att&0xFFFF);
+  #endif
+  lcdDrawNumber(x, y, val, att);
+}
+
 /*luadoc
 @function lcd.drawNumber(x, y, value [, flags])
 
@@ -282,10 +304,7 @@ static int luaLcdDrawNumber(lua_State *L)
   int y = luaL_checkinteger(L, 2);
   int val = luaL_checkinteger(L, 3);
   unsigned int att = luaL_optunsigned(L, 4, 0);
-  #if defined(COLORLCD)
-  if ((att&SHADOWED) && !(att&INVERS)) lcdDrawNumber(x, y, val, att&0xFFFF);
-  #endif
-  lcdDrawNumber(x, y, val, att);
+  luaDrawNumber(x, y, val, att);
   return 0;
 }
 
@@ -379,6 +398,179 @@ static int luaLcdDrawSource(lua_State *L)
 
 #define LUA_BITMAPHANDLE          "BITMAP*"
 
+// Bitmaps opened by Lua are shared between all scripts and widgets: each entry is
+// keyed by path and file date/size, counts the Lua objects using it, and unused entries
+// are kept (least recently used first evicted) as long as the memory budget allows
+
+#define LUA_BITMAPS_CACHE_SIZE    24
+#define LUA_BITMAP_PATH_MAX       128
+
+struct LuaBitmapsCacheEntry
+{
+  BitmapBuffer * bitmap;
+  char path[LUA_BITMAP_PATH_MAX];
+  uint16_t fdate;
+  uint16_t ftime;
+  uint32_t fsize;
+  uint16_t refs;
+  uint32_t lastUse;
+};
+
+static LuaBitmapsCacheEntry luaBitmapsCache[LUA_BITMAPS_CACHE_SIZE];
+static uint32_t luaBitmapsCacheTick = 0;
+LuaBitmapsCacheStats luaBitmapsCacheStats;
+
+static void luaReleaseBitmapMemory(BitmapBuffer * bitmap)
+{
+  uint32_t size = bitmap->getDataSize();
+  if (luaExtraMemoryUsage >= size) {
+    luaExtraMemoryUsage -= size;
+  }
+  else {
+    luaExtraMemoryUsage = 0;
+  }
+  delete bitmap;
+}
+
+static void luaEvictBitmapsCacheEntry(LuaBitmapsCacheEntry * entry)
+{
+  TRACE("luaBitmapsCache: evict %s (%u)", entry->path, entry->bitmap->getDataSize());
+  luaReleaseBitmapMemory(entry->bitmap);
+  memset(entry, 0, sizeof(LuaBitmapsCacheEntry));
+  luaBitmapsCacheStats.entries--;
+  luaBitmapsCacheStats.evictions++;
+}
+
+// Frees the least recently used unreferenced bitmap, returns its (now free) entry or NULL if none
+static LuaBitmapsCacheEntry * luaEvictUnusedBitmap()
+{
+  LuaBitmapsCacheEntry * oldest = NULL;
+  for (int i=0; i<LUA_BITMAPS_CACHE_SIZE; i++) {
+    LuaBitmapsCacheEntry * entry = &luaBitmapsCache[i];
+    if (entry->bitmap && entry->refs == 0 && (!oldest || (int32_t)(entry->lastUse - oldest->lastUse) < 0)) {
+      oldest = entry;
+    }
+  }
+  if (oldest) {
+    luaEvictBitmapsCacheEntry(oldest);
+  }
+  return oldest;
+}
+
+void luaFlushBitmapsCache()
+{
+  while (luaEvictUnusedBitmap()) {
+  }
+}
+
+static BitmapBuffer * luaLoadBitmap(lua_State * L, const char * filename)
+{
+  // make room for the new bitmap in the memory budget
+  while (luaExtraMemoryUsage > LUA_MEM_EXTRA_MAX && luaEvictUnusedBitmap()) {
+  }
+  if (luaExtraMemoryUsage > LUA_MEM_EXTRA_MAX) {
+    // already allocated more than max allowed, fail
+    TRACE("luaOpenBitmap: Error, using too much memory %u/%u", luaExtraMemoryUsage, LUA_MEM_EXTRA_MAX);
+    return NULL;
+  }
+
+  BitmapBuffer * bitmap = BitmapBuffer::load(filename);
+  if (bitmap == NULL) {
+    /* try to free some memory... */
+    if (G(L)->gcrunning) {
+      luaC_fullgc(L, 1);
+    }
+    luaFlushBitmapsCache();
+    bitmap = BitmapBuffer::load(filename);  /* try again */
+  }
+
+  if (bitmap) {
+    luaExtraMemoryUsage += bitmap->getDataSize();
+  }
+  return bitmap;
+}
+
+static BitmapBuffer * luaGetCachedBitmap(lua_State * L, const char * filename)
+{
+  FILINFO info;
+  if (strlen(filename) >= LUA_BITMAP_PATH_MAX || f_stat(filename, &info) != FR_OK) {
+    // not cacheable (the load will most probably fail anyway)
+    luaBitmapsCacheStats.misses++;
+    return luaLoadBitmap(L, filename);
+  }
+
+  LuaBitmapsCacheEntry * freeEntry = NULL;
+  for (int i=0; i<LUA_BITMAPS_CACHE_SIZE; i++) {
+    LuaBitmapsCacheEntry * entry = &luaBitmapsCache[i];
+    if (entry->bitmap && !strcmp(entry->path, filename)) {
+      if (entry->fdate == info.fdate && entry->ftime == info.ftime && entry->fsize == info.fsize) {
+        luaBitmapsCacheStats.hits++;
+        entry->refs++;
+        entry->lastUse = ++luaBitmapsCacheTick;
+        return entry->bitmap;
+      }
+      else if (entry->refs == 0) {
+        // the file has been modified since it was loaded
+        luaEvictBitmapsCacheEntry(entry);
+      }
+    }
+    if (!entry->bitmap && !freeEntry) {
+      freeEntry = entry;
+    }
+  }
+
+  luaBitmapsCacheStats.misses++;
+
+  BitmapBuffer * bitmap = luaLoadBitmap(L, filename);
+  if (!bitmap) {
+    return NULL;
+  }
+
+  if (!freeEntry || freeEntry->bitmap) {
+    // the table may have changed during the load (garbage collection)
+    freeEntry = NULL;
+    for (int i=0; i<LUA_BITMAPS_CACHE_SIZE && !freeEntry; i++) {
+      if (!luaBitmapsCache[i].bitmap)
+        freeEntry = &luaBitmapsCache[i];
+    }
+    if (!freeEntry)
+      freeEntry = luaEvictUnusedBitmap();
+  }
+
+  if (freeEntry) {
+    freeEntry->bitmap = bitmap;
+    strcpy(freeEntry->path, filename);
+    freeEntry->fdate = info.fdate;
+    freeEntry->ftime = info.ftime;
+    freeEntry->fsize = info.fsize;
+    freeEntry->refs = 1;
+    freeEntry->lastUse = ++luaBitmapsCacheTick;
+    luaBitmapsCacheStats.entries++;
+  }
+
+  // keep the unused bitmaps within the memory budget
+  while (luaExtraMemoryUsage > LUA_MEM_EXTRA_MAX && luaEvictUnusedBitmap()) {
+  }
+
+  return bitmap;
+}
+
+static void luaReleaseCachedBitmap(BitmapBuffer * bitmap)
+{
+  for (int i=0; i<LUA_BITMAPS_CACHE_SIZE; i++) {
+    LuaBitmapsCacheEntry * entry = &luaBitmapsCache[i];
+    if (entry->bitmap == bitmap) {
+      if (entry->refs > 0) {
+        entry->refs--;
+      }
+      return;
+    }
+  }
+
+  // the bitmap was not cached
+  luaReleaseBitmapMemory(bitmap);
+}
+
 /*luadoc
 @function Bitmap.open(name)
 
@@ -386,6 +578,9 @@ Loads a bitmap in memory, for later use with lcd.drawBitmap(). Bitmaps should be
 once, returned object should be stored and used for drawing. If loading fails for whatever
 reason the resulting bitmap object will have width and height set to zero.
 
+The same file opened several times (by one or several scripts) is loaded only once, the
+bitmap is shared until the file is modified.
+
 Bitmap loading can fail if:
  * File is not found or contains invalid image
  * System is low on memory
@@ -405,23 +600,10 @@ static int luaOpenBitmap(lua_State * L)
 
   BitmapBuffer ** b = (BitmapBuffer **)lua_newuserdata(L, sizeof(BitmapBuffer *));
 
-  if (luaExtraMemoryUsage > LUA_MEM_EXTRA_MAX) {
-    // already allocated more than max allowed, fail
-    TRACE("luaOpenBitmap: Error, using too much memory %u/%u", luaExtraMemoryUsage, LUA_MEM_EXTRA_MAX);
-    *b = 0;
-  }
-  else {
-    *b = BitmapBuffer::load(filename);
-    if (*b == NULL && G(L)->gcrunning) {
-      luaC_fullgc(L, 1);  /* try to free some memory... */
-      *b = BitmapBuffer::load(filename);  /* try again */
-    }
-  }
+  *b = luaGetCachedBitmap(L, filename);
 
   if (*b) {
-    uint32_t size = (*b)->getDataSize();
-    luaExtraMemoryUsage += size;
-    TRACE("luaOpenBitmap: %p (%u)", *b, size);
+    TRACE("luaOpenBitmap: %p (%u)", *b, (*b)->getDataSize());
   }
 
   luaL_getmetatable(L, LUA_BITMAPHANDLE);
@@ -465,19 +647,39 @@ static int luaGetBitmapSize(lua_State * L)
   return 2;
 }
 
+/*luadoc
+@function Bitmap.getCacheUsage()
+
+Return the statistics of the cache of bitmaps shared by all scripts and widgets
+
+@retval table with the following fields:
+ * `hits` (number) number of Bitmap.open() calls served from the cache
+ * `misses` (number) number of Bitmap.open() calls which loaded the file
+ * `evictions` (number) number of unused bitmaps freed from the cache
+ * `entries` (number) number of bitmaps in the cache
+ * `bytes` (number) memory used by all bitmaps opened by Lua (in bytes)
+
+@notice Only available on Horus
+
+@status current Introduced in 2.3.0
+*/
+static int luaGetBitmapsCacheUsage(lua_State * L)
+{
+  lua_newtable(L);
+  lua_pushtableinteger(L, "hits", luaBitmapsCacheStats.hits);
+  lua_pushtableinteger(L, "misses", luaBitmapsCacheStats.misses);
+  lua_pushtableinteger(L, "evictions", luaBitmapsCacheStats.evictions);
+  lua_pushtableinteger(L, "entries", luaBitmapsCacheStats.entries);
+  lua_pushtableinteger(L, "bytes", luaExtraMemoryUsage);
+  return 1;
+}
+
 static int luaDestroyBitmap(lua_State * L)
 {
   BitmapBuffer * b = checkBitmap(L, 1);
   if (b) {
-    uint32_t size = b->getDataSize();
-    TRACE("luaDestroyBitmap: %p (%u)", b, size);
-    if (luaExtraMemoryUsage >= size) {
-      luaExtraMemoryUsage -= size;
-    }
-    else {
-      luaExtraMemoryUsage = 0;
-    }
-    delete b;
+    TRACE("luaDestroyBitmap: %p (%u)", b, b->getDataSize());
+    luaReleaseCachedBitmap(b);
   }
   return 0;
 }
@@ -485,6 +687,7 @@ static int luaDestroyBitmap(lua_State * L)
 const luaL_Reg bitmapFuncs[] = {
   { "open", luaOpenBitmap },
   { "getSize", luaGetBitmapSize },
+  { "getCacheUsage", luaGetBitmapsCacheUsage },
   { "__gc", luaDestroyBitmap },
   { NULL, NULL }
 };
@@ -562,6 +765,15 @@ static int luaLcdDrawPixmap(lua_State *L)
 }
 #endif
 
+static void luaDrawRectangle(int x, int y, int w, int h, unsigned int flags, unsigned int t)
+{
+#if defined(PCBHORUS) || defined(PCBNV14)
+  lcdDrawRect(x, y, w, h, t, 0xff, flags);
+#else
+  lcdDrawRect(x, y, w, h, 0xff, flags);
+#endif
+}
+
 /*luadoc
 @function lcd.drawRectangle(x, y, w, h [, flags [, t]])
 
@@ -587,12 +799,8 @@ static int luaLcdDrawRectangle(lua_State *L)
   int w = luaL_checkinteger(L, 3);
   int h = luaL_checkinteger(L, 4);
   unsigned int flags = luaL_optunsigned(L, 5, 0);
-#if defined(PCBHORUS) || defined(PCBNV14)
   unsigned int t = luaL_optunsigned(L, 6, 1);
-  lcdDrawRect(x, y, w, h, t, 0xff, flags);
-#else
-  lcdDrawRect(x, y, w, h, 0xff, flags);
-#endif
+  luaDrawRectangle(x, y, w, h, flags, t);
   return 0;
 }
 
@@ -624,6 +832,17 @@ static int luaLcdDrawFilledRectangle(lua_State *L)
 }
 
 
+static void luaDrawGauge(int x, int y, int w, int h, int num, int den, unsigned int flags)
+{
+#if defined(PCBHORUS) || defined(PCBNV14)
+  lcdDrawRect(x, y, w, h, 1, 0xff, flags);
+#else
+  lcdDrawRect(x, y, w, h, 0xff, flags);
+#endif
+  uint8_t len = limit((uint8_t)1, uint8_t(w*num/den), uint8_t(w));
+  lcdDrawSolidFilledRect(x+1, y+1, len, h-2, flags);
+}
+
 /*luadoc
 @function lcd.drawGauge(x, y, w, h, fill, maxfill [, flags])
 
@@ -653,13 +872,7 @@ static int luaLcdDrawGauge(lua_State *L)
   int num = luaL_checkinteger(L, 5);
   int den = luaL_checkinteger(L, 6);
   unsigned int flags = luaL_optunsigned(L, 7, 0);
-#if defined(PCBHORUS) || defined(PCBNV14)
-  lcdDrawRect(x, y, w, h, 1, 0xff, flags);
-#else
-  lcdDrawRect(x, y, w, h, 0xff, flags);
-#endif
-  uint8_t len = limit((uint8_t)1, uint8_t(w*num/den), uint8_t(w));
-  lcdDrawSolidFilledRect(x+1, y+1, len, h-2, flags);
+  luaDrawGauge(x, y, w, h, num, den, flags);
   return 0;
 }
 
@@ -934,6 +1147,374 @@ static int luaLcdGetWidth(lua_State *L) {
 
 #endif
 
+#define LUA_DISPLAYLISTHANDLE     "DISPLAYLIST*"
+#define LUA_DISPLAYLIST_MAX_ITEMS 256
+#define LUA_DISPLAYLIST_TEXT_LEN  32
+
+#if defined(COLORLCD)
+  #define LUA_DISPLAYLIST_TEXT_HEIGHT   64   // highest font, used to cull texts
+#else
+  #define LUA_DISPLAYLIST_TEXT_HEIGHT   32
+#endif
+
+enum DisplayListCommand {
+  DISPLAYLIST_TEXT,
+  DISPLAYLIST_NUMBER,
+  DISPLAYLIST_TIMER,
+  DISPLAYLIST_LINE,
+  DISPLAYLIST_RECTANGLE,
+  DISPLAYLIST_FILLED_RECTANGLE,
+  DISPLAYLIST_GAUGE,
+};
+
+struct DisplayListItem {
+  uint8_t command;
+  uint8_t visible;
+  int16_t x;
+  int16_t y;
+  int16_t w;        // width, or x2 for lines
+  int16_t h;        // height, or y2 for lines
+  int32_t value;    // number, time, gauge fill, rectangle thickness or line pattern
+  int32_t maximum;  // gauge max fill
+  LcdFlags flags;
+  char text[LUA_DISPLAYLIST_TEXT_LEN];
+};
+
+struct DisplayList {
+  uint16_t count;
+  uint16_t capacity;
+  DisplayListItem items[1];
+};
+
+static DisplayList * checkDisplayList(lua_State * L, int index)
+{
+  return (DisplayList *)luaL_checkudata(L, index, LUA_DISPLAYLISTHANDLE);
+}
+
+static DisplayListItem * checkDisplayListItem(lua_State * L, DisplayList * list, int index)
+{
+  int item = luaL_checkinteger(L, index);
+  luaL_argcheck(L, item >= 1 && item <= list->count, index, "invalid item");
+  return &list->items[item-1];
+}
+
+static void initDisplayListItem(lua_State * L, DisplayListItem & item, uint8_t command)
+{
+  memclear(&item, sizeof(DisplayListItem));
+  item.command = command;
+  item.x = luaL_checkinteger(L, 2);
+  item.y = luaL_checkinteger(L, 3);
+}
+
+// Called once all the item arguments are checked, so that a failed add leaves the list unchanged
+static int addDisplayListItem(lua_State * L, DisplayList * list, DisplayListItem & item)
+{
+  if (list->count >= list->capacity) {
+    luaL_error(L, "display list full (%d items)", list->capacity);
+  }
+  item.visible = true;
+  list->items[list->count++] = item;
+  lua_pushinteger(L, list->count);
+  return 1;
+}
+
+static void setDisplayListText(DisplayListItem & item, const char * text)
+{
+  strncpy(item.text, text, LUA_DISPLAYLIST_TEXT_LEN-1);
+  item.text[LUA_DISPLAYLIST_TEXT_LEN-1] = '\0';
+}
+
+/*luadoc
+@function lcd.newList([capacity])
+
+Creates a display list: a list of drawing commands built once and then drawn with a single
+lcd.drawList() call. Items parameters can be changed later (setText, setValue, ...) without
+rebuilding the list, items outside of the drawing area are skipped.
+
+The list object provides the following methods, the `add` ones return the item index:
+ * `list:addText(x, y, text [, flags])` (texts are limited to 31 characters)
+ * `list:addNumber(x, y, value [, flags])`
+ * `list:addTimer(x, y, value [, flags])`
+ * `list:addLine(x1, y1, x2, y2, pattern, flags)`
+ * `list:addRectangle(x, y, w, h [, flags [, t]])`
+ * `list:addFilledRectangle(x, y, w, h [, flags])`
+ * `list:addGauge(x, y, w, h, fill, maxfill [, flags])`
+ * `list:setText(index, text)`
+ * `list:setValue(index, value [, maxfill])`
+ * `list:setPosition(index, x, y)`
+ * `list:setFlags(index, flags)`
+ * `list:setVisible(index, visible)`
+ * `list:clear()`
+ * `list:getCount()`
+
+@param capacity (number) maximum number of items, defaults to 32 (256 max)
+
+@retval list (object) a display list object
+
+@status current Introduced in 2.3.0
+*/
+static int luaLcdNewList(lua_State * L)
+{
+  int capacity = luaL_optinteger(L, 1, 32);
+  luaL_argcheck(L, capacity >= 1 && capacity <= LUA_DISPLAYLIST_MAX_ITEMS, 1, "invalid capacity");
+
+  DisplayList * list = (DisplayList *)lua_newuserdata(L, sizeof(DisplayList) + (capacity-1) * sizeof(DisplayListItem));
+  list->count = 0;
+  list->capacity = capacity;
+
+  luaL_getmetatable(L, LUA_DISPLAYLISTHANDLE);
+  lua_setmetatable(L, -2);
+
+  return 1;
+}
+
+static int luaDisplayListAddText(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_TEXT);
+  setDisplayListText(item, luaL_checkstring(L, 4));
+  item.flags = luaL_optunsigned(L, 5, 0);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListAddNumber(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_NUMBER);
+  item.value = luaL_checkinteger(L, 4);
+  item.flags = luaL_optunsigned(L, 5, 0);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListAddTimer(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_TIMER);
+  item.value = luaL_checkinteger(L, 4);
+  item.flags = luaL_optunsigned(L, 5, 0);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListAddLine(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_LINE);
+  item.w = luaL_checkinteger(L, 4);
+  item.h = luaL_checkinteger(L, 5);
+  item.value = luaL_checkunsigned(L, 6);
+  item.flags = luaL_checkunsigned(L, 7);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListAddRectangle(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_RECTANGLE);
+  item.w = luaL_checkinteger(L, 4);
+  item.h = luaL_checkinteger(L, 5);
+  item.flags = luaL_optunsigned(L, 6, 0);
+  item.value = luaL_optunsigned(L, 7, 1);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListAddFilledRectangle(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_FILLED_RECTANGLE);
+  item.w = luaL_checkinteger(L, 4);
+  item.h = luaL_checkinteger(L, 5);
+  item.flags = luaL_optunsigned(L, 6, 0);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListAddGauge(lua_State * L)
+{
+  DisplayList * list = checkDisplayList(L, 1);
+  DisplayListItem item;
+  initDisplayListItem(L, item, DISPLAYLIST_GAUGE);
+  item.w = luaL_checkinteger(L, 4);
+  item.h = luaL_checkinteger(L, 5);
+  item.value = luaL_checkinteger(L, 6);
+  item.maximum = luaL_checkinteger(L, 7);
+  luaL_argcheck(L, item.maximum != 0, 7, "invalid maxfill");
+  item.flags = luaL_optunsigned(L, 8, 0);
+  return addDisplayListItem(L, list, item);
+}
+
+static int luaDisplayListSetText(lua_State * L)
+{
+  DisplayListItem * item = checkDisplayListItem(L, checkDisplayList(L, 1), 2);
+  setDisplayListText(*item, luaL_checkstring(L, 3));
+  return 0;
+}
+
+static int luaDisplayListSetValue(lua_State * L)
+{
+  DisplayListItem * item = checkDisplayListItem(L, checkDisplayList(L, 1), 2);
+  item->value = luaL_checkinteger(L, 3);
+  if (item->command == DISPLAYLIST_GAUGE && !lua_isnoneornil(L, 4)) {
+    int maximum = luaL_checkinteger(L, 4);
+    luaL_argcheck(L, maximum != 0, 4, "invalid maxfill");
+    item->maximum = maximum;
+  }
+  return 0;
+}
+
+static int luaDisplayListSetPosition(lua_State * L)
+{
+  DisplayListItem * item = checkDisplayListItem(L, checkDisplayList(L, 1), 2);
+  int x = luaL_checkinteger(L, 3);
+  int y = luaL_checkinteger(L, 4);
+  if (item->command == DISPLAYLIST_LINE) {
+    // the whole line is moved
+    item->w += x - item->x;
+    item->h += y - item->y;
+  }
+  item->x = x;
+  item->y = y;
+  return 0;
+}
+
+static int luaDisplayListSetFlags(lua_State * L)
+{
+  DisplayListItem * item = checkDisplayListItem(L, checkDisplayList(L, 1), 2);
+  item->flags = luaL_checkunsigned(L, 3);
+  return 0;
+}
+
+static int luaDisplayListSetVisible(lua_State * L)
+{
+  DisplayListItem * item = checkDisplayListItem(L, checkDisplayList(L, 1), 2);
+  item->visible = lua_toboolean(L, 3);
+  return 0;
+}
+
+static int luaDisplayListClear(lua_State * L)
+{
+  checkDisplayList(L, 1)->count = 0;
+  return 0;
+}
+
+static int luaDisplayListGetCount(lua_State * L)
+{
+  lua_pushinteger(L, checkDisplayList(L, 1)->count);
+  return 1;
+}
+
+/*luadoc
+@function lcd.drawList(list [, x, y])
+
+Draws all visible items of a display list created with lcd.newList()
+
+@param list (object) the display list
+
+@param x,y (numbers) offset applied to all items, defaults to 0
+
+@status current Introduced in 2.3.0
+*/
+static int luaLcdDrawList(lua_State * L)
+{
+  if (!luaLcdAllowed) return 0;
+  const DisplayList * list = checkDisplayList(L, 1);
+  int dx = luaL_optinteger(L, 2, 0);
+  int dy = luaL_optinteger(L, 3, 0);
+
+#if defined(COLORLCD)
+  coord_t left, right, top, bottom;
+  lcd->getClippingRect(left, right, top, bottom);
+#else
+  coord_t left = 0, right = LCD_W, top = 0, bottom = LCD_H;
+#endif
+
+  for (const DisplayListItem * item = list->items; item < list->items + list->count; item++) {
+    if (!item->visible) {
+      continue;
+    }
+
+    int x = item->x + dx;
+    int y = item->y + dy;
+
+    switch (item->command) {
+      case DISPLAYLIST_TEXT:
+      case DISPLAYLIST_NUMBER:
+      case DISPLAYLIST_TIMER:
+        // the width depends on the alignment flags, only the rows are checked
+        if (y >= bottom || y + LUA_DISPLAYLIST_TEXT_HEIGHT <= top)
+          continue;
+        break;
+
+      case DISPLAYLIST_LINE:
+        if (max(x, item->w + dx) < left || min(x, item->w + dx) >= right || max(y, item->h + dy) < top || min(y, item->h + dy) >= bottom)
+          continue;
+        break;
+
+      default:
+        if (x + item->w <= left || x >= right || y + item->h <= top || y >= bottom)
+          continue;
+        break;
+    }
+
+    switch (item->command) {
+      case DISPLAYLIST_TEXT:
+        luaDrawText(x, y, item->text, item->flags);
+        break;
+      case DISPLAYLIST_NUMBER:
+        luaDrawNumber(x, y, item->value, item->flags);
+        break;
+      case DISPLAYLIST_TIMER:
+        luaDrawTimer(x, y, item->value, item->flags);
+        break;
+      case DISPLAYLIST_LINE:
+        luaDrawLine(x, y, item->w + dx, item->h + dy, item->value, item->flags);
+        break;
+      case DISPLAYLIST_RECTANGLE:
+        luaDrawRectangle(x, y, item->w, item->h, item->flags, item->value);
+        break;
+      case DISPLAYLIST_FILLED_RECTANGLE:
+        lcdDrawFilledRect(x, y, item->w, item->h, SOLID, item->flags);
+        break;
+      case DISPLAYLIST_GAUGE:
+        luaDrawGauge(x, y, item->w, item->h, item->value, item->maximum, item->flags);
+        break;
+    }
+  }
+
+  return 0;
+}
+
+const luaL_Reg displayListFuncs[] = {
+  { "addText", luaDisplayListAddText },
+  { "addNumber", luaDisplayListAddNumber },
+  { "addTimer", luaDisplayListAddTimer },
+  { "addLine", luaDisplayListAddLine },
+  { "addRectangle", luaDisplayListAddRectangle },
+  { "addFilledRectangle", luaDisplayListAddFilledRectangle },
+  { "addGauge", luaDisplayListAddGauge },
+  { "setText", luaDisplayListSetText },
+  { "setValue", luaDisplayListSetValue },
+  { "setPosition", luaDisplayListSetPosition },
+  { "setFlags", luaDisplayListSetFlags },
+  { "setVisible", luaDisplayListSetVisible },
+  { "clear", luaDisplayListClear },
+  { "getCount", luaDisplayListGetCount },
+  { NULL, NULL }
+};
+
+void registerDisplayListClass(lua_State * L)
+{
+  luaL_newmetatable(L, LUA_DISPLAYLISTHANDLE);
+  luaL_setfuncs(L, displayListFuncs, 0);
+  lua_pushvalue(L, -1);
+  lua_setfield(L, -2, "__index");
+  lua_pop(L, 1);
+}
+
 const luaL_Reg lcdLib[] = {
   { "refresh", luaLcdRefresh },
   { "clear", luaLcdClear },
@@ -948,6 +1529,8 @@ const luaL_Reg lcdLib[] = {
   { "drawSwitch", luaLcdDrawSwitch },
   { "drawSource", luaLcdDrawSource },
   { "drawGauge", luaLcdDrawGauge },
+  { "newList", luaLcdNewList },
+  { "drawList", luaLcdDrawList },
 #if defined(COLORLCD)
   { "drawBitmap", luaLcdDrawBitmap },
   { "setColor", luaLcdSetColor },
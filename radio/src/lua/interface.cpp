@@ -52,6 +52,124 @@ struct our_longjmp * global_lj = 0;
 uint32_t luaExtraMemoryUsage = 0;
 #endif
 
+#define LUA_MAX_DEFERRED_CYCLES            5
+
+// Time budget of each scripts class per cycle (us)
+const uint32_t luaClassBudget[LUA_CLASS_COUNT] = {
+  2000,   // mix scripts
+  2000,   // function scripts
+  2000,   // telemetry background scripts
+  20000,  // standalone and telemetry foreground scripts
+  20000,  // widgets
+};
+
+LuaSchedulerStats luaSchedulerStats;
+LuaScriptStats luaForegroundStats;
+LuaScriptStats luaWidgetsStats;
+uint32_t luaAllocatedBytes = 0;
+
+// Allocator of the Lua states, counts the memory requested by the scripts
+void * luaAlloc(void * ud, void * ptr, size_t osize, size_t nsize)
+{
+  size_t previous = (ptr ? osize : 0);
+  if (nsize > previous) {
+    luaAllocatedBytes += nsize - previous;
+  }
+#if defined(USE_BIN_ALLOCATOR)
+  return bin_l_alloc(ud, ptr, osize, nsize);
+#elif defined(LUA_ALLOCATOR_TRACER)
+  return tracer_alloc(ud, ptr, osize, nsize);
+#else
+  return l_alloc(ud, ptr, osize, nsize);
+#endif
+}
+
+void luaStartMeasure(LuaRunMeasure & measure)
+{
+  measure.t2MHz = getTmr2MHz();
+  measure.t10ms = get_tmr10ms();
+  measure.allocated = luaAllocatedBytes;
+}
+
+void luaStopMeasure(const LuaRunMeasure & measure, LuaScriptStats & stats, uint8_t scriptClass)
+{
+  // the 2MHz timer wraps after 32ms, longer runs are measured with the 10ms timer
+  tmr10ms_t ticks = get_tmr10ms() - measure.t10ms;
+  uint32_t duration = (ticks >= 3 ? ticks * 10000 : (uint16_t)(getTmr2MHz() - measure.t2MHz) / 2);
+
+  stats.duration = duration;
+  if (duration > stats.maxDuration) {
+    stats.maxDuration = duration;
+  }
+  stats.allocated = luaAllocatedBytes - measure.allocated;
+  stats.instructions = instructionsPercent;
+  stats.runs++;
+  luaSchedulerStats.used[scriptClass] += duration;
+}
+
+// Called at the start of each cycle (before the background scripts)
+static void luaStartCycle()
+{
+  luaSchedulerStats.foregroundLate = (luaSchedulerStats.used[LUA_CLASS_FOREGROUND] > luaClassBudget[LUA_CLASS_FOREGROUND] ||
+                                      luaSchedulerStats.used[LUA_CLASS_WIDGETS] > luaClassBudget[LUA_CLASS_WIDGETS]);
+
+  for (int i=0; i<LUA_CLASS_COUNT; i++) {
+    uint32_t used = luaSchedulerStats.used[i];
+    if (used > luaSchedulerStats.maxUsed[i]) {
+      luaSchedulerStats.maxUsed[i] = used;
+    }
+    if (used > luaClassBudget[i]) {
+      luaSchedulerStats.overruns[i]++;
+    }
+    luaSchedulerStats.used[i] = 0;
+  }
+}
+
+// Background callbacks may be postponed to the next cycles when the foreground is late
+// or their class budget is spent, but never more than LUA_MAX_DEFERRED_CYCLES in a row
+static bool luaDeferRun(ScriptInternalData & sid, uint8_t scriptClass)
+{
+  if ((luaSchedulerStats.foregroundLate || luaSchedulerStats.used[scriptClass] >= luaClassBudget[scriptClass]) && sid.stats.deferredCycles < LUA_MAX_DEFERRED_CYCLES) {
+    sid.stats.deferredCycles++;
+    sid.stats.deferred++;
+    luaSchedulerStats.deferred++;
+    return true;
+  }
+  sid.stats.deferredCycles = 0;
+  return false;
+}
+
+void luaResetScriptsStats()
+{
+  memset(&luaSchedulerStats, 0, sizeof(luaSchedulerStats));
+  memset(&luaForegroundStats, 0, sizeof(luaForegroundStats));
+  memset(&luaWidgetsStats, 0, sizeof(luaWidgetsStats));
+  for (int i=0; i<MAX_SCRIPTS; i++) {
+    memset(&scriptInternalData[i].stats, 0, sizeof(LuaScriptStats));
+  }
+}
+
+#if defined(DEBUG) || defined(SIMU)
+void luaTraceScriptsStats()
+{
+  static const char * const classNames[LUA_CLASS_COUNT] = { "mix", "func", "telem", "fg", "widgets" };
+
+  if (!luaScriptsCount && !luaForegroundStats.runs && !luaWidgetsStats.runs) {
+    return;
+  }
+
+  for (int i=0; i<LUA_CLASS_COUNT; i++) {
+    TRACE("Lua %-7s max %6uus budget %6uus overruns %u", classNames[i], luaSchedulerStats.maxUsed[i], luaClassBudget[i], luaSchedulerStats.overruns[i]);
+  }
+  for (int i=0; i<luaScriptsCount; i++) {
+    const ScriptInternalData & sid = scriptInternalData[i];
+    TRACE("Lua script #%d (ref %d) %6uus max %6uus instr %3u%% alloc %5ub runs %u deferred %u",
+          i, sid.reference, sid.stats.duration, sid.stats.maxDuration, sid.stats.instructions, sid.stats.allocated, sid.stats.runs, sid.stats.deferred);
+  }
+  TRACE("Lua foreground %6uus max %6uus, widgets %6uus max %6uus", luaForegroundStats.duration, luaForegroundStats.maxDuration, luaWidgetsStats.duration, luaWidgetsStats.maxDuration);
+}
+#endif
+
 #if defined(LUA_ALLOCATOR_TRACER)
 
 LuaMemTracer lsScriptsTrace;
@@ -263,6 +381,7 @@ void luaClose(lua_State ** L)
 void luaRegisterLibraries(lua_State * L)
 {
   luaL_openlibs(L);
+  registerDisplayListClass(L);
 #if defined(COLORLCD)
   registerBitmapClass(L);
 #endif
@@ -353,21 +472,25 @@ static int luaDumpWriter(lua_State * L, const void* p, size_t size, void* u)
   @param stripDebug This is passed directly to luaU_dump()
     1 = remove debug info from bytecode (smaller but errors are less informative)
     0 = keep debug info
+
+  @retval true if the file was saved
 */
-static void luaDumpState(lua_State * L, const char * filename, const FILINFO * finfo, int stripDebug)
+static bool luaDumpState(lua_State * L, const char * filename, const FILINFO * finfo, int stripDebug)
 {
   FIL D;
   if (f_open(&D, filename, FA_WRITE | FA_CREATE_ALWAYS) == FR_OK) {
     lua_lock(L);
-    luaU_dump(L, getproto(L->top - 1), luaDumpWriter, &D, stripDebug);
+    int status = luaU_dump(L, getproto(L->top - 1), luaDumpWriter, &D, stripDebug);
     lua_unlock(L);
-    if (f_close(&D) == FR_OK) {
+    if (f_close(&D) == FR_OK && status == 0) {
       if (finfo != NULL)
         f_utime(filename, finfo);  // set the file mod time
       TRACE("luaDumpState(%s): Saved bytecode to file.", filename);
+      return true;
     }
   } else
     TRACE_ERROR("luaDumpState(%s): Error: Could not open output file.", filename);
+  return false;
 }
 #endif  // LUA_COMPILER
 
@@ -391,7 +514,8 @@ static void luaDumpState(lua_State * L, const char * filename, const FILINFO * f
       Eg: "tx", "bx", or "btx".
     Add "c" to force compilation of source file to .luac version (even if existing version is newer than source file).
       Eg: "tc" or "btc" (forces "t", overrides "x").
-    Add "d" to keep extra debug info in the compiled binary.
+    Add "d" to keep extra debug info in the compiled binary, otherwise a freshly compiled script is loaded
+      back from its stripped binary so that the debug info does not stay in the Lua heap.
       Eg: "td", "btd", or "tcd" (no effect with just "b" or with "x").
 
   @retval (int)
@@ -520,7 +644,14 @@ int luaLoadScriptFileToState(lua_State * L, const char * filename, const char *
   if (lstatus == LUA_OK) {
     if (scriptNeedsCompile && loadFileType == 1) {
       strcpy(filenameFull + fnamelen, SCRIPT_BIN_EXT);
-      luaDumpState(L, filenameFull, &fnoLuaS, (strchr(lmode, 'd') ? 0 : 1));
+      int stripDebug = (strchr(lmode, 'd') ? 0 : 1);
+      if (luaDumpState(L, filenameFull, &fnoLuaS, stripDebug) && stripDebug) {
+        // run the stripped version right away, the source one keeps the debug info in the heap
+        if (luaL_loadfilex(L, filenameFull, "b") == LUA_OK)
+          lua_remove(L, -2);
+        else
+          lua_pop(L, 1);
+      }
     }
     ret = SCRIPT_OK;
   }
@@ -830,7 +961,11 @@ void luaDoOneRunStandalone(event_ext_t evt)
     BitmapBuffer * previous = lcd;
     lcdNextLayer();
     DMACopy(previous->getData(), lcd->getData(), DISPLAY_BUFFER_SIZE);
-    if (lua_pcall(lsScripts, evt.paramsCount() + 1, 1, 0) == 0) {
+    LuaRunMeasure measure;
+    luaStartMeasure(measure);
+    int result = lua_pcall(lsScripts, evt.paramsCount() + 1, 1, 0);
+    luaStopMeasure(measure, luaForegroundStats, LUA_CLASS_FOREGROUND);
+    if (result == 0) {
       if (!lua_isnumber(lsScripts, -1)) {
         if (instructionsPercent > 100) {
           TRACE("Script killed");
@@ -915,6 +1050,7 @@ bool luaDoOneRunPermanentScript(event_ext_t evt, int i, uint32_t scriptType)
   const char *filename;
 #endif
   ScriptInputsOutputs * sio = NULL;
+  uint8_t scriptClass = LUA_CLASS_MIX;
 #if SCRIPT_MIX_FIRST > 0
   if ((scriptType & RUN_MIX_SCRIPT) && (sid.reference >= SCRIPT_MIX_FIRST && sid.reference <= SCRIPT_MIX_LAST)) {
 #else
@@ -939,9 +1075,10 @@ bool luaDoOneRunPermanentScript(event_ext_t evt, int i, uint32_t scriptType)
 #if defined(SIMU) || defined(DEBUG)
     filename = fn.play.name;
 #endif
+    scriptClass = LUA_CLASS_FUNC;
     if (getSwitch(fn.swtch))
       lua_rawgeti(lsScripts, LUA_REGISTRYINDEX, sid.run);
-    else if (sid.background)
+    else if (sid.background && !luaDeferRun(sid, scriptClass))
       lua_rawgeti(lsScripts, LUA_REGISTRYINDEX, sid.background);
     else
       return false;
@@ -953,6 +1090,7 @@ bool luaDoOneRunPermanentScript(event_ext_t evt, int i, uint32_t scriptType)
     filename = script.file;
 #endif
     if ((scriptType & RUN_TELEM_FG_SCRIPT) && (menuHandlers[0]==menuViewTelemetryFrsky && sid.reference==SCRIPT_TELEMETRY_FIRST+s_frsky_view)) {
+      scriptClass = LUA_CLASS_FOREGROUND;
       lua_rawgeti(lsScripts, LUA_REGISTRYINDEX, sid.run);
       lua_pushunsigned(lsScripts, evt.evt);
       inputsCount = 1 + evt.paramsCount();
@@ -961,7 +1099,8 @@ bool luaDoOneRunPermanentScript(event_ext_t evt, int i, uint32_t scriptType)
         lua_pushunsigned(lsScripts, evt.params[i]);
       }
     }
-    else if ((scriptType & RUN_TELEM_BG_SCRIPT) && (sid.background)) {
+    else if ((scriptType & RUN_TELEM_BG_SCRIPT) && (sid.background) && !luaDeferRun(sid, LUA_CLASS_TELEM_BG)) {
+      scriptClass = LUA_CLASS_TELEM_BG;
       lua_rawgeti(lsScripts, LUA_REGISTRYINDEX, sid.background);
     }
     else {
@@ -975,7 +1114,11 @@ bool luaDoOneRunPermanentScript(event_ext_t evt, int i, uint32_t scriptType)
   BitmapBuffer * previous = lcd;
   lcdNextLayer();
   DMACopy(previous->getData(), lcd->getData(), DISPLAY_BUFFER_SIZE);
-  if (lua_pcall(lsScripts, inputsCount, sio ? sio->outputsCount : 0, 0) == 0) {
+  LuaRunMeasure measure;
+  luaStartMeasure(measure);
+  int result = lua_pcall(lsScripts, inputsCount, sio ? sio->outputsCount : 0, 0);
+  luaStopMeasure(measure, sid.stats, scriptClass);
+  if (result == 0) {
     if (sio) {
       for (int j=sio->outputsCount-1; j>=0; j--) {
         if (!lua_isnumber(lsScripts, -1)) {
@@ -1016,6 +1159,10 @@ bool luaTask(event_ext_t evt, uint8_t scriptType, bool allowLcdUsage)
   luaLcdAllowed = allowLcdUsage;
   bool scriptWasRun = false;
 
+  if (scriptType & RUN_MIX_SCRIPT) {
+    luaStartCycle();
+  }
+
   // we run either standalone script or permanent scripts
   if (luaState & INTERPRETER_RUNNING_STANDALONE_SCRIPT) {
     // run standalone script
@@ -1065,6 +1212,10 @@ void checkLuaMemoryUsage()
   uint32_t totalMemUsed = luaGetMemUsed(lsScripts);
 #if defined(COLORLCD)
   totalMemUsed += luaGetMemUsed(lsWidgets);
+  if (totalMemUsed + luaExtraMemoryUsage > LUA_MEM_MAX) {
+    // the unused cached bitmaps go first
+    luaFlushBitmapsCache();
+  }
   totalMemUsed += luaExtraMemoryUsage;
 #endif
   if (totalMemUsed > LUA_MEM_MAX) {
@@ -1093,14 +1244,12 @@ void luaInit()
   luaClose(&lsScripts);
 
   if (luaState != INTERPRETER_PANIC) {
-#if defined(USE_BIN_ALLOCATOR)
-    lsScripts = lua_newstate(bin_l_alloc, NULL);   //we use our own allocator!
-#elif defined(LUA_ALLOCATOR_TRACER)
+#if defined(LUA_ALLOCATOR_TRACER)
     memset(&lsScriptsTrace, 0 , sizeof(lsScriptsTrace));
     lsScriptsTrace.script = "lua_newstate(scripts)";
-    lsScripts = lua_newstate(tracer_alloc, &lsScriptsTrace);   //we use tracer allocator
+    lsScripts = lua_newstate(luaAlloc, &lsScriptsTrace);   //we use tracer allocator
 #else
-    lsScripts = lua_newstate(l_alloc, NULL);   //we use Lua default allocator
+    lsScripts = lua_newstate(luaAlloc, NULL);   //we use our own (bin) or Lua default allocator
 #endif
     if (lsScripts) {
       // install our panic handler
@@ -52,6 +52,14 @@ extern lua_State * lsWidgets;
 extern bool luaLcdAllowed;
 #if defined(COLORLCD)
 extern uint32_t luaExtraMemoryUsage;
+struct LuaBitmapsCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint32_t entries;
+};
+extern LuaBitmapsCacheStats luaBitmapsCacheStats;
+void luaFlushBitmapsCache();
 #endif
 
 void luaInit();
@@ -110,12 +118,22 @@ enum ScriptReference {
   SCRIPT_TELEMETRY_FIRST,
   SCRIPT_TELEMETRY_LAST=SCRIPT_TELEMETRY_FIRST+MAX_SCRIPTS, // telem0 and telem1 .. telem7
 };
+struct LuaScriptStats {
+  uint32_t duration;          // last run (us)
+  uint32_t maxDuration;       // longest run (us)
+  uint32_t allocated;         // bytes allocated by the last run
+  uint16_t runs;
+  uint16_t deferred;          // runs postponed by the scheduler
+  uint8_t instructions;       // percent of the instructions limit used by the last run
+  uint8_t deferredCycles;     // consecutive cycles postponed
+};
 struct ScriptInternalData {
   uint8_t reference;
   uint8_t state;
   int run;
   int background;
   uint8_t instructions;
+  LuaScriptStats stats;
 };
 struct ScriptInputsOutputs {
   uint8_t inputsCount;
@@ -161,6 +179,43 @@ extern uint16_t maxLuaInterval;
 extern uint16_t maxLuaDuration;
 extern uint8_t instructionsPercent;
 
+// Scripts classes, each one has its own time budget per cycle
+enum LuaScriptClass {
+  LUA_CLASS_MIX,
+  LUA_CLASS_FUNC,
+  LUA_CLASS_TELEM_BG,
+  LUA_CLASS_FOREGROUND,
+  LUA_CLASS_WIDGETS,
+  LUA_CLASS_COUNT
+};
+
+struct LuaSchedulerStats {
+  uint32_t used[LUA_CLASS_COUNT];     // time used in the current cycle (us)
+  uint32_t maxUsed[LUA_CLASS_COUNT];  // longest cycle (us)
+  uint16_t overruns[LUA_CLASS_COUNT]; // cycles over budget
+  uint16_t deferred;                  // runs postponed
+  bool foregroundLate;
+};
+
+struct LuaRunMeasure {
+  uint16_t t2MHz;
+  tmr10ms_t t10ms;
+  uint32_t allocated;
+};
+
+extern LuaSchedulerStats luaSchedulerStats;
+extern LuaScriptStats luaForegroundStats;
+extern LuaScriptStats luaWidgetsStats;
+extern uint32_t luaAllocatedBytes;
+extern const uint32_t luaClassBudget[LUA_CLASS_COUNT];
+void * luaAlloc(void * ud, void * ptr, size_t osize, size_t nsize);
+void luaStartMeasure(LuaRunMeasure & measure);
+void luaStopMeasure(const LuaRunMeasure & measure, LuaScriptStats & stats, uint8_t scriptClass);
+void luaResetScriptsStats();
+#if defined(DEBUG) || defined(SIMU)
+void luaTraceScriptsStats();
+#endif
+
 #if defined(PCBXLITE)
   #define IS_MASKABLE(key) ((key) != KEY_EXIT && (key) != KEY_ENTER)
 #elif defined(PCBTARANIS)
@@ -176,6 +231,7 @@ bool luaFindFieldByName(const char * name, LuaField & field, unsigned int flags=
 void luaLoadThemes();
 void luaRegisterLibraries(lua_State * L);
 void registerBitmapClass(lua_State * L);
+void registerDisplayListClass(lua_State * L);
 void luaSetInstructionsLimit(lua_State* L, int count);
 int luaLoadScriptFileToState(lua_State * L, const char * filename, const char * mode);
 
@@ -402,7 +402,11 @@ void LuaWidget::refresh(event_ext_t event)
     snprintf(index, 8, "%d", i);
     l_pushtableuint(index, (uint)event.params[i]);
   }
-  if (lua_pcall(lsWidgets, 2, 0, 0) != 0) {
+  LuaRunMeasure measure;
+  luaStartMeasure(measure);
+  int result = lua_pcall(lsWidgets, 2, 0, 0);
+  luaStopMeasure(measure, luaWidgetsStats, LUA_CLASS_WIDGETS);
+  if (result != 0) {
     setErrorMessage("refresh()");
   }
 }
@@ -416,7 +420,11 @@ void LuaWidget::background()
   if (factory->backgroundFunction) {
     lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, factory->backgroundFunction);
     lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, widgetData);
-    if (lua_pcall(lsWidgets, 1, 0, 0) != 0) {
+    LuaRunMeasure measure;
+    luaStartMeasure(measure);
+    int result = lua_pcall(lsWidgets, 1, 0, 0);
+    luaStopMeasure(measure, luaWidgetsStats, LUA_CLASS_WIDGETS);
+    if (result != 0) {
       setErrorMessage("background()");
     }
   }
@@ -539,14 +547,12 @@ void luaInitThemesAndWidgets()
 {
   TRACE("luaInitThemesAndWidgets");
 
-#if defined(USE_BIN_ALLOCATOR)
-  lsWidgets = lua_newstate(bin_l_alloc, NULL);   //we use our own allocator!
-#elif defined(LUA_ALLOCATOR_TRACER)
+#if defined(LUA_ALLOCATOR_TRACER)
   memset(&lsWidgetsTrace, 0 , sizeof(lsWidgetsTrace));
   lsWidgetsTrace.script = "lua_newstate(widgets)";
-  lsWidgets = lua_newstate(tracer_alloc, &lsWidgetsTrace);   //we use tracer allocator
+  lsWidgets = lua_newstate(luaAlloc, &lsWidgetsTrace);   //we use tracer allocator
 #else
-  lsWidgets = lua_newstate(l_alloc, NULL);   //we use Lua default allocator
+  lsWidgets = lua_newstate(luaAlloc, NULL);   //we use our own (bin) or Lua default allocator
 #endif
   if (lsWidgets) {
     // install our panic handler
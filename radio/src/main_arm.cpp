@@ -91,9 +91,20 @@ void checkSpeakerVolume()
   }
 }
 
+#if defined(GVARS) && !defined(PCBSTD)
+// menus call storageDirty() before storing the edited value, keep invalidating
+// the GVARs cache until the model is written
+#define CHECK_GVARS_CACHE() \
+  if (storageDirtyMsk & EE_MODEL) \
+    invalidateGVarsCache()
+#else
+#define CHECK_GVARS_CACHE()
+#endif
+
 #if defined(EEPROM)
 void checkEeprom()
 {
+  CHECK_GVARS_CACHE();
   if (!usbPlugged()) {
     if (eepromIsWriting())
       eepromWriteProcess();
@@ -104,6 +115,7 @@ void checkEeprom()
 #else
 void checkEeprom()
 {
+  CHECK_GVARS_CACHE();
 #if defined(RAMBACKUP)
   if (TIME_TO_RAMBACKUP()) {
     rambackupWrite();
@@ -170,6 +182,9 @@ void periodicTick_10s()
   checkBatteryAlarms();
 #if defined(LUA)
   checkLuaMemoryUsage();
+#if defined(SIMU)
+  luaTraceScriptsStats();
+#endif
 #endif
 }
 
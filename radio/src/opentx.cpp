@@ -1698,6 +1698,8 @@ void doMixerCalculations()
   adcPrepareBandgap();
 #endif
 
+  trainerUpdateInput();
+
   DEBUG_TIMER_START(debugTimerEvalMixes);
   evalMixes(tick10ms);
   DEBUG_TIMER_STOP(debugTimerEvalMixes);
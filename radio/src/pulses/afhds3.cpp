@@ -19,10 +19,12 @@
  */
 
 
+#include "opentx.h"
 #include "afhds3.h"
 #include "../debug.h"
 #include "../definitions.h"
 #include "../translations.h"
+
 #define FAILSAFE_HOLD 1
 namespace afhds3 {
 
@@ -148,6 +150,7 @@ void afhds3::putFooter() {
     case FRAME_TYPE::REQUEST_SET_EXPECT_ACK:
     case FRAME_TYPE::REQUEST_SET_EXPECT_DATA:
       operationState = State::AWAITING_RESPONSE;
+      telemetryExpectResponse(AFHDS3_RESPONSE_DELAY);
       break;
     default:
       operationState = State::IDLE;
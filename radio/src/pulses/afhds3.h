@@ -28,6 +28,7 @@
 #include <queue>
 
 #define AFHDS3_BAUDRATE 1500000
+#define AFHDS3_RESPONSE_DELAY 2 // ms
 
 extern uint16_t failsafeCounter[NUM_MODULES];
 
@@ -29,36 +29,52 @@
 #define SBUS_FRAMELOST_BIT     2
 #define SBUS_FAILSAFE_BIT      3
 
-#define SBUS_CH_BITS           11
 #define SBUS_CH_MASK           ((1<<SBUS_CH_BITS)-1)
 
 #define SBUS_CH_CENTER         0x3E0
 
 
-// Range for pulses (ppm input) is [-512:+512]
-void processSbusFrame(uint8_t * sbus, int16_t * pulses, uint32_t size)
+// Reference decoder, one byte at a time
+void sbusUnpackChannelsBitwise(const uint8_t * payload, int16_t * pulses)
 {
-  if (size != SBUS_FRAME_SIZE || sbus[0] != SBUS_START_BYTE || sbus[SBUS_FRAME_SIZE-1] != SBUS_END_BYTE) {
-    return; // not a valid SBUS frame
-  }
-  if ((sbus[SBUS_FLAGS_IDX] & (1<<SBUS_FAILSAFE_BIT)) || (sbus[SBUS_FLAGS_IDX] & (1<<SBUS_FRAMELOST_BIT))) {
-    return; // SBUS invalid frame or failsafe mode
-  }
-
-  sbus++; // skip start byte
-
   uint32_t inputbitsavailable = 0;
   uint32_t inputbits = 0;
-  for (uint32_t i=0; i<MAX_TRAINER_CHANNELS; i++) {
+  for (uint32_t i=0; i<SBUS_CHANNELS; i++) {
     while (inputbitsavailable < SBUS_CH_BITS) {
-      inputbits |= *sbus++ << inputbitsavailable;
+      inputbits |= *payload++ << inputbitsavailable;
       inputbitsavailable += 8;
     }
     *pulses++ = ((int32_t) (inputbits & SBUS_CH_MASK) - SBUS_CH_CENTER) * 5 / 8;
     inputbitsavailable -= SBUS_CH_BITS;
     inputbits >>= SBUS_CH_BITS;
   }
+}
+
+// Each channel spans at most 3 bytes, it is extracted from a 32-bit little-endian
+// word read at its byte offset. The last word ends on the frame end byte, so
+// no read goes past the frame.
+void sbusUnpackChannels(const uint8_t * payload, int16_t * pulses)
+{
+  for (uint32_t i=0; i<SBUS_CHANNELS; i++) {
+    uint32_t bit = i * SBUS_CH_BITS;
+    const uint8_t * p = payload + (bit >> 3);
+    uint32_t word = p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+    pulses[i] = ((int32_t) ((word >> (bit & 7)) & SBUS_CH_MASK) - SBUS_CH_CENTER) * 5 / 8;
+  }
+}
+
+// Range for pulses (ppm input) is [-512:+512]
+void processSbusFrame(uint8_t * sbus, int16_t * pulses, uint32_t size)
+{
+  if (size != SBUS_FRAME_SIZE || sbus[0] != SBUS_START_BYTE || sbus[SBUS_FRAME_SIZE-1] != SBUS_END_BYTE) {
+    return; // not a valid SBUS frame
+  }
+  if ((sbus[SBUS_FLAGS_IDX] & (1<<SBUS_FAILSAFE_BIT)) || (sbus[SBUS_FLAGS_IDX] & (1<<SBUS_FRAMELOST_BIT))) {
+    return; // SBUS invalid frame or failsafe mode
+  }
 
+  sbusUnpackChannels(sbus + 1, pulses);
+  trainerPublishSnapshot(TRAINER_INPUT_SBUS, SBUS_CHANNELS);
   ppmInputValidityTimer = PPM_IN_VALID_TIMEOUT;
 }
 
@@ -85,7 +101,7 @@ void processSbusInput()
   else {
     if (SbusIndex) {
       if ((uint16_t) (getTmr2MHz() - SbusTimer) > SBUS_FRAME_GAP_DELAY) {
-        processSbusFrame(SbusFrame, ppmInput, SbusIndex);
+        processSbusFrame(SbusFrame, trainerBeginSnapshot(), SbusIndex);
         SbusIndex = 0;
       }
     }
@@ -23,7 +23,12 @@
 
 #define SBUS_BAUDRATE         100000
 #define SBUS_FRAME_SIZE       25
+#define SBUS_CHANNELS         16
+#define SBUS_CH_BITS          11
 
+void sbusUnpackChannels(const uint8_t * payload, int16_t * pulses);
+void sbusUnpackChannelsBitwise(const uint8_t * payload, int16_t * pulses);
+void processSbusFrame(uint8_t * sbus, int16_t * pulses, uint32_t size);
 void processSbusInput();
 
 #endif // _SBUS_H_
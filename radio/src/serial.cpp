@@ -20,25 +20,43 @@
 
 #include "opentx.h"
 #include "serial.h"
+#if defined(CLI)
+#include "cli_stream.h"
+#endif
 #include <stdarg.h>
 #include <stdio.h>
 
 #define PRINTF_BUFFER_SIZE    128
 
 void serialPutc(char c) {
+  serialWrite((const uint8_t *)&c, 1);
+}
+
+// Only to the USB serial, returns the number of bytes it took (what fits in its buffer)
+uint32_t serialWriteUsb(const uint8_t * data, uint32_t len)
+{
 #if !defined(BOOT)
   if (getSelectedUsbMode() == USB_SERIAL_MODE)
   {
 #if defined(PCBFLYSKY)
       if (!isFlySkyUsbDownload())
 #endif
-      usbSerialPutc(c);
+      return usbSerialWrite(data, len);
   }
 #endif
+  return len;
+}
+
+// The AUX serial always gets all the bytes, returns the number of bytes the USB serial took
+uint32_t serialWrite(const uint8_t * data, uint32_t len)
+{
 #if defined(AUX_SERIAL)
-  if (auxSerialTracesEnabled())
-    auxSerialPutc(c);
+  if (auxSerialTracesEnabled()) {
+    for (uint32_t i = 0; i < len; i++)
+      auxSerialPutc(data[i]);
+  }
 #endif
+  return serialWriteUsb(data, len);
 }
 
 void serialPrintf(const char * format, ...)
@@ -52,15 +70,21 @@ void serialPrintf(const char * format, ...)
   tmp[PRINTF_BUFFER_SIZE] = '\0';
   va_end(arglist);
 
-  const char *t = tmp;
-  while (*t) {
-    serialPutc(*t++);
-  }
+#if defined(CLI) && !defined(BOOT)
+  if (cliStreamTracesEnabled)
+    cliStreamTrace(tmp, strlen(tmp));
+  else
+#endif
+  serialWrite((const uint8_t *)tmp, strlen(tmp));
   debugCounter1ms = 0;
 }
 
 void serialCrlf()
 {
-  serialPutc('\r');
-  serialPutc('\n');
+#if defined(CLI) && !defined(BOOT)
+  // the trace frames already split the lines
+  if (cliStreamTracesEnabled)
+    return;
+#endif
+  serialWrite((const uint8_t *)"\r\n", 2);
 }
@@ -21,11 +21,15 @@
 #ifndef _SERIAL_H_
 #define _SERIAL_H_
 
+#include <inttypes.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void serialPutc(char c);
+uint32_t serialWrite(const uint8_t * data, uint32_t len);
+uint32_t serialWriteUsb(const uint8_t * data, uint32_t len);
 void serialPrintf(const char *format, ...);
 void serialCrlf();
 
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include "opentx.h"
+
+ModelIdIndex modelIdIndex;
+
+static void getModuleIds(ModelData * model, uint8_t moduleIdx, ModelIdIndex::ModuleIds & ids)
+{
+  ModuleData & moduleData = model->moduleData[moduleIdx];
+  ids.type = moduleData.type;
+  if (moduleData.type == MODULE_TYPE_MULTIMODULE)
+    ids.rfProtocol = moduleData.getMultiProtocol();
+  else
+    ids.rfProtocol = (uint8_t)moduleData.rfProtocol & 0x0F;
+  ids.modelId = model->header.modelId[moduleIdx];
+}
+
+void ModelIdIndex::clear()
+{
+  entries.clear();
+  usages.clear();
+  dirty = true;
+}
+
+std::string ModelIdIndex::getEntryKey(const char * filename)
+{
+  // the filenames are compared on LEN_MODEL_FILENAME chars at most
+  size_t len = 0;
+  while (len < LEN_MODEL_FILENAME && filename[len])
+    len++;
+  return std::string(filename, len);
+}
+
+uint32_t ModelIdIndex::getUsageKey(uint8_t moduleIdx, const ModuleIds & ids)
+{
+  return (moduleIdx << 16) + (ids.type << 8) + ids.rfProtocol;
+}
+
+ModelIdIndex::Entry * ModelIdIndex::findEntry(const char * filename)
+{
+  auto it = entries.find(getEntryKey(filename));
+  return it != entries.end() ? &it->second : nullptr;
+}
+
+const ModelIdIndex::Entry * ModelIdIndex::find(const char * filename) const
+{
+  return const_cast<ModelIdIndex *>(this)->findEntry(filename);
+}
+
+const ModelIdIndex::Usage * ModelIdIndex::getUsage(uint8_t moduleIdx, const ModuleIds & ids) const
+{
+  auto it = usages.find(getUsageKey(moduleIdx, ids));
+  return it != usages.end() ? &it->second : nullptr;
+}
+
+void ModelIdIndex::account(const Entry & entry, int8_t delta)
+{
+  for (uint8_t i = 0; i < NUM_MODULES; i++) {
+    const ModuleIds & ids = entry.modules[i];
+    if (ids.type == MODULE_TYPE_NONE || ids.modelId >= MODELIDS_COUNT)
+      continue;
+    // a new usage is zero initialized
+    usages[getUsageKey(i, ids)].counts[ids.modelId] += delta;
+  }
+}
+
+void ModelIdIndex::add(const Entry & entry)
+{
+  auto result = entries.emplace(getEntryKey(entry.modelFilename), entry);
+  if (result.second) {
+    account(result.first->second, 1);
+    dirty = true;
+  }
+}
+
+void ModelIdIndex::update(const char * filename, ModelData * model)
+{
+  Entry entry;
+  memclear(&entry, sizeof(entry));
+  strncpy(entry.modelFilename, filename, LEN_MODEL_FILENAME);
+  for (uint8_t i = 0; i < NUM_MODULES; i++) {
+    getModuleIds(model, i, entry.modules[i]);
+  }
+
+  Entry * current = findEntry(filename);
+  if (!current) {
+    add(entry);
+  }
+  else if (memcmp(current->modules, entry.modules, sizeof(entry.modules))) {
+    account(*current, -1);
+    memcpy(current->modules, entry.modules, sizeof(entry.modules));
+    account(*current, 1);
+    dirty = true;
+  }
+}
+
+void ModelIdIndex::duplicate(const char * filename, const char * newFilename)
+{
+  const Entry * entry = find(filename);
+  if (entry && !find(newFilename)) {
+    Entry copy = *entry;
+    memclear(copy.modelFilename, sizeof(copy.modelFilename));
+    strncpy(copy.modelFilename, newFilename, LEN_MODEL_FILENAME);
+    add(copy);
+  }
+}
+
+void ModelIdIndex::remove(const char * filename)
+{
+  auto it = entries.find(getEntryKey(filename));
+  if (it != entries.end()) {
+    account(it->second, -1);
+    entries.erase(it);
+    dirty = true;
+  }
+}
+
+uint8_t ModelIdIndex::getOtherUsersCount(const char * filename, uint8_t moduleIdx) const
+{
+  const Entry * entry = find(filename);
+  if (!entry)
+    return 0;
+
+  const ModuleIds & ids = entry->modules[moduleIdx];
+  if (ids.type == MODULE_TYPE_NONE || ids.modelId >= MODELIDS_COUNT)
+    return 0;
+
+  const Usage * usage = getUsage(moduleIdx, ids);
+  return usage ? usage->counts[ids.modelId] - 1 : 0;
+}
+
+void ModelIdIndex::forEachOtherUser(const char * filename, uint8_t moduleIdx, const std::function<void(const char *)> & function) const
+{
+  const Entry * entry = find(filename);
+  if (!entry || !getOtherUsersCount(filename, moduleIdx))
+    return;
+
+  const ModuleIds & ids = entry->modules[moduleIdx];
+  for (auto & other : entries) {
+    if (&other.second != entry && !memcmp(&other.second.modules[moduleIdx], &ids, sizeof(ids)))
+      function(other.second.modelFilename);
+  }
+}
+
+uint8_t ModelIdIndex::findNextUnusedModelId(const char * filename, uint8_t moduleIdx, uint8_t maxId) const
+{
+  const Entry * entry = find(filename);
+  const Usage * usage = nullptr;
+  uint8_t modelId = 0;
+
+  if (entry) {
+    usage = getUsage(moduleIdx, entry->modules[moduleIdx]);
+    modelId = entry->modules[moduleIdx].modelId;
+  }
+
+  for (uint8_t id = 1; id <= maxId && id < MODELIDS_COUNT; id++) {
+    uint8_t count = usage ? usage->counts[id] : 0;
+    // the model itself does not count
+    if (entry && id == modelId && count > 0)
+      count--;
+    if (count == 0)
+      return id;
+  }
+
+  return 0;
+}
+
+// One line per model: "type:protocol:id" for each module, then the filename
+bool ModelIdIndex::load()
+{
+  FIL file;
+  char line[NUM_MODULES * 12 + LEN_MODEL_FILENAME + 2];
+
+  clear();
+
+  if (f_open(&file, RADIO_MODELIDS_PATH, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+    return false;
+
+  while (f_gets(line, sizeof(line), &file)) {
+    Entry entry;
+    memclear(&entry, sizeof(entry));
+
+    char * cur = line;
+    bool valid = true;
+    for (uint8_t i = 0; i < NUM_MODULES && valid; i++) {
+      ModuleIds & ids = entry.modules[i];
+      ids.type = strtol(cur, &cur, 10);
+      valid = (*cur++ == ':');
+      ids.rfProtocol = strtol(cur, &cur, 10);
+      valid = valid && (*cur++ == ':');
+      ids.modelId = strtol(cur, &cur, 10);
+      valid = valid && (*cur++ == ' ');
+    }
+
+    // strip the line ending
+    char * end = cur + strlen(cur);
+    while (end > cur && (end[-1] == '\r' || end[-1] == '\n'))
+      *--end = '\0';
+
+    if (valid && end > cur && end - cur <= LEN_MODEL_FILENAME) {
+      strncpy(entry.modelFilename, cur, LEN_MODEL_FILENAME);
+      add(entry);  // the first line of a model is kept
+    }
+  }
+
+  f_close(&file);
+  dirty = false;
+  return true;
+}
+
+void ModelIdIndex::save()
+{
+  FIL file;
+
+  if (!dirty)
+    return;
+
+  if (f_open(&file, RADIO_MODELIDS_PATH, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+    return;
+
+  for (auto & it : entries) {
+    const Entry & entry = it.second;
+    for (uint8_t i = 0; i < NUM_MODULES; i++) {
+      const ModuleIds & ids = entry.modules[i];
+      f_printf(&file, "%d:%d:%d ", ids.type, ids.rfProtocol, ids.modelId);
+    }
+    f_puts(entry.modelFilename, &file);
+    f_putc('\n', &file);
+  }
+
+  f_close(&file);
+  dirty = false;
+}
+
+void ModelIdIndex::rebuild()
+{
+  DIR dir;
+  FILINFO fno;
+
+  clear();
+
+  ModelData * model = (ModelData *)malloc(sizeof(ModelData));
+  if (!model)
+    return;
+
+  if (f_opendir(&dir, MODELS_PATH) == FR_OK) {
+    while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0] != '\0') {
+      if (fno.fattrib & (AM_DIR | AM_HID | AM_SYS))
+        continue;
+      if (strlen(fno.fname) > LEN_MODEL_FILENAME)
+        continue;
+      const char * ext = getFileExtension(fno.fname);
+      if (!ext || strcasecmp(ext, MODELS_EXT))
+        continue;
+      // older model files may be shorter than ModelData
+      memclear(model, sizeof(ModelData));
+      if (readModel(fno.fname, (uint8_t *)model, sizeof(ModelData)) == nullptr)
+        update(fno.fname, model);
+    }
+    f_closedir(&dir);
+  }
+
+  free(model);
+  save();
+}
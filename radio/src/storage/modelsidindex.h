@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#ifndef _MODELSIDINDEX_H_
+#define _MODELSIDINDEX_H_
+
+#include <map>
+#include <string>
+#include <functional>
+
+#define MODELIDS_COUNT                 64 // receiver numbers are 0..63
+
+// Receiver numbers (model ID) of all models, with the module type and RF
+// protocol they are used with. It is kept in RADIO_MODELIDS_PATH so that
+// uniqueness checks and free number lookups never open the model files.
+// Lookups are O(log n): the models are sorted by filename and the receiver
+// numbers usage by module, type and protocol.
+class ModelIdIndex
+{
+  public:
+    struct ModuleIds {
+      uint8_t type;
+      uint8_t rfProtocol;
+      uint8_t modelId;
+    };
+
+    struct Entry {
+      char modelFilename[LEN_MODEL_FILENAME+1];
+      ModuleIds modules[NUM_MODULES];
+    };
+
+    void clear();
+
+    bool load();
+
+    void save();
+
+    void rebuild();
+
+    const Entry * find(const char * filename) const;
+
+    void update(const char * filename, ModelData * model);
+
+    void duplicate(const char * filename, const char * newFilename);
+
+    void remove(const char * filename);
+
+    // number of other models using the same receiver number on this module
+    uint8_t getOtherUsersCount(const char * filename, uint8_t moduleIdx) const;
+
+    void forEachOtherUser(const char * filename, uint8_t moduleIdx, const std::function<void(const char *)> & function) const;
+
+    // 0 if all receiver numbers up to maxId are used
+    uint8_t findNextUnusedModelId(const char * filename, uint8_t moduleIdx, uint8_t maxId) const;
+
+  protected:
+    // how many models use each receiver number, per module, type and protocol
+    struct Usage {
+      uint8_t counts[MODELIDS_COUNT];
+    };
+
+    std::map<std::string, Entry> entries;  // by model filename
+    std::map<uint32_t, Usage> usages;      // by getUsageKey()
+    bool dirty = false;
+
+    static std::string getEntryKey(const char * filename);
+    static uint32_t getUsageKey(uint8_t moduleIdx, const ModuleIds & ids);
+
+    Entry * findEntry(const char * filename);
+    const Usage * getUsage(uint8_t moduleIdx, const ModuleIds & ids) const;
+    void account(const Entry & entry, int8_t delta);
+    void add(const Entry & entry);
+};
+
+extern ModelIdIndex modelIdIndex;
+
+#endif // _MODELSIDINDEX_H_
@@ -301,6 +301,10 @@ class ModelsList
 
     void removeCategory(ModelsCategory * category)
     {
+      for (auto model : *category) {
+        modelIdIndex.remove(model->modelFilename);
+      }
+      modelIdIndex.save();
       modelsCount -= category->size();
       delete category;
       categories.remove(category);
@@ -308,6 +312,8 @@ class ModelsList
 
     void removeModel(ModelsCategory * category, ModelCell * model)
     {
+      modelIdIndex.remove(model->modelFilename);
+      modelIdIndex.save();
       category->removeModel(model);
       modelsCount--;
       save();
@@ -41,21 +41,129 @@ RamBackup * ramBackup = &_ramBackup;
 RamBackup * ramBackup = (RamBackup *)BKPSRAM_BASE;
 #endif
 
+// The backup is split in chunks compressed independently, so that only the
+// chunks which changed are recompressed and written. The backup data starts
+// with the compressed size of each chunk, followed by the chunks.
+// Model and radio chunks are aligned on the start of their structure.
+#define RAMBACKUP_CHUNK_SIZE     256
+#define RAMBACKUP_CHUNKS_COUNT(size) (((size) + RAMBACKUP_CHUNK_SIZE - 1) / RAMBACKUP_CHUNK_SIZE)
+#define RAMBACKUP_MODEL_CHUNKS   RAMBACKUP_CHUNKS_COUNT(sizeof(Backup::ModelData))
+#define RAMBACKUP_CHUNKS         (RAMBACKUP_MODEL_CHUNKS + RAMBACKUP_CHUNKS_COUNT(sizeof(Backup::RadioData)))
+#define RAMBACKUP_HEADER_SIZE    (RAMBACKUP_CHUNKS * sizeof(uint16_t))
+// RLC worst case is one byte added every 15 bytes
+#define RAMBACKUP_BUFFER_SIZE    (RAMBACKUP_CHUNK_SIZE + RAMBACKUP_CHUNK_SIZE / 8)
+
+RamBackupStats rambackupStats;
+static uint8_t rambackupBuffer[RAMBACKUP_BUFFER_SIZE];
+
+static inline uint16_t * getChunkSizes()
+{
+  return (uint16_t *)ramBackup->data;
+}
+
+static void getChunk(unsigned int index, uint8_t * & data, unsigned int & size)
+{
+  if (index < RAMBACKUP_MODEL_CHUNKS) {
+    unsigned int offset = index * RAMBACKUP_CHUNK_SIZE;
+    data = (uint8_t *)&ramBackupUncompressed.model + offset;
+    size = min<unsigned int>(RAMBACKUP_CHUNK_SIZE, sizeof(Backup::ModelData) - offset);
+  }
+  else {
+    unsigned int offset = (index - RAMBACKUP_MODEL_CHUNKS) * RAMBACKUP_CHUNK_SIZE;
+    data = (uint8_t *)&ramBackupUncompressed.radio + offset;
+    size = min<unsigned int>(RAMBACKUP_CHUNK_SIZE, sizeof(Backup::RadioData) - offset);
+  }
+}
+
+static bool isBackupValid()
+{
+  if (ramBackup->size < RAMBACKUP_HEADER_SIZE || ramBackup->size > sizeof(ramBackup->data))
+    return false;
+
+  uint16_t * chunkSizes = getChunkSizes();
+  unsigned int total = RAMBACKUP_HEADER_SIZE;
+  for (unsigned int i=0; i<RAMBACKUP_CHUNKS; i++) {
+    if (chunkSizes[i] == 0)
+      return false;
+    total += chunkSizes[i];
+  }
+  return total == ramBackup->size;
+}
+
+static bool isChunkUnchanged(const uint8_t * data, unsigned int size, const uint8_t * chunk, unsigned int chunkSize)
+{
+  return uncompress(rambackupBuffer, sizeof(rambackupBuffer), chunk, chunkSize) == size && !memcmp(rambackupBuffer, data, size);
+}
+
 void rambackupWrite()
 {
+  uint16_t t0 = getTmr2MHz();
+
   copyRadioData(&ramBackupUncompressed.radio, &g_eeGeneral);
   copyModelData(&ramBackupUncompressed.model, &g_model);
-  ramBackup->size = compress(ramBackup->data, 4094, (const uint8_t *)&ramBackupUncompressed, sizeof(ramBackupUncompressed));
-  TRACE("RamBackupWrite sdsize=%d backupsize=%d rlcsize=%d", sizeof(ModelData)+sizeof(RadioData), sizeof(Backup::RamBackupUncompressed), ramBackup->size);
+
+  rambackupStats.chunksWritten = 0;
+  rambackupStats.bytesWritten = 0;
+
+  uint16_t * chunkSizes = getChunkSizes();
+  unsigned int used = ramBackup->size;
+  if (!isBackupValid()) {
+    // all chunks will be written
+    memclear(chunkSizes, RAMBACKUP_HEADER_SIZE);
+    used = RAMBACKUP_HEADER_SIZE;
+  }
+
+  // the backup is invalid until all chunks are written
+  ramBackup->size = 0;
+
+  unsigned int offset = RAMBACKUP_HEADER_SIZE;
+  for (unsigned int i=0; i<RAMBACKUP_CHUNKS; i++) {
+    uint8_t * data;
+    unsigned int size;
+    getChunk(i, data, size);
+    unsigned int oldSize = chunkSizes[i];
+
+    if (oldSize == 0 || !isChunkUnchanged(data, size, &ramBackup->data[offset], oldSize)) {
+      unsigned int newSize = compress(rambackupBuffer, sizeof(rambackupBuffer), data, size);
+      if (newSize == 0 || used - oldSize + newSize > sizeof(ramBackup->data)) {
+        TRACE("RamBackupWrite error chunk=%d", i);
+        return;
+      }
+      if (newSize != oldSize) {
+        // move the next chunks
+        memmove(&ramBackup->data[offset + newSize], &ramBackup->data[offset + oldSize], used - offset - oldSize);
+        rambackupStats.bytesWritten += used - offset - oldSize;
+        used = used - oldSize + newSize;
+        chunkSizes[i] = newSize;
+      }
+      memcpy(&ramBackup->data[offset], rambackupBuffer, newSize);
+      rambackupStats.chunksWritten++;
+      rambackupStats.bytesWritten += newSize;
+    }
+
+    offset += chunkSizes[i];
+  }
+
+  ramBackup->size = used;
+  rambackupStats.duration = (uint16_t)(getTmr2MHz() - t0) / 2;
+  TRACE("RamBackupWrite sdsize=%d backupsize=%d rlcsize=%d chunks=%d written=%d time=%dus", sizeof(ModelData)+sizeof(RadioData), sizeof(Backup::RamBackupUncompressed), ramBackup->size, rambackupStats.chunksWritten, rambackupStats.bytesWritten, rambackupStats.duration);
 }
 
 bool rambackupRestore()
 {
-  if (ramBackup->size == 0)
+  if (!isBackupValid())
     return false;
 
-  if (uncompress((uint8_t *)&ramBackupUncompressed, sizeof(ramBackupUncompressed), ramBackup->data, ramBackup->size) != sizeof(ramBackupUncompressed))
-    return false;
+  uint16_t * chunkSizes = getChunkSizes();
+  unsigned int offset = RAMBACKUP_HEADER_SIZE;
+  for (unsigned int i=0; i<RAMBACKUP_CHUNKS; i++) {
+    uint8_t * data;
+    unsigned int size;
+    getChunk(i, data, size);
+    if (uncompress(data, size, &ramBackup->data[offset], chunkSizes[i]) != size)
+      return false;
+    offset += chunkSizes[i];
+  }
 
   memset(&g_eeGeneral, 0, sizeof(g_eeGeneral));
   memset(&g_model, 0, sizeof(g_model));
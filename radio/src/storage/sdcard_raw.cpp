@@ -19,6 +19,26 @@
  */
 
 #include "opentx.h"
+#include "crc.h"
+
+#define FILE_HEADER_SIZE         8
+#define TMP_FILE_EXT             ".tmp"
+
+// The model file is compared with the last written image by blocks of one
+// SD sector, a single changed block is written in place
+#define MODEL_BLOCK_SIZE         512
+#define MODEL_FILE_SIZE          (FILE_HEADER_SIZE + sizeof(ModelData))
+#define MODEL_BLOCKS_COUNT       ((MODEL_FILE_SIZE + MODEL_BLOCK_SIZE - 1) / MODEL_BLOCK_SIZE)
+
+struct ModelShadow {
+  bool valid;
+  char filename[LEN_MODEL_FILENAME+1];
+  WORD fdate;                   // timestamp after our last write, to detect changes made from USB
+  WORD ftime;
+  uint32_t crc[MODEL_BLOCKS_COUNT];
+};
+
+static ModelShadow modelShadow;
 
 void getModelPath(char * path, const char * filename)
 {
@@ -27,26 +47,42 @@ void getModelPath(char * path, const char * filename)
   strcpy(&path[sizeof(MODELS_PATH)], filename);
 }
 
+static void getTmpFilePath(char * path, const char * filename)
+{
+  strcpy(path, filename);
+  strcat(path, TMP_FILE_EXT);
+}
+
+static void getFileHeader(uint8_t * buf, uint16_t size)
+{
+  *(uint32_t*)&buf[0] = OTX_FOURCC;
+  buf[4] = EEPROM_VER;
+  buf[5] = 'M';
+  *(uint16_t*)&buf[6] = size;
+}
+
+// Writes the file under a temporary name, then replaces the previous one, so
+// that a power loss never leaves a truncated file behind
 const char * writeFile(const char * filename, const uint8_t * data, uint16_t size)
 {
   TRACE("writeFile(%s)", filename);
-  
+
   FIL file;
-  unsigned char buf[8];
+  uint8_t buf[FILE_HEADER_SIZE];
+  char tmpPath[256];
   UINT written;
 
-  FRESULT result = f_open(&file, filename, FA_CREATE_ALWAYS | FA_WRITE);
+  getTmpFilePath(tmpPath, filename);
+
+  FRESULT result = f_open(&file, tmpPath, FA_CREATE_ALWAYS | FA_WRITE);
   if (result != FR_OK) {
     return SDCARD_ERROR(result);
   }
 
-  *(uint32_t*)&buf[0] = OTX_FOURCC;
-  buf[4] = EEPROM_VER;
-  buf[5] = 'M';
-  *(uint16_t*)&buf[6] = size;
+  getFileHeader(buf, size);
 
-  result = f_write(&file, buf, 8, &written);
-  if (result != FR_OK || written != 8) {
+  result = f_write(&file, buf, FILE_HEADER_SIZE, &written);
+  if (result != FR_OK || written != FILE_HEADER_SIZE) {
     f_close(&file);
     return SDCARD_ERROR(result);
   }
@@ -57,15 +93,161 @@ const char * writeFile(const char * filename, const uint8_t * data, uint16_t siz
     return SDCARD_ERROR(result);
   }
 
-  f_close(&file);
+  result = f_close(&file);
+  if (result != FR_OK) {
+    return SDCARD_ERROR(result);
+  }
+
+  result = f_unlink(filename);
+  if (result != FR_OK && result != FR_NO_FILE) {
+    return SDCARD_ERROR(result);
+  }
+
+  // a power loss here leaves only the temporary file, see recoverFile()
+  result = f_rename(tmpPath, filename);
+  if (result != FR_OK) {
+    return SDCARD_ERROR(result);
+  }
+
   return NULL;
 }
 
+// Completes a writeFile() interrupted between the unlink and the rename
+static void recoverFile(const char * filename)
+{
+  FILINFO info;
+  if (f_stat(filename, &info) == FR_NO_FILE) {
+    char tmpPath[256];
+    getTmpFilePath(tmpPath, filename);
+    if (f_stat(tmpPath, &info) == FR_OK) {
+      TRACE("recoverFile(%s)", filename);
+      f_rename(tmpPath, filename);
+    }
+  }
+}
+
+static uint32_t getModelBlockCrc(const uint8_t * header, uint32_t block)
+{
+  const uint8_t * data = (const uint8_t *)&g_model;
+  uint32_t start = block * MODEL_BLOCK_SIZE;
+  uint32_t end = min<uint32_t>(start + MODEL_BLOCK_SIZE, MODEL_FILE_SIZE);
+  uint16_t crc1 = 0, crc2 = 0;
+
+  if (start < FILE_HEADER_SIZE) {
+    crc1 = crc16(CRC_1021, header + start, FILE_HEADER_SIZE - start);
+    crc2 = crc16(CRC_1189, header + start, FILE_HEADER_SIZE - start);
+    start = FILE_HEADER_SIZE;
+  }
+
+  // two polynomials so that a changed block is not missed on a 16 bits collision
+  crc1 = crc16(CRC_1021, data + start - FILE_HEADER_SIZE, end - start, crc1);
+  crc2 = crc16(CRC_1189, data + start - FILE_HEADER_SIZE, end - start, crc2);
+  return ((uint32_t)crc1 << 16) + crc2;
+}
+
+static bool getModelFileStamp(const char * path, WORD & fdate, WORD & ftime)
+{
+  FILINFO info;
+  if (f_stat(path, &info) != FR_OK || info.fsize != MODEL_FILE_SIZE) {
+    return false;
+  }
+  fdate = info.fdate;
+  ftime = info.ftime;
+  return true;
+}
+
+static bool isModelShadowValid(const char * path)
+{
+  WORD fdate, ftime;
+  return modelShadow.valid &&
+         !strncmp(modelShadow.filename, g_eeGeneral.currModelFilename, LEN_MODEL_FILENAME) &&
+         getModelFileStamp(path, fdate, ftime) &&
+         fdate == modelShadow.fdate && ftime == modelShadow.ftime;
+}
+
+// Sector sized and aligned, so the SD card updates it in one write
+static const char * writeModelBlock(const char * path, const uint8_t * header, uint32_t block)
+{
+  TRACE("writeModelBlock(%s, %d)", path, block);
+
+  FIL file;
+  UINT written;
+  uint32_t start = block * MODEL_BLOCK_SIZE;
+  uint32_t end = min<uint32_t>(start + MODEL_BLOCK_SIZE, MODEL_FILE_SIZE);
+
+  FRESULT result = f_open(&file, path, FA_OPEN_EXISTING | FA_WRITE);
+  if (result != FR_OK) {
+    return SDCARD_ERROR(result);
+  }
+
+  result = f_lseek(&file, start);
+  if (result == FR_OK && start < FILE_HEADER_SIZE) {
+    result = f_write(&file, header + start, FILE_HEADER_SIZE - start, &written);
+    if (result == FR_OK && written != FILE_HEADER_SIZE - start) {
+      result = FR_DISK_ERR;
+    }
+    start = FILE_HEADER_SIZE;
+  }
+
+  if (result == FR_OK) {
+    result = f_write(&file, (const uint8_t *)&g_model + start - FILE_HEADER_SIZE, end - start, &written);
+    if (result == FR_OK && written != end - start) {
+      result = FR_DISK_ERR;
+    }
+  }
+
+  FRESULT closeResult = f_close(&file);
+  if (result == FR_OK) {
+    result = closeResult;
+  }
+
+  return result == FR_OK ? NULL : SDCARD_ERROR(result);
+}
+
 const char * writeModel()
 {
   char path[256];
   getModelPath(path, g_eeGeneral.currModelFilename);
-  return writeFile(path, (uint8_t *)&g_model, sizeof(g_model));
+
+  uint8_t header[FILE_HEADER_SIZE];
+  getFileHeader(header, sizeof(g_model));
+
+  uint32_t crc[MODEL_BLOCKS_COUNT];
+  uint8_t changedBlocks = 0;
+  uint32_t lastChangedBlock = 0;
+  for (uint32_t i=0; i<MODEL_BLOCKS_COUNT; i++) {
+    crc[i] = getModelBlockCrc(header, i);
+    if (crc[i] != modelShadow.crc[i]) {
+      changedBlocks++;
+      lastChangedBlock = i;
+    }
+  }
+
+  const char * error = NULL;
+  bool shadowValid = isModelShadowValid(path);
+  if (shadowValid && changedBlocks == 0) {
+    return NULL;
+  }
+  else if (shadowValid && changedBlocks == 1) {
+    error = writeModelBlock(path, header, lastChangedBlock);
+  }
+  else {
+    // several blocks changed, a torn write could mix two versions of the model
+    error = writeFile(path, (uint8_t *)&g_model, sizeof(g_model));
+  }
+
+  modelShadow.valid = (error == NULL && getModelFileStamp(path, modelShadow.fdate, modelShadow.ftime));
+  if (modelShadow.valid) {
+    memcpy(modelShadow.filename, g_eeGeneral.currModelFilename, sizeof(modelShadow.filename));
+    memcpy(modelShadow.crc, crc, sizeof(crc));
+  }
+
+  if (error == NULL) {
+    modelIdIndex.update(g_eeGeneral.currModelFilename, &g_model);
+    modelIdIndex.save();
+  }
+
+  return error;
 }
 
 const char * loadFile(const char * filename, uint8_t * data, uint16_t maxsize)
@@ -76,6 +258,8 @@ const char * loadFile(const char * filename, uint8_t * data, uint16_t maxsize)
   char buf[8];
   UINT read;
 
+  recoverFile(filename);
+
   FRESULT result = f_open(&file, filename, FA_OPEN_EXISTING | FA_READ);
   if (result != FR_OK) {
     return SDCARD_ERROR(result);
@@ -120,10 +304,18 @@ const char * loadModel(const char * filename, bool alarms)
 {
   preModelLoad();
 
+  // the next write will be a full one
+  modelShadow.valid = false;
+
   const char * error = readModel(filename, (uint8_t *)&g_model, sizeof(g_model));
   if (error) {
     TRACE("loadModel error=%s", error);
   }
+  else {
+    // the file may have been changed outside of the radio
+    modelIdIndex.update(filename, &g_model);
+    modelIdIndex.save();
+  }
   
   if (error) {
     modelDefault(0) ;
@@ -189,6 +381,10 @@ void storageReadAll()
   }
 #endif
 
+  if (!modelIdIndex.load()) {
+    modelIdIndex.rebuild();
+  }
+
   if (loadModel(g_eeGeneral.currModelFilename, false) != NULL) {
     sdCheckAndCreateDirectory(MODELS_PATH);
     createModel();
@@ -224,6 +420,8 @@ const char * createModel()
   int index = findNextFileIndex(filename, LEN_MODEL_FILENAME, MODELS_PATH);
   if (index > 0) {
     modelDefault(index);
+    modelIdIndex.update(filename, &g_model);
+    g_model.header.modelId[INTERNAL_MODULE] = modelIdIndex.findNextUnusedModelId(filename, INTERNAL_MODULE, MAX_RX_NUM(INTERNAL_MODULE));
     memcpy(g_eeGeneral.currModelFilename, filename, sizeof(g_eeGeneral.currModelFilename));
     storageDirty(EE_GENERAL);
     storageDirty(EE_MODEL);
@@ -257,6 +455,8 @@ void storageEraseModels()
       f_unlink(fullFileName);
     }
   }
+  modelIdIndex.clear();
+  modelIdIndex.save();
 }
 void storageEraseAll(bool warn)
 {
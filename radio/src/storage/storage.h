@@ -63,9 +63,17 @@ void postModelLoad(bool alarms);
 #include "eeprom_raw.h"
 #elif defined(SDCARD)
 #include "sdcard_raw.h"
+#include "modelsidindex.h"
 #endif
 
 #if defined(RAMBACKUP)
+struct RamBackupStats {
+  uint16_t chunksWritten;
+  uint16_t bytesWritten;        // compressed bytes written and moved in the backup RAM
+  uint16_t duration;            // us
+};
+extern RamBackupStats rambackupStats;
+
 void rambackupWrite();
 bool rambackupRestore();
 unsigned int compress(uint8_t * dst, unsigned int dstsize, const uint8_t * src, unsigned int len);
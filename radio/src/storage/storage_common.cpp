@@ -34,6 +34,12 @@ void storageDirty(uint8_t msk)
   storageDirtyMsk |= msk;
   storageDirtyTime10ms = get_tmr10ms();
 
+#if defined(GVARS) && !defined(PCBSTD)
+  if (msk & EE_MODEL) {
+    invalidateGVarsCache();
+  }
+#endif
+
 #if defined(RAMBACKUP)
   rambackupDirtyMsk = storageDirtyMsk;
   rambackupDirtyTime10ms = storageDirtyTime10ms;
@@ -79,6 +85,10 @@ static void fixUpModel()
 
 void postModelLoad(bool alarms)
 {
+#if defined(GVARS) && !defined(PCBSTD)
+  invalidateGVarsCache();
+#endif
+
 #if defined(PXX2)
   if (is_memclear(g_model.modelRegistrationID, PXX2_LEN_REGISTRATION_ID)) {
     memcpy(g_model.modelRegistrationID, g_eeGeneral.ownerRegistrationID, PXX2_LEN_REGISTRATION_ID);
@@ -121,7 +131,7 @@ if (!isExternalModuleAvailable(g_model.moduleData[EXTERNAL_MODULE].type)) {
   for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
     TelemetrySensor & sensor = g_model.telemetrySensors[i];
     if (sensor.type == TELEM_TYPE_CALCULATED && sensor.persistent) {
-      telemetryItems[i].value = sensor.persistentValue;
+      telemetryItems[i].storeValue(sensor.persistentValue);
       telemetryItems[i].lastReceived = TELEMETRY_VALUE_OLD;   // #3595: make value visible even before the first new value is received)
     }
   }
@@ -131,6 +131,12 @@ void intmoduleSerialStart(uint32_t baudrate, uint8_t rxEnable, uint16_t parity,
   USART_DMACmd(INTMODULE_USART, USART_DMAReq_Rx, ENABLE);
   USART_ITConfig(INTMODULE_USART, USART_IT_RXNE, DISABLE);
   USART_ITConfig(INTMODULE_USART, USART_IT_TXE, DISABLE);
+#if defined(INTMODULE_USART_IRQHandler)
+  // the idle line interrupt wakes the telemetry task at the end of each frame
+  USART_ITConfig(INTMODULE_USART, USART_IT_IDLE, ENABLE);
+  NVIC_SetPriority(INTMODULE_USART_IRQn, 7);
+  NVIC_EnableIRQ(INTMODULE_USART_IRQn);
+#endif
   USART_Cmd(INTMODULE_USART, ENABLE);
   DMA_Cmd(INTMODULE_RX_DMA_STREAM, ENABLE); // TRACE("RF DMA receive started...");
  #endif
@@ -147,13 +153,21 @@ extern "C" void INTMODULE_USART_IRQHandler(void)
 
   // Receive
   uint32_t status = INTMODULE_USART->SR;
+#ifdef INTMODULE_RX_INT
   while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
     uint8_t data = INTMODULE_USART->DR;
     if (!(status & USART_FLAG_ERRORS)) {
       intmoduleRxFifo.push(data);
+      telemetryRxNotify(data);
     }
     status = INTMODULE_USART->SR;
   }
+#else
+  if (status & USART_FLAG_IDLE) {
+    (void)INTMODULE_USART->DR;  // clears the flag, the data is read by the DMA
+    telemetryRxIdleNotify();
+  }
+#endif
 }
 
 extern "C" void INTMODULE_TX_DMA_Stream_IRQHandler(void)
@@ -48,6 +48,7 @@ int getSelectedUsbMode();
 void setSelectedUsbMode(int mode);
 
 void usbSerialPutc(uint8_t c);
+uint32_t usbSerialWrite(const uint8_t * data, uint32_t len);
 
 // Used in view_statistics.cpp
 #if defined(DEBUG) && !defined(BOOT)
@@ -192,6 +192,36 @@ void usbSerialPutc(uint8_t c)
   if (!prim) __enable_irq();
 }
 
+// Copies what fits of data in the IN buffer at once, returns the number of bytes copied
+uint32_t usbSerialWrite(const uint8_t * data, uint32_t len)
+{
+  if (!cdcConnected) return 0;
+
+  uint32_t prim = __get_PRIMASK();
+  __disable_irq();
+  uint32_t txDataLen = APP_RX_DATA_SIZE + APP_Rx_ptr_in - APP_Rx_ptr_out;
+  if (txDataLen >= APP_RX_DATA_SIZE) {
+    txDataLen -= APP_RX_DATA_SIZE;
+  }
+  // same margin as usbSerialPutc()
+  uint32_t count = 0;
+  if (txDataLen < APP_RX_DATA_SIZE - CDC_DATA_MAX_PACKET_SIZE) {
+    count = min<uint32_t>(len, APP_RX_DATA_SIZE - CDC_DATA_MAX_PACKET_SIZE - txDataLen);
+    uint32_t first = min<uint32_t>(count, APP_RX_DATA_SIZE - APP_Rx_ptr_in);
+    memcpy(&APP_Rx_Buffer[APP_Rx_ptr_in], data, first);
+    memcpy(APP_Rx_Buffer, data + first, count - first);
+    APP_Rx_ptr_in += count;
+    if (APP_Rx_ptr_in >= APP_RX_DATA_SIZE) {
+      APP_Rx_ptr_in -= APP_RX_DATA_SIZE;
+      ++usbWraps;
+    }
+  }
+  if (!prim) __enable_irq();
+
+  charsWritten += count;
+  return count;
+}
+
 /**
   * @brief  VCP_DataRx
   *         Data received over USB OUT endpoint is available here
@@ -56,14 +56,21 @@ void firmwareTraceCb(const char * text)
   }
 }
 
+#define OUTPUTS_BUFFER_INDEX   0x03
+#define OUTPUTS_BUFFER_DIRTY   0x04
+
 OpenTxSimulator::OpenTxSimulator() :
   SimulatorInterface(),
   m_timer10ms(NULL),
+  m_outputsShared(1),
+  m_outputsBack(0),
+  m_outputsFront(2),
   m_resetOutputsData(true),
   m_stopRequested(false)
 {
   tracebackDevices.clear();
   traceCallback = firmwareTraceCb;
+  m_pendingChanges.clear();
 }
 
 OpenTxSimulator::~OpenTxSimulator()
@@ -218,8 +225,12 @@ void OpenTxSimulator::setTrim(unsigned int idx, int value)
     QTimer *timer = new QTimer(this);
     timer->setSingleShot(true);
     connect(timer, &QTimer::timeout, [=]() {
-      emit trimValueChange(idx, 0);
-      emit outputValueChange(OUTPUT_SRC_TRIM_VALUE, idx, 0);
+      // the trim is disabled, move the GUI back to 0, the next tick republishes the actual value if any
+      TxOutputsDelta::Changes changes;
+      changes.clear();
+      changes.trims = (quint32)1 << idx;
+      m_lastOutputs.trims[idx] = 0;
+      publishOutputs(changes);
       timer->deleteLater();
     });
     timer->start(350);
@@ -233,8 +244,11 @@ void OpenTxSimulator::setTrainerInput(unsigned int inputNumber, int16_t value)
 {
   static unsigned dim = DIM(ppmInput);
   //setTrainerTimeout(100);
-  if (inputNumber < dim)
-    ppmInput[inputNumber] = qMin(qMax((int16_t)-512, value), (int16_t)512);
+  if (inputNumber < dim) {
+    int16_t * channels = trainerBeginSnapshot();
+    channels[inputNumber] = qMin(qMax((int16_t)-512, value), (int16_t)512);
+    trainerPublishSnapshot(TRAINER_INPUT_SIMU, dim);
+  }
 }
 
 void OpenTxSimulator::setInputValue(int type, uint8_t index, int16_t value)
@@ -500,30 +514,28 @@ bool OpenTxSimulator::checkLcdChanged()
 
 void OpenTxSimulator::checkOutputsChanged()
 {
-  static TxOutputs lastOutputs;
-  static size_t chansDim = DIM(channelOutputs);
-  const static int16_t limit = 512 * 2;
+  static size_t chansDim = std::min<size_t>(DIM(channelOutputs), CPN_MAX_CHNOUT);
+  TxOutputsDelta::Changes changes;
   qint32 tmpVal;
   uint8_t i, idx;
   const uint8_t phase = getFlightMode();  // opentx.cpp
   const uint8_t mode = getStickMode();
 
+  changes.clear();
+
   for (i=0; i < chansDim; i++) {
-    if (lastOutputs.chans[i] != channelOutputs[i] || m_resetOutputsData) {
-      emit channelOutValueChange(i, channelOutputs[i], (g_model.extendedLimits ? limit * LIMIT_EXT_PERCENT / 100 : limit));
-      emit channelMixValueChange(i, ex_chans[i], limit * 2);
-      emit outputValueChange(OUTPUT_SRC_CHAN_OUT, i, channelOutputs[i]);
-      emit outputValueChange(OUTPUT_SRC_CHAN_MIX, i, ex_chans[i]);
-      lastOutputs.chans[i] = channelOutputs[i];
+    if (m_lastOutputs.chans[i] != channelOutputs[i] || m_lastOutputs.ex_chans[i] != ex_chans[i] || m_resetOutputsData) {
+      m_lastOutputs.chans[i] = channelOutputs[i];
+      m_lastOutputs.ex_chans[i] = ex_chans[i];
+      changes.chans |= (quint32)1 << i;
     }
   }
 
   for (i=0; i < MAX_LOGICAL_SWITCHES; i++) {
     tmpVal = (qint32)GET_SWITCH_BOOL(SWSRC_SW1+i);
-    if (lastOutputs.vsw[i] != (bool)tmpVal || m_resetOutputsData) {
-      emit virtualSwValueChange(i, tmpVal);
-      emit outputValueChange(OUTPUT_SRC_VIRTUAL_SW, i, tmpVal);
-      lastOutputs.vsw[i] = tmpVal;
+    if (m_lastOutputs.vsw[i] != (bool)tmpVal || m_resetOutputsData) {
+      m_lastOutputs.vsw[i] = tmpVal;
+      changes.vsw |= (quint64)1 << i;
     }
   }
 
@@ -534,24 +546,21 @@ void OpenTxSimulator::checkOutputsChanged()
       idx = i;
 
     tmpVal = getTrimValue(getTrimFlightMode(phase, idx), idx);
-    if (lastOutputs.trims[i] != tmpVal || m_resetOutputsData) {
-      emit trimValueChange(i, tmpVal);
-      emit outputValueChange(OUTPUT_SRC_TRIM_VALUE, i, tmpVal);
-      lastOutputs.trims[i] = tmpVal;
+    if (m_lastOutputs.trims[i] != tmpVal || m_resetOutputsData) {
+      m_lastOutputs.trims[i] = tmpVal;
+      changes.trims |= (quint32)1 << i;
     }
   }
 
   tmpVal = g_model.extendedTrims ? TRIM_EXTENDED_MAX : TRIM_MAX;
-  if (lastOutputs.trimRange != tmpVal || m_resetOutputsData) {
-    emit trimRangeChange(Board::TRIM_AXIS_COUNT, -tmpVal, tmpVal);
-    emit outputValueChange(OUTPUT_SRC_TRIM_RANGE, Board::TRIM_AXIS_COUNT, tmpVal);
-    lastOutputs.trimRange = tmpVal;
+  if (m_lastOutputs.trimRange != tmpVal || m_resetOutputsData) {
+    m_lastOutputs.trimRange = tmpVal;
+    changes.trimRange = true;
   }
 
-  if (lastOutputs.phase != phase || m_resetOutputsData) {
-    emit phaseChanged(phase, getCurrentPhaseName());
-    emit outputValueChange(OUTPUT_SRC_PHASE, 0, qint16(phase));
-    lastOutputs.phase = phase;
+  if (m_lastOutputs.phase != phase || m_resetOutputsData) {
+    m_lastOutputs.phase = phase;
+    changes.phase = true;
   }
 
 #if defined(GVAR_VALUE) && defined(GVARS)
@@ -565,16 +574,54 @@ void OpenTxSimulator::checkOutputsChanged()
       gvar.mode = fm;
       gvar.value = (int16_t)GVAR_VALUE(gv, getGVarFlightMode(fm, gv));
       tmpVal = gvar;
-      if (lastOutputs.gvars[fm][gv] != tmpVal || m_resetOutputsData) {
-        lastOutputs.gvars[fm][gv] = tmpVal;
-        emit gVarValueChange(gv, tmpVal);
-        emit outputValueChange(OUTPUT_SRC_GVAR, gv, tmpVal);
+      if (m_lastOutputs.gvars[fm][gv] != tmpVal || m_resetOutputsData) {
+        m_lastOutputs.gvars[fm][gv] = tmpVal;
+        changes.gvars[fm] |= (quint16)1 << gv;
       }
     }
   }
 #endif
 
   m_resetOutputsData = false;
+
+  if (changes.any())
+    publishOutputs(changes);
+}
+
+void OpenTxSimulator::publishOutputs(const TxOutputsDelta::Changes & changes)
+{
+  TxOutputsDelta & delta = m_outputsBuffers[m_outputsBack];
+  const static int16_t limit = 512 * 2;
+
+  delta.values = m_lastOutputs;
+  delta.chanLimit = (g_model.extendedLimits ? limit * LIMIT_EXT_PERCENT / 100 : limit);
+  strncpy(delta.phaseName, getPhaseName(m_lastOutputs.phase), sizeof(delta.phaseName) - 1);
+  delta.phaseName[sizeof(delta.phaseName) - 1] = '\0';
+  delta.changed = m_pendingChanges;
+  delta.changed.merge(changes);
+
+  int previous = m_outputsShared.fetchAndStoreOrdered(m_outputsBack | OUTPUTS_BUFFER_DIRTY);
+  m_outputsBack = previous & OUTPUTS_BUFFER_INDEX;
+
+  if (previous & OUTPUTS_BUFFER_DIRTY) {
+    // the reader did not fetch the previous delta yet, keep its changes for the next one
+    m_pendingChanges = delta.changed;
+  }
+  else {
+    // nothing was pending, so the reader needs to be notified
+    m_pendingChanges = changes;
+    emit outputsChanged();
+  }
+}
+
+bool OpenTxSimulator::getOutputsDelta(TxOutputsDelta & delta)
+{
+  if (!(m_outputsShared.loadAcquire() & OUTPUTS_BUFFER_DIRTY))
+    return false;
+
+  m_outputsFront = m_outputsShared.fetchAndStoreOrdered(m_outputsFront) & OUTPUTS_BUFFER_INDEX;
+  delta = m_outputsBuffers[m_outputsFront];
+  return true;
 }
 
 uint8_t OpenTxSimulator::getStickMode()
@@ -589,15 +636,6 @@ const char * OpenTxSimulator::getPhaseName(unsigned int phase)
   return buff;
 }
 
-const QString OpenTxSimulator::getCurrentPhaseName()
-{
-  unsigned phase = getFlightMode();
-  QString name(getPhaseName(phase));
-  if (name.isEmpty())
-    name = QString::number(phase);
-  return name;
-}
-
 const char * OpenTxSimulator::getError()
 {
   return main_thread_error;
@@ -19,6 +19,7 @@
 
 #include "simulatorinterface.h"
 
+#include <QAtomicInt>
 #include <QMutex>
 #include <QObject>
 #include <QTimer>
@@ -45,6 +46,7 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
     virtual uint8_t getSensorInstance(uint16_t id, uint8_t defaultValue = 0);
     virtual uint16_t getSensorRatio(uint16_t id);
     virtual const int getCapability(Capability cap);
+    virtual bool getOutputsDelta(TxOutputsDelta & delta);
 
     static QVector<QIODevice *> tracebackDevices;
 
@@ -80,9 +82,9 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
     void setStopRequested(bool stop);
     bool checkLcdChanged();
     void checkOutputsChanged();
+    void publishOutputs(const TxOutputsDelta::Changes & changes);
     uint8_t getStickMode();
     const char * getPhaseName(unsigned int phase);
-    const QString getCurrentPhaseName();
     const char * getError();
     const int voltageToAdc(const int volts);
 
@@ -95,6 +97,14 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
     QMutex m_mtxSettings;
     QMutex m_mtxTbDevices;
     int volumeGain;
+    // triple buffer shared with the GUI: the simulator thread owns the back buffer,
+    // the reader owns the front one, and they exchange them through m_outputsShared
+    TxOutputs m_lastOutputs;
+    TxOutputsDelta m_outputsBuffers[3];
+    TxOutputsDelta::Changes m_pendingChanges;
+    QAtomicInt m_outputsShared;  // index of the shared buffer | OUTPUTS_BUFFER_DIRTY
+    int m_outputsBack;
+    int m_outputsFront;
     bool m_resetOutputsData;
     bool m_stopRequested;
 
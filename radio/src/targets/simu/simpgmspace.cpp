@@ -172,6 +172,9 @@ void simuSetSwitch(uint8_t swtch, int8_t state)
   switchesStates[swtch] = state;
 }
 
+void (*simuAudioHook)(uint16_t freq, const char * filename) = NULL;
+void (*simuTelemetryHook)() = NULL;
+
 void StartSimu(bool tests, const char * sdPath, const char * settingsPath)
 {
   if (main_thread_running)
@@ -597,9 +600,34 @@ uint32_t isBootloaderStart(const uint8_t * block) { return 1; }
 void LCD_ControlLight(uint16_t dutyCycle) { }
 #endif
 
-void serialPrintf(const char * format, ...) { }
-void serialCrlf() { }
-void serialPutc(char c) { }
+void (*simuSerialHook)(const uint8_t * data, uint32_t len) = NULL;
+
+uint32_t serialWrite(const uint8_t * data, uint32_t len)
+{
+  if (simuSerialHook)
+    simuSerialHook(data, len);
+  return len;
+}
+
+uint32_t serialWriteUsb(const uint8_t * data, uint32_t len)
+{
+  return serialWrite(data, len);
+}
+
+void serialPrintf(const char * format, ...)
+{
+  if (simuSerialHook) {
+    va_list arglist;
+    char tmp[256];
+    va_start(arglist, format);
+    vsnprintf(tmp, sizeof(tmp), format, arglist);
+    va_end(arglist);
+    serialWrite((const uint8_t *)tmp, strlen(tmp));
+  }
+}
+
+void serialCrlf() { serialWrite((const uint8_t *)"\r\n", 2); }
+void serialPutc(char c) { serialWrite((const uint8_t *)&c, 1); }
 uint16_t stackSize() { return 0; }
 
 void * start_routine(void * attr)
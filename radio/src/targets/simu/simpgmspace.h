@@ -374,6 +374,15 @@ void simuSetKey(uint8_t key, bool state);
 void simuSetTrim(uint8_t trim, bool state);
 void simuSetSwitch(uint8_t swtch, int8_t state);
 
+// called for each tone (filename NULL) or file the firmware asks to play, used by the regression runner
+extern void (*simuAudioHook)(uint16_t freq, const char * filename);
+
+// receives what the firmware writes to the USB serial, used by the CLI stand-in
+extern void (*simuSerialHook)(const uint8_t * data, uint32_t len);
+
+// called for each value the telemetry parsers give to a sensor, used by the telemetry replay
+extern void (*simuTelemetryHook)();
+
 void StartEepromThread(const char *filename="eeprom.bin");
 void StopEepromThread();
 #if defined(SIMU_AUDIO) && defined(CPUARM)
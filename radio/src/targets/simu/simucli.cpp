@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+// Stand-in of the radio CLI for tools/cli-stream.py: the same binary
+// streaming commands (cli_stream.cpp) on stdin/stdout instead of the USB
+// serial, with the simulator SD card. The firmware stdout is moved to
+// stderr so that only the serial line goes to stdout.
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "opentx.h"
+#include "cli_stream.h"
+#include "simuheadless.h"
+
+#define CLI_COMMAND_MAX_ARGS           8
+#define CLI_COMMAND_MAX_LEN            256
+
+static FILE * serialLine = NULL;
+
+static void onSerial(const uint8_t * data, uint32_t len)
+{
+  fwrite(data, 1, len, serialLine);
+}
+
+static void onTrace(const char * text)
+{
+  if (cliStreamTracesEnabled)
+    cliStreamTrace(text, strlen(text));
+}
+
+static int execLine(char * line)
+{
+  const char * argv[CLI_COMMAND_MAX_ARGS];
+  memset(argv, 0, sizeof(argv));
+  int argc = 1;
+  argv[0] = line;
+  for (char * c = line; *c; c++) {
+    if (*c == ' ') {
+      *c = '\0';
+      if (argc < CLI_COMMAND_MAX_ARGS)
+        argv[argc++] = c + 1;
+    }
+  }
+
+  if (argv[0][0] == '\0')
+    return 0;
+  else if (!strcmp(argv[0], "stream"))
+    return cliStream(argv);
+  else if (!strcmp(argv[0], "trace") && argv[1]) {
+    // firmware trace, to check the CLI_FRAME_TRACE frames
+    TRACE("%s", argv[1]);
+    return 0;
+  }
+  serialPrint("Invalid command \"%s\"", argv[0]);
+  return -1;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: simucli [--sd <dir>] [--settings <dir>]\n");
+  exit(2);
+}
+
+int main(int argc, char ** argv)
+{
+  const char * sdPath = NULL;
+  const char * settingsPath = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--sd") && hasValue)
+      sdPath = argv[++i];
+    else if (!strcmp(argv[i], "--settings") && hasValue)
+      settingsPath = argv[++i];
+    else
+      usage();
+  }
+
+  serialLine = fdopen(dup(STDOUT_FILENO), "wb");
+  if (!serialLine) {
+    perror("stdout");
+    return 1;
+  }
+  dup2(STDERR_FILENO, STDOUT_FILENO);
+
+  simuHeadlessStart(sdPath, settingsPath, NULL);
+  simuSerialHook = onSerial;
+  traceCallback = onTrace;
+
+  // same prompt, echo and line endings as cliTask()
+  char line[CLI_COMMAND_MAX_LEN+1];
+  int pos = 0;
+  int c;
+  serialPutc('>');
+  fflush(serialLine);
+  while ((c = getchar()) != EOF) {
+    if (c == '\r' || c == '\n') {
+      serialCrlf();
+      line[pos] = '\0';
+      execLine(line);
+      pos = 0;
+      serialPutc('>');
+      fflush(serialLine);
+    }
+    else if (isascii(c) && pos < CLI_COMMAND_MAX_LEN) {
+      line[pos++] = c;
+      serialPutc(c);
+    }
+  }
+
+  traceCallback = NULL;
+  simuSerialHook = NULL;
+  fclose(serialLine);
+  return 0;
+}
@@ -292,7 +292,7 @@ FRESULT f_stat (const TCHAR * name, FILINFO *fno)
   struct stat tmp;
   if (stat(realPath.c_str(), &tmp)) {
     TRACE_SIMPGMSPACE("f_stat(%s) = error %d (%s)", path.c_str(), errno, strerror(errno));
-    return FR_INVALID_NAME;
+    return errno == ENOENT ? FR_NO_FILE : FR_INVALID_NAME;
   }
   else {
     TRACE_SIMPGMSPACE("f_stat(%s) = OK", path.c_str());
@@ -327,7 +327,13 @@ FRESULT f_open (FIL * fil, const TCHAR *name, BYTE flag)
     fil->obj.objsize = tmp.st_size;
     fil->fptr = 0;
   }
-  fil->obj.fs = (FATFS*)fopen(realPath.c_str(), (flag & FA_WRITE) ? ((flag & FA_CREATE_ALWAYS) ? "wb+" : "ab+") : "rb+");
+  const char * mode = "rb+";
+  if (flag & FA_CREATE_ALWAYS)
+    mode = "wb+";
+  else if (flag & (FA_OPEN_ALWAYS | FA_OPEN_APPEND))
+    mode = "ab+";
+  // FA_OPEN_EXISTING | FA_WRITE is used to write in place
+  fil->obj.fs = (FATFS*)fopen(realPath.c_str(), mode);
   fil->fptr = 0;
   if (fil->obj.fs) {
     TRACE_SIMPGMSPACE("f_open(%s, %x) = %p (FIL %p)", path.c_str(), flag, fil->obj.fs, fil);
@@ -493,7 +499,7 @@ FRESULT f_unlink (const TCHAR * name)
   std::string path = convertToSimuPath(name);
   if (unlink(path.c_str())) {
     TRACE_SIMPGMSPACE("f_unlink(%s) = error %d (%s)", path.c_str(), errno, strerror(errno));
-    return FR_INVALID_NAME;
+    return errno == ENOENT ? FR_NO_FILE : FR_INVALID_NAME;
   }
   else {
     TRACE_SIMPGMSPACE("f_unlink(%s) = OK", path.c_str());
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "simuheadless.h"
+
+uint16_t anaInValues[NUM_STICKS+NUM_POTS+NUM_SLIDERS] = { 0 };
+
+uint16_t anaIn(uint8_t chan)
+{
+  if (chan < NUM_STICKS+NUM_POTS+NUM_SLIDERS)
+    return anaInValues[chan];
+  else
+    return 0;
+}
+
+uint16_t getAnalogValue(uint8_t index)
+{
+  return anaIn(index);
+}
+
+#if defined(EEPROM)
+static bool eepromStarted = false;
+#endif
+
+void simuHeadlessStart(const char * sdPath, const char * settingsPath, const char * eepromPath)
+{
+  simuInit();
+  simuFatfsSetPaths(sdPath, settingsPath);
+
+  // same reason as in StartSimu(), some functions use 0 as "never run"
+  g_tmr10ms = 1;
+
+#if defined(EEPROM)
+  if (eepromPath) {
+    StartEepromThread(eepromPath);
+    eepromStarted = true;
+    storageReadAll();
+  }
+#else
+  UNUSED(eepromPath);
+  if (settingsPath) {
+    storageReadAll();
+  }
+#endif
+}
+
+const char * simuHeadlessLoadModel(const char * model)
+{
+#if defined(EEPROM)
+  if (!eeModelExists(atoi(model)))
+    return "no such model";
+  eeLoadModel(atoi(model));
+  return NULL;
+#else
+  return loadModel(model, false);
+#endif
+}
+
+void simuHeadlessStop()
+{
+#if defined(EEPROM)
+  if (eepromStarted) {
+    StopEepromThread();
+    eepromStarted = false;
+  }
+#endif
+}
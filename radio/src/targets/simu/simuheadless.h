@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _SIMUHEADLESS_H_
+#define _SIMUHEADLESS_H_
+
+#include "opentx.h"
+
+// Firmware environment of the headless simulator programs (simuregress,
+// simucli, simutelemetry, gbench), which run the firmware code from their
+// own main() without the simulator threads.
+
+// raw ADC values, set by the program
+extern uint16_t anaInValues[NUM_STICKS+NUM_POTS+NUM_SLIDERS];
+
+// Sets the SD card and settings dirs (NULL for the current dir / none), and
+// reads the radio data when an EEPROM image or a settings dir is given
+void simuHeadlessStart(const char * sdPath, const char * settingsPath, const char * eepromPath);
+
+// Loads a model, by index on EEPROM radios or by file name, returns an error or NULL
+const char * simuHeadlessLoadModel(const char * model);
+
+void simuHeadlessStop();
+
+#endif // _SIMUHEADLESS_H_
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+// Headless worker of the simulator regression runner (tools/simu-regress.py).
+// It loads one model, plays an input timeline through the mixer without the
+// simulator threads, and writes a trace of everything that changed on each
+// 10ms tick. One process per model keeps the firmware globals isolated.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "opentx.h"
+#include "simuheadless.h"
+
+void doMixerCalculations();
+
+static FILE * trace = NULL;
+static uint32_t currentTick = 0;
+static uint32_t audioEvents = 0;
+
+static void onAudio(uint16_t freq, const char * filename)
+{
+  audioEvents++;
+  if (filename)
+    fprintf(trace, "%u au file %s\n", currentTick, filename);
+  else
+    fprintf(trace, "%u au tone %u\n", currentTick, freq);
+}
+
+// Timeline line: "<time ms> <ana|sw|key|trim> <index> <value>", '#' starts a comment.
+// Analog values are raw ADC values, switch states are -1, 0 or 1.
+struct TimelineEvent {
+  uint32_t time;
+  char type[8];
+  int index;
+  int value;
+};
+
+static bool applyEvent(const TimelineEvent & event)
+{
+  if (!strcmp(event.type, "ana") && event.index >= 0 && event.index < (int)DIM(anaInValues))
+    anaInValues[event.index] = event.value;
+  else if (!strcmp(event.type, "sw") && event.index >= 0 && event.index < NUM_PSWITCH)
+    simuSetSwitch(event.index, event.value);
+  else if (!strcmp(event.type, "key") && event.index >= 0 && event.index < NUM_KEYS)
+    simuSetKey(event.index, event.value);
+  else if (!strcmp(event.type, "trim") && event.index >= 0 && event.index < NUM_TRIMS*2)
+    simuSetTrim(event.index, event.value);
+  else
+    return false;
+  return true;
+}
+
+static int loadTimeline(const char * path, TimelineEvent ** events)
+{
+  FILE * f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return -1;
+  }
+
+  int count = 0, size = 0;
+  char line[128];
+  *events = NULL;
+  while (fgets(line, sizeof(line), f)) {
+    TimelineEvent event;
+    if (line[0] == '#' || sscanf(line, "%u %7s %d %d", &event.time, event.type, &event.index, &event.value) != 4)
+      continue;
+    if (count == size) {
+      size = size ? 2 * size : 64;
+      *events = (TimelineEvent *)realloc(*events, size * sizeof(TimelineEvent));
+    }
+    (*events)[count++] = event;
+  }
+
+  fclose(f);
+  return count;
+}
+
+static void listModels()
+{
+#if defined(EEPROM)
+  for (uint8_t i = 0; i < MAX_MODELS; i++) {
+    if (eeModelExists(i))
+      printf("%d\n", i);
+  }
+#else
+  DIR dir;
+  FILINFO fno;
+  if (f_opendir(&dir, MODELS_PATH) == FR_OK) {
+    while (f_readdir(&dir, &fno) == FR_OK && fno.fname[0] != '\0') {
+      const char * ext = getFileExtension(fno.fname);
+      if (!(fno.fattrib & AM_DIR) && ext && !strcasecmp(ext, MODELS_EXT))
+        printf("%s\n", fno.fname);
+    }
+    f_closedir(&dir);
+  }
+#endif
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: simuregress (--eeprom <file> | --settings <dir>) [--sd <dir>] --list\n"
+                  "       simuregress (--eeprom <file> | --settings <dir>) [--sd <dir>] --model <index|file>\n"
+                  "                   --timeline <file> [--duration <ms>] [--trace <file>]\n");
+  exit(2);
+}
+
+int main(int argc, char ** argv)
+{
+  const char * eepromPath = NULL;
+  const char * settingsPath = NULL;
+  const char * sdPath = NULL;
+  const char * model = NULL;
+  const char * timelinePath = NULL;
+  const char * tracePath = NULL;
+  uint32_t duration = 0;
+  bool list = false;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--list"))
+      list = true;
+    else if (!strcmp(argv[i], "--eeprom") && hasValue)
+      eepromPath = argv[++i];
+    else if (!strcmp(argv[i], "--settings") && hasValue)
+      settingsPath = argv[++i];
+    else if (!strcmp(argv[i], "--sd") && hasValue)
+      sdPath = argv[++i];
+    else if (!strcmp(argv[i], "--model") && hasValue)
+      model = argv[++i];
+    else if (!strcmp(argv[i], "--timeline") && hasValue)
+      timelinePath = argv[++i];
+    else if (!strcmp(argv[i], "--trace") && hasValue)
+      tracePath = argv[++i];
+    else if (!strcmp(argv[i], "--duration") && hasValue)
+      duration = atoi(argv[++i]);
+    else
+      usage();
+  }
+
+#if defined(EEPROM)
+  if (!eepromPath)
+    usage();
+#else
+  if (!settingsPath)
+    usage();
+#endif
+
+  if (!list && (!model || !timelinePath))
+    usage();
+
+  // the runner gives each worker its own copy of the radio data
+  simuHeadlessStart(sdPath, settingsPath, eepromPath);
+
+  if (list) {
+    listModels();
+    simuHeadlessStop();
+    return 0;
+  }
+
+  TimelineEvent * events;
+  int eventsCount = loadTimeline(timelinePath, &events);
+  if (eventsCount < 0)
+    return 1;
+  if (!duration)
+    duration = (eventsCount ? events[eventsCount-1].time : 0) + 1000;
+
+  const char * error = simuHeadlessLoadModel(model);
+  if (error) {
+    fprintf(stderr, "%s: %s\n", model, error);
+    return 1;
+  }
+
+  trace = (tracePath ? fopen(tracePath, "w") : stdout);
+  if (!trace) {
+    perror(tracePath);
+    return 1;
+  }
+  simuAudioHook = onAudio;
+
+  int16_t lastOutputs[MAX_OUTPUT_CHANNELS];
+  bool lastSwitches[MAX_LOGICAL_SWITCHES];
+  uint8_t tracedFlightMode = 255;
+  memset(lastOutputs, 0, sizeof(lastOutputs));
+  memset(lastSwitches, 0, sizeof(lastSwitches));
+
+  uint64_t start = simuTimerMicros();
+  uint32_t ticks = duration / 10;
+  int nextEvent = 0;
+
+  for (currentTick = 0; currentTick < ticks; currentTick++) {
+    while (nextEvent < eventsCount && events[nextEvent].time <= currentTick * 10) {
+      if (!applyEvent(events[nextEvent]))
+        fprintf(stderr, "ignored timeline event at %ums\n", events[nextEvent].time);
+      nextEvent++;
+    }
+
+    g_tmr10ms++;
+    doMixerCalculations();
+
+    if (mixerCurrentFlightMode != tracedFlightMode) {
+      tracedFlightMode = mixerCurrentFlightMode;
+      fprintf(trace, "%u fm %d\n", currentTick, tracedFlightMode);
+    }
+    for (int i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+      if (channelOutputs[i] != lastOutputs[i] || currentTick == 0) {
+        lastOutputs[i] = channelOutputs[i];
+        fprintf(trace, "%u ch %d %d\n", currentTick, i, lastOutputs[i]);
+      }
+    }
+    for (int i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+      bool state = getSwitch(SWSRC_FIRST_LOGICAL_SWITCH + i);
+      if (state != lastSwitches[i] || currentTick == 0) {
+        lastSwitches[i] = state;
+        fprintf(trace, "%u ls %d %d\n", currentTick, i, state);
+      }
+    }
+  }
+
+  uint64_t elapsed = simuTimerMicros() - start;
+  simuAudioHook = NULL;
+  if (trace != stdout)
+    fclose(trace);
+  free(events);
+
+  simuHeadlessStop();
+
+  // read by the runner, on stderr so that the trace can go to stdout
+  fprintf(stderr, "ticks %u elapsed_us %llu audio %u\n", ticks, (unsigned long long)elapsed, audioEvents);
+  return 0;
+}
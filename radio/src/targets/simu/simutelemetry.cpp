@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+// Headless worker of the telemetry replay (tools/telemetry-replay.py). It
+// streams a capture written by LOG_TELEMETRY into the telemetry FIFO at a
+// speed multiple of the recorded timing, runs the telemetry task loop of the
+// firmware on it, and reports the time spent in telemetryWakeup() per second
+// of telemetry, the latency from a byte arrival to the sensor update it
+// completes, and the bytes dropped because the FIFO was full.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "opentx.h"
+#include "simuheadless.h"
+
+// bytes logged during the same 10ms with the time (us) since the first line
+struct CaptureChunk {
+  uint64_t time;
+  uint32_t offset;
+};
+
+struct Capture {
+  uint8_t * data;
+  uint32_t size;
+  CaptureChunk * chunks;
+  uint32_t chunksCount;
+};
+
+// Capture line: "\r\nYYYY-MM-DD,HH:MM:SS.mmm: XX XX ...", see logTelemetryWriteStart()
+static bool loadCapture(const char * path, Capture & capture)
+{
+  FILE * f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+
+  uint32_t dataSize = 0, chunksSize = 0;
+  int64_t first = -1, last = 0, dayOffset = 0;
+  char line[4096];
+  memset(&capture, 0, sizeof(capture));
+  while (fgets(line, sizeof(line), f)) {
+    int year, month, day, hours, minutes, seconds, millis, length;
+    if (sscanf(line, "%d-%d-%d,%d:%d:%d.%d:%n", &year, &month, &day, &hours, &minutes, &seconds, &millis, &length) != 7)
+      continue;
+    int64_t time = ((hours * 3600 + minutes * 60 + seconds) * 1000 + millis) * 1000LL + dayOffset;
+    if (first < 0)
+      first = time;
+    else if (time < last) {
+      // midnight
+      dayOffset += 86400 * 1000000LL;
+      time += 86400 * 1000000LL;
+    }
+    last = time;
+
+    if (capture.chunksCount == chunksSize) {
+      chunksSize = chunksSize ? 2 * chunksSize : 1024;
+      capture.chunks = (CaptureChunk *)realloc(capture.chunks, chunksSize * sizeof(CaptureChunk));
+    }
+    capture.chunks[capture.chunksCount].time = time - first;
+    capture.chunks[capture.chunksCount].offset = capture.size;
+    capture.chunksCount++;
+
+    const char * pos = line + length;
+    unsigned int byte;
+    int count;
+    while (sscanf(pos, " %2x%n", &byte, &count) == 1) {
+      if (capture.size == dataSize) {
+        dataSize = dataSize ? 2 * dataSize : 65536;
+        capture.data = (uint8_t *)realloc(capture.data, dataSize);
+      }
+      capture.data[capture.size++] = byte;
+      pos += count;
+    }
+  }
+
+  fclose(f);
+  return true;
+}
+
+// Line rate of each protocol, it spreads the bytes of a chunk as the UART would
+struct ReplayProtocol {
+  const char * name;
+  uint8_t moduleType;
+  uint8_t telemetryProtocol;
+  uint32_t baudrate;
+};
+
+static const ReplayProtocol replayProtocols[] = {
+  { "sport", MODULE_TYPE_NONE, 0, FRSKY_SPORT_BAUDRATE },
+  { "d", MODULE_TYPE_PPM, PROTOCOL_TELEMETRY_FRSKY_D, FRSKY_D_BAUDRATE },
+#if defined(CROSSFIRE)
+  { "crossfire", MODULE_TYPE_CROSSFIRE, 0, 0 }, // CROSSFIRE_BAUDRATE depends on the radio settings
+#endif
+#if defined(GHOST)
+  { "ghost", MODULE_TYPE_GHOST, 0, GHOST_BAUDRATE },
+#endif
+};
+
+#define ARRIVALS_SIZE 1024 // more than the bytes a FIFO can hold
+
+static uint64_t arrivals[ARRIVALS_SIZE];
+static uint32_t bytesAccepted = 0;
+static uint32_t bytesDropped = 0;
+static uint32_t sensorUpdates = 0;
+static uint64_t latencyTotal = 0;
+static uint64_t latencyMax = 0;
+
+static void onSensorUpdate()
+{
+  if (simuTelemetryBytesRead == 0)
+    return;
+  uint64_t latency = simuTimerMicros() - arrivals[(simuTelemetryBytesRead - 1) % ARRIVALS_SIZE];
+  sensorUpdates++;
+  latencyTotal += latency;
+  if (latency > latencyMax)
+    latencyMax = latency;
+}
+
+// what the RX interrupt does with each byte
+static void receiveByte(uint8_t data)
+{
+  if (simuTelemetryFifo.isFull()) {
+    bytesDropped++;
+  }
+  else {
+    arrivals[bytesAccepted++ % ARRIVALS_SIZE] = simuTimerMicros();
+    simuTelemetryFifo.push(data);
+  }
+  telemetryRxNotify(data);
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: simutelemetry --capture <telemetry.log> [--speed <multiplier>] [--protocol <name>]\n"
+                  "                     [(--eeprom <file> | --settings <dir>) [--sd <dir>] --model <index|file>]\n"
+                  "       --speed 0 replays as fast as the parsers go, without dropping bytes\n"
+                  "       protocols:");
+  for (unsigned i = 0; i < DIM(replayProtocols); i++)
+    fprintf(stderr, " %s", replayProtocols[i].name);
+  fprintf(stderr, "\n");
+  exit(2);
+}
+
+int main(int argc, char ** argv)
+{
+  const char * capturePath = NULL;
+  const char * eepromPath = NULL;
+  const char * settingsPath = NULL;
+  const char * sdPath = NULL;
+  const char * model = NULL;
+  const ReplayProtocol * protocol = NULL;
+  double speed = 1.0;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--capture") && hasValue)
+      capturePath = argv[++i];
+    else if (!strcmp(argv[i], "--speed") && hasValue)
+      speed = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--protocol") && hasValue) {
+      const char * name = argv[++i];
+      for (unsigned j = 0; j < DIM(replayProtocols); j++) {
+        if (!strcmp(name, replayProtocols[j].name))
+          protocol = &replayProtocols[j];
+      }
+      if (!protocol)
+        usage();
+    }
+    else if (!strcmp(argv[i], "--eeprom") && hasValue)
+      eepromPath = argv[++i];
+    else if (!strcmp(argv[i], "--settings") && hasValue)
+      settingsPath = argv[++i];
+    else if (!strcmp(argv[i], "--sd") && hasValue)
+      sdPath = argv[++i];
+    else if (!strcmp(argv[i], "--model") && hasValue)
+      model = argv[++i];
+    else
+      usage();
+  }
+
+  if (!capturePath || speed < 0 || (model && !eepromPath && !settingsPath))
+    usage();
+
+  Capture capture;
+  if (!loadCapture(capturePath, capture))
+    return 1;
+  if (capture.size == 0) {
+    fprintf(stderr, "%s: no telemetry bytes\n", capturePath);
+    return 1;
+  }
+
+  // the radio data is only read for a model
+  simuHeadlessStart(sdPath, model ? settingsPath : NULL, model ? eepromPath : NULL);
+
+  if (model) {
+    const char * error = simuHeadlessLoadModel(model);
+    if (error) {
+      fprintf(stderr, "%s: %s\n", model, error);
+      return 1;
+    }
+  }
+
+  if (protocol) {
+    g_model.moduleData[INTERNAL_MODULE].type = MODULE_TYPE_NONE;
+    g_model.moduleData[EXTERNAL_MODULE].type = protocol->moduleType;
+    g_model.telemetryProtocol = protocol->telemetryProtocol;
+  }
+  else {
+    protocol = &replayProtocols[0];
+  }
+
+  // the parsers only update the sensors the model has, unless discovery is on
+  allowNewSensors = true;
+  simuTelemetryHook = onSensorUpdate;
+
+  uint32_t baudrate = protocol->baudrate;
+#if defined(CROSSFIRE)
+  if (protocol->moduleType == MODULE_TYPE_CROSSFIRE)
+    baudrate = CROSSFIRE_BAUDRATE;
+#endif
+  uint64_t byteTime = 10 * 1000000ULL / baudrate;
+  uint64_t start = simuTimerMicros();
+  uint64_t lastDue = 0;
+  uint32_t chunk = 0, next = 0;
+  uint32_t wakeups = 0;
+  uint64_t wakeupTotal = 0, wakeupMax = 0;
+
+  while (next < capture.size || !simuTelemetryFifo.isEmpty()) {
+    RTOS_CLEAR_FLAG(telemetryFlag);
+    uint64_t deadline = simuTimerMicros() + telemetryGetWakeupDelay() * 1000;
+
+    // the RX interrupt until the task is woken by a frame end or a timer
+    while (true) {
+      uint64_t now = simuTimerMicros();
+      uint64_t due = 0;
+      while (next < capture.size) {
+        while (chunk + 1 < capture.chunksCount && capture.chunks[chunk + 1].offset <= next)
+          chunk++;
+        if (speed == 0) {
+          if (simuTelemetryFifo.isFull())
+            break;
+        }
+        else {
+          const CaptureChunk & current = capture.chunks[chunk];
+          due = start + uint64_t((current.time + (next - current.offset) * byteTime) / speed);
+          due = max(due, lastDue);
+          if (due > now)
+            break;
+          lastDue = due;
+        }
+        receiveByte(capture.data[next++]);
+      }
+      if (speed == 0 || telemetryFlag || now >= deadline || next == capture.size)
+        break;
+      std::this_thread::sleep_for(std::chrono::microseconds(min(due, deadline) - now));
+    }
+
+    uint64_t wakeupStart = simuTimerMicros();
+    g_tmr10ms = 1 + (wakeupStart - start) / 10000;
+    telemetryWakeup();
+    uint64_t wakeupTime = simuTimerMicros() - wakeupStart;
+    wakeups++;
+    wakeupTotal += wakeupTime;
+    wakeupMax = max(wakeupMax, wakeupTime);
+  }
+
+  uint64_t elapsed = simuTimerMicros() - start;
+  simuTelemetryHook = NULL;
+
+  simuHeadlessStop();
+
+  // one "name value" list, parsed by the replay tool
+  uint64_t duration = capture.chunks[capture.chunksCount - 1].time + 10000;
+  printf("bytes %u dropped %u wakeups %u sensor_updates %u duration_us %llu elapsed_us %llu "
+         "wakeup_us_per_s %llu wakeup_max_us %llu latency_avg_us %llu latency_max_us %llu\n",
+         capture.size, bytesDropped, wakeups, sensorUpdates,
+         (unsigned long long)duration, (unsigned long long)elapsed,
+         (unsigned long long)(wakeupTotal * 1000000 / duration), (unsigned long long)wakeupMax,
+         (unsigned long long)(sensorUpdates ? latencyTotal / sensorUpdates : 0), (unsigned long long)latencyMax);
+
+  free(capture.data);
+  free(capture.chunks);
+  return 0;
+}
@@ -19,72 +19,74 @@
  */
 
 
-// NOTE: These Qt includes need to come first, before opentx.h, due to macro naming conflicts in ARM libs.
-//#include <QtCore>
-//#include <QTouchEvent>
-//#include <QDebug>
-
 #include "opentx.h"
 
 #if IS_TOUCH_ENABLED()
 
 #include "simutouch.h"
-//#include "simpgmspace.h"
 #include "targets/i8/touch_driver.h"
 #include "touch_manager.h"
 
-//static QTouchEvent * lastTouchEvent = NULL;
-//QMutex touchMutex;
-
 using namespace Touch;
 
 touchData_t touchData;
 
-// TODO: Stubs!
+struct SimuTouchSample {
+  int16_t x;
+  int16_t y;
+  bool down;
+  uint32_t ts;
+};
 
-bool touchGetDataMutex()
-{
-  return true;
-}
+static Fifo<SimuTouchSample, 64> touchSamples;
 
-void touchRelDataMutex()
+void simuTouchSample(int16_t x, int16_t y, bool down, uint32_t ts)
 {
- // touchMutex.unlock();
+  touchSamples.push({x, y, down, ts});
 }
 
-uint8_t touchParseData(void)
+bool touchGetDataMutex()
 {
-//  if (!touchData.dataReady || !lastTouchEvent /*|| !touchGetMutex()*/)
-//    return;
-//  touchData.dataReady = false;
-//  QTouchEvent evt = QTouchEvent(lastTouchEvent->type(), lastTouchEvent->device(), lastTouchEvent->modifiers(), lastTouchEvent->touchPointStates(), lastTouchEvent->touchPoints());
-
-//  foreach (const QTouchEvent::TouchPoint & tp, evt.touchPoints()) {
-//    qDebug() << tp;
-//  }
-//  touchReleaesMutex();
-  return 0;
+  return true;
 }
 
-void simuSetTouchEvent()
+void touchRelDataMutex()
 {
-  if (!touchGetDataMutex())
-    return;
-
-  //lastTouchEvent = event; //QTouchEvent(event->type(), event->device(), event->modifiers(), event->touchPointStates(), event->touchPoints());
-
-  //touchReleaesMutex();
-  touchParseData();
-
 }
 
 int8_t touchReadData()
 {
-//  if (touchData.dataReady) {
-//    //touchParseData();
-//    return 1;  // immediate read
-//  }
-  return 0;
+  SimuTouchSample sample;
+  if (!touchSamples.pop(sample))
+    return 0;
+
+  const RawTrackingPoint & ptRef = touchData.touchPt[0];
+  RawTrackingPoint touchPt = ptRef;
+  touchPt.index = 0;
+  touchPt.state = ST_UP;
+  touchPt.ts = sample.ts;
+
+  if (sample.down) {
+    touchPt.pos = touchPt.rawPos = {sample.x, sample.y};
+    touchPt.state = ST_TOUCH;
+    if (!(ptRef.state & ST_TOUCH)) {
+      touchPt.serId = (sample.ts ^ 1);
+      touchPt.state |= ST_PRESS;
+    }
+    else if (touchData.reportMoveEvents && touchPt.pos.dist(ptRef.pos) >= TOUCH_MIN_MOVE_DIST)
+      touchPt.state |= ST_MOVE;
+    else if (touchData.reportHoldEvents)
+      touchPt.state |= ST_HOLD;
+  }
+  else if (ptRef.state & ST_TOUCH) {
+    // released at the last known position
+    touchPt.state = ST_RELEASE;
+  }
+
+  // after a release the UP state is reported once
+  touchData.status = (touchPt.state != ST_UP || (ptRef.state & ST_RELEASE)) ? 1 : 0;
+  touchData.touchPt[0] = touchPt;
+  return touchData.status;
 }
 
 bool touchInit(void)
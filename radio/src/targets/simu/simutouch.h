@@ -18,11 +18,15 @@
  * GNU General Public License for more details.
  */
 
+
 #ifndef SIMUTOUCH_H
 #define SIMUTOUCH_H
 
-//class QTouchEvent;
+#include <inttypes.h>
 
-void simuSetTouchEvent();
+// Single point stand-in of the touch driver: the simulator or a replay queues
+// samples (screen coordinates, time in ms), touchReadData() turns them into
+// tracking points the way the FT6236 driver does.
+void simuTouchSample(int16_t x, int16_t y, bool down, uint32_t ts);
 
 #endif // SIMUTOUCH_H
@@ -166,6 +166,7 @@ extern "C" void TELEMETRY_USART_IRQHandler(void)
     }
     else {
       telemetryFifo.push(data);
+      telemetryRxNotify(data);
 #if defined(LUA)
       if (telemetryProtocol == PROTOCOL_TELEMETRY_FRSKY_SPORT) {
         static uint8_t prevdata;
@@ -145,10 +145,9 @@ TASK_FUNCTION(telemetryTask)
     TASK_RETURN();
   }
 #endif
-  // if(!telemetryFlag) 
-  //   break;
+  // woken by the RX interrupt or at the next telemetry deadline
+  RTOS_WAIT_FLAG(telemetryFlag, telemetryGetWakeupDelay());
   RTOS_CLEAR_FLAG(telemetryFlag);
-  RTOS_WAIT_FLAG(telemetryFlag, 10);
   DEBUG_TIMER_START(debugTimerTelemetryWakeup);
   telemetryWakeup();
   DEBUG_TIMER_STOP(debugTimerTelemetryWakeup);
@@ -161,7 +160,6 @@ TASK_FUNCTION(mixerTask)
   s_pulses_paused = true;
   mixerSchedulerInit();
   mixerSchedulerStart();
-  RTOS_CREATE_FLAG(telemetryFlag);
   while(1) {
 #if defined(SBUS_TRAINER)
     processSbusInput();
@@ -169,8 +167,6 @@ TASK_FUNCTION(mixerTask)
 #if defined(BLUETOOTH)
     bluetoothWakeup();
 #endif
-  //process telemetry when waiting
-  RTOS_ISR_SET_FLAG(telemetryFlag);
   // run mixer at least every 30ms
   bool timeout = mixerSchedulerWaitForTrigger(30);
   // re-enable trigger
@@ -328,6 +324,8 @@ void tasksStart()
   cliStart();
 #endif
 
+  RTOS_CREATE_FLAG(telemetryFlag);
+
   RTOS_CREATE_TASK(mixerTaskId, mixerTask, "Mixer", mixerStack, MIXER_STACK_SIZE, MIXER_TASK_PRIO);
   RTOS_CREATE_TASK(telemetryTaskId, telemetryTask, "Telemetry", telemetryStack, TELEMETRY_STACK_SIZE, TELEMETRY_TASK_PRIO);
   RTOS_CREATE_TASK(menusTaskId, menusTask, "Menus", menusStack,  MENUS_STACK_SIZE, MENUS_TASK_PRIO);
@@ -46,6 +46,7 @@ extern RTOS_DEFINE_STACK(mixerStack, MIXER_STACK_SIZE);
 
 extern RTOS_TASK_HANDLE telemetryTaskId;
 extern RTOS_DEFINE_STACK(telemetryStack, TELEMETRY_STACK_SIZE);
+extern RTOS_FLAG_HANDLE telemetryFlag;
 
 extern RTOS_TASK_HANDLE audioTaskId;
 extern RTOS_DEFINE_STACK(audioStack, AUDIO_STACK_SIZE);
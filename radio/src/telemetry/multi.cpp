@@ -278,6 +278,7 @@ static void processMultiRxChannels(const uint8_t * data, uint8_t len)
   uint32_t bits = 0;
   uint8_t  bitsavailable = 0;
   uint8_t  byteIdx = 4;
+  int16_t * channels = trainerBeginSnapshot();
 
   while (ch < maxCh) {
     while (bitsavailable < MULTI_CHAN_BITS && byteIdx < len) {
@@ -289,15 +290,17 @@ static void processMultiRxChannels(const uint8_t * data, uint8_t len)
     bitsavailable -= MULTI_CHAN_BITS;
     bits >>= MULTI_CHAN_BITS;
 
-    ppmInput[ch] = (value - 1024) * 500 / 800;
+    channels[ch] = (value - 1024) * 500 / 800;
     ch++;
 
     if (byteIdx >= len)
       break;
   }
 
-  if (ch == maxCh)
+  if (ch == maxCh) {
+    trainerPublishSnapshot(TRAINER_INPUT_MULTI, maxCh);
     ppmInputValidityTimer = PPM_IN_VALID_TIMEOUT;
+  }
 }
 #endif
 
@@ -95,9 +95,132 @@ void processTelemetryData(uint8_t data)
   processFrskyTelemetryData(data);
 }
 
+#if defined(CPUARM)
+struct TelemetryProtocolTiming {
+  uint8_t protocol;
+  uint8_t pollPeriod;       // ms
+  uint8_t wakeupBytes;      // wake the task once this count of bytes is received
+  int16_t frameDelimiter;   // or when this byte starts a new frame (-1 if none)
+};
+
+static const TelemetryProtocolTiming telemetryProtocolTimings[] = {
+  // S.Port receivers poll a sensor every 12ms: 0x7E, physical ID and a 8 bytes frame
+  { PROTOCOL_TELEMETRY_FRSKY_SPORT, 12, 10, 0x7E },
+  { PROTOCOL_TELEMETRY_FRSKY_D, 10, 11, 0x7E },
+#if defined(CROSSFIRE)
+  // 250Hz frames, each starting with the radio address
+  { PROTOCOL_TELEMETRY_CROSSFIRE, 4, 16, RADIO_ADDRESS },
+#endif
+#if defined(GHOST)
+  { PROTOCOL_TELEMETRY_GHOST, 4, 14, GHST_ADDR_RADIO },
+#endif
+#if defined(AFHDS3)
+  // frames delimited by END (0xC0), responses are expected via telemetryExpectResponse()
+  { PROTOCOL_TELEMETRY_AFHDS3, 4, 16, 0xC0 },
+#endif
+};
+
+static const TelemetryProtocolTiming telemetryDefaultTiming = { 0, 10, 16, -1 };
+static const TelemetryProtocolTiming * telemetryTiming = &telemetryDefaultTiming;
+static volatile uint8_t telemetryRxPending = 0;
+static volatile uint32_t telemetryDeadlines[TELEMETRY_TIMERS_COUNT];
+
+void telemetryScheduleInit(uint8_t protocol)
+{
+  telemetryTiming = &telemetryDefaultTiming;
+  for (unsigned i=0; i<DIM(telemetryProtocolTimings); i++) {
+    if (telemetryProtocolTimings[i].protocol == protocol) {
+      telemetryTiming = &telemetryProtocolTimings[i];
+      break;
+    }
+  }
+  telemetryRxPending = 0;
+  telemetryScheduleTimer(TELEMETRY_TIMER_PROTOCOL, telemetryTiming->pollPeriod);
+  telemetryScheduleTimer(TELEMETRY_TIMER_HOUSEKEEPING, TELEMETRY_HOUSEKEEPING_PERIOD);
+}
+
+void telemetryScheduleTimer(uint8_t timer, uint32_t delay)
+{
+  telemetryDeadlines[timer] = RTOS_GET_MS() + delay;
+}
+
+static bool telemetryTimerExpired(uint8_t timer, uint32_t now)
+{
+  return int32_t(now - telemetryDeadlines[timer]) >= 0;
+}
+
+// Time to wait until the next deadline, at least one RTOS tick (0 would wait forever)
+uint32_t telemetryGetWakeupDelay()
+{
+  uint32_t now = RTOS_GET_MS();
+  int32_t delay = TELEMETRY_HOUSEKEEPING_PERIOD;
+  for (uint8_t i=0; i<TELEMETRY_TIMERS_COUNT; i++) {
+    delay = min<int32_t>(delay, telemetryDeadlines[i] - now);
+  }
+  return max<int32_t>(delay, RTOS_MS_PER_TICK);
+}
+
+// Called by the RX interrupts for each received byte
+void telemetryRxNotify(uint8_t data)
+{
+  uint8_t pending = telemetryRxPending + 1;
+  if (data == telemetryTiming->frameDelimiter && pending > 1) {
+    // the previous frame is complete, the delimiter is the first byte of the next one
+    pending = 1;
+    RTOS_ISR_SET_FLAG(telemetryFlag);
+  }
+  else if (pending >= telemetryTiming->wakeupBytes) {
+    pending = 0;
+    RTOS_ISR_SET_FLAG(telemetryFlag);
+  }
+  telemetryRxPending = pending;
+}
+
+// Called by the RX interrupts when the line goes idle at the end of a frame (RX by DMA)
+void telemetryRxIdleNotify()
+{
+  RTOS_ISR_SET_FLAG(telemetryFlag);
+}
+
+// A module answers a request after this delay (ms)
+void telemetryExpectResponse(uint32_t delay)
+{
+  telemetryScheduleTimer(TELEMETRY_TIMER_PROTOCOL, delay);
+  // the task recomputes its wait
+  RTOS_ISR_SET_FLAG(telemetryFlag);
+}
+#endif
+
+#if defined(SIMU) && defined(STM32)
+Fifo<uint8_t, TELEMETRY_FIFO_SIZE> simuTelemetryFifo;
+uint32_t simuTelemetryBytesRead = 0;
+
+static uint8_t telemetryReadByte(uint8_t * byte)
+{
+  if (telemetryGetByte(byte))
+    return 1;
+  if (simuTelemetryFifo.pop(*byte)) {
+    simuTelemetryBytesRead++;
+    return 1;
+  }
+  return 0;
+}
+#elif defined(STM32)
+#define telemetryReadByte(byte) telemetryGetByte(byte)
+#endif
+
 void telemetryWakeup()
 {
 #if defined(CPUARM)
+  uint32_t now = RTOS_GET_MS();
+  if (telemetryTimerExpired(TELEMETRY_TIMER_PROTOCOL, now)) {
+    telemetryScheduleTimer(TELEMETRY_TIMER_PROTOCOL, telemetryTiming->pollPeriod);
+  }
+  bool housekeeping = telemetryTimerExpired(TELEMETRY_TIMER_HOUSEKEEPING, now);
+  if (housekeeping) {
+    telemetryScheduleTimer(TELEMETRY_TIMER_HOUSEKEEPING, TELEMETRY_HOUSEKEEPING_PERIOD);
+  }
+
   uint8_t requiredTelemetryProtocol = modelTelemetryProtocol();
 #if defined(REVX)
   uint8_t requiredSerialInversion = g_model.moduleData[EXTERNAL_MODULE].invertedSerial;
@@ -112,12 +235,12 @@ void telemetryWakeup()
 
 #if defined(STM32)
   uint8_t data;
-  if (!moduleUpdateActive(EXTERNAL_MODULE) && telemetryGetByte(&data)) {
+  if (!moduleUpdateActive(EXTERNAL_MODULE) && telemetryReadByte(&data)) {
     LOG_TELEMETRY_WRITE_START();
     do {
       processTelemetryData(data);
       LOG_TELEMETRY_WRITE_BYTE(data);
-    } while (telemetryGetByte(&data));
+    } while (telemetryReadByte(&data));
   }
 #if defined(PCBNV14)
   if(!moduleUpdateActive(INTERNAL_MODULE) && moduleState[INTERNAL_MODULE].protocol == PROTOCOL_CHANNELS_AFHDS2 && intmoduleGetByte(&data)) {
@@ -154,6 +277,11 @@ void telemetryWakeup()
 #endif
 
 #if defined(CPUARM)
+  // the RX wakeups only parse the received data
+  if (!housekeeping) {
+    return;
+  }
+
   for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
     const TelemetrySensor & sensor = g_model.telemetrySensors[i];
     if (sensor.type == TELEM_TYPE_CALCULATED) {
@@ -394,6 +522,7 @@ void telemetryReset()
 void telemetryInit(uint8_t protocol)
 {
   telemetryProtocol = protocol;
+  telemetryScheduleInit(protocol);
 
   if (protocol == PROTOCOL_TELEMETRY_FRSKY_D) {
     telemetryPortInit(FRSKY_D_BAUDRATE, TELEMETRY_SERIAL_DEFAULT);
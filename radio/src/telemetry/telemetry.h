@@ -103,6 +103,31 @@ extern uint8_t telemetryState;
 extern uint8_t telemetryRxBuffer[TELEMETRY_RX_PACKET_SIZE];
 extern uint8_t telemetryRxBufferCount;
 
+#if defined(CPUARM)
+// The telemetry task is woken by the RX interrupt when a frame is likely complete,
+// these deadlines bound its latency when the RX path can't tell (DMA, simulator)
+enum TelemetryTimers {
+  TELEMETRY_TIMER_PROTOCOL,       // protocol polling slot or expected response
+  TELEMETRY_TIMER_HOUSEKEEPING,   // calculated sensors, vario and alarms
+  TELEMETRY_TIMERS_COUNT
+};
+
+#define TELEMETRY_HOUSEKEEPING_PERIOD  20 // ms
+
+void telemetryScheduleInit(uint8_t protocol);
+void telemetryScheduleTimer(uint8_t timer, uint32_t delay);
+uint32_t telemetryGetWakeupDelay();
+void telemetryRxNotify(uint8_t data);
+void telemetryRxIdleNotify();
+void telemetryExpectResponse(uint32_t delay);
+#endif
+
+#if defined(SIMU) && defined(STM32)
+// Replayed captures enter here instead of the UART (targets/simu/simutelemetry.cpp)
+extern Fifo<uint8_t, TELEMETRY_FIFO_SIZE> simuTelemetryFifo;
+extern uint32_t simuTelemetryBytesRead;
+#endif
+
 #if defined(SIMU)
     #define bswapu16 __builtin_bswap16
     #define bswaps16 __builtin_bswap16
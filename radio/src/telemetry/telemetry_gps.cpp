@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "opentx.h"
+
+// cos of each degree, 1.0 = GPS_TRIG_ONE
+static const uint32_t cosTable[91] = {
+  1073741824, 1073578288, 1073087729, 1072270298, 1071126243, 1069655912,
+  1067859754, 1065738315, 1063292242, 1060522280, 1057429273, 1054014162,
+  1050277989, 1046221891, 1041847103, 1037154959, 1032146887, 1026824413,
+  1021189159, 1015242840, 1008987269, 1002424350, 995556083, 988384560,
+  980911966, 973140576, 965072759, 956710970, 948057759, 939115760,
+  929887697, 920376381, 910584710, 900515665, 890172315, 879557810,
+  868675383, 857528349, 846120104, 834454122, 822533958, 810363241,
+  797945680, 785285058, 772385229, 759250125, 745883746, 732290163,
+  718473518, 704438018, 690187940, 675727625, 661061475, 646193961,
+  631129609, 615873009, 600428808, 584801711, 568996477, 553017922,
+  536870912, 520560366, 504091252, 487468587, 470697435, 453782903,
+  436730145, 419544355, 402230767, 384794656, 367241333, 349576144,
+  331804471, 313931728, 295963357, 277904834, 259761657, 241539355,
+  223243478, 204879599, 186453311, 167970228, 149435979, 130856211,
+  112236583, 93582766, 74900443, 56195305, 37473049, 18739379,
+  0
+};
+
+// atan(i/32) in 1/100 degree
+static const uint16_t atanTable[33] = {
+  0, 179, 358, 536, 713, 888, 1062, 1234, 1404, 1571,
+  1735, 1897, 2056, 2211, 2363, 2511, 2657, 2798, 2936, 3070,
+  3201, 3327, 3451, 3571, 3687, 3800, 3909, 4016, 4119, 4218,
+  4315, 4409, 4500
+};
+
+// 1/10^6 degree on a great circle in cm, << 16
+#define GPS_CM_PER_UNIT                728727
+// 1/10^6 degree on a great circle in dm, << 16
+#define GPS_DM_PER_UNIT                72873
+// 1/10^6 degree in radians, << 42
+#define GPS_RAD_PER_UNIT               76760
+// 1/10^6 degree in radians / 2, << 40
+#define GPS_HALF_RAD_PER_UNIT          9595
+// 1/10^6 degree / 2 in 1/100 degree, << 48 once multiplied by a Q15 sin
+#define GPS_HALF_CENTIDEGREE_PER_SIN   429497
+
+#define GPS_EARTH_RADIUS               6371000
+
+int32_t gpsCos(int32_t latitude)
+{
+  uint32_t angle = abs(latitude);
+  uint32_t index = angle / GPS_DEGREE;
+  if (index >= 90)
+    return 0;
+
+  // cos(a + f) = cos(a).(1 - f²/2) - sin(a).f, with f in radians << 32
+  int64_t cosA = cosTable[index];
+  int64_t sinA = cosTable[90 - index];
+  int64_t fraction = ((uint64_t)(angle - index * GPS_DEGREE) * GPS_RAD_PER_UNIT) >> 10;
+  return cosA - ((((cosA * fraction) >> 32) * fraction) >> 33) - ((sinA * fraction + (1LL << 31)) >> 32);
+}
+
+int32_t gpsSin(int32_t latitude)
+{
+  int32_t result = gpsCos(90 * GPS_DEGREE - abs(latitude));
+  return latitude < 0 ? -result : result;
+}
+
+// atan(a/b) in 1/100 degree, a <= b
+static uint32_t gpsAtan(uint32_t a, uint32_t b)
+{
+  while (b > 0x1FFFF) {
+    a >>= 1;
+    b >>= 1;
+  }
+  uint32_t ratio = (a << 14) / b;  // 1.0 = 1 << 14
+  uint32_t index = ratio >> 9;
+  if (index >= 32)
+    return atanTable[32];
+  uint32_t fraction = ratio & 0x1FF;
+  return atanTable[index] + (((atanTable[index + 1] - atanTable[index]) * fraction) >> 9);
+}
+
+// angle in 1/100 degree (0..35999)
+static uint32_t gpsAngle(int32_t east, int32_t north)
+{
+  uint32_t x = abs(east);
+  uint32_t y = abs(north);
+
+  // angle from the north axis in the quadrant
+  uint32_t angle = (x <= y) ? gpsAtan(x, y) : 9000 - gpsAtan(y, x);
+  if (north < 0)
+    angle = 18000 - angle;
+  if (east < 0 && angle)
+    angle = 36000 - angle;
+  return angle;
+}
+
+uint16_t gpsBearing(int32_t east, int32_t north)
+{
+  if (east == 0 && north == 0)
+    return 0;
+  return ((gpsAngle(east, north) + 5) / 10) % 3600;
+}
+
+static int32_t gpsLongitudeDelta(int32_t from, int32_t to)
+{
+  int32_t result = to - from;
+  if (result > 180 * GPS_DEGREE)
+    result -= 360 * GPS_DEGREE;
+  else if (result < -180 * GPS_DEGREE)
+    result += 360 * GPS_DEGREE;
+  return result;
+}
+
+// rounded to the nearest integer
+static uint32_t gpsSqrt(uint32_t value)
+{
+  uint32_t result = MathUtil::isqrt32(value);
+  if (value - result * result > result)
+    result += 1;
+  return result;
+}
+
+void gpsGetDistanceBearing(int32_t pilotLatitude, int32_t pilotLongitude, int32_t pilotCos,
+                           int32_t latitude, int32_t longitude, uint32_t * distance, uint16_t * bearing)
+{
+  int32_t dLat = latitude - pilotLatitude;
+  int32_t dLon = gpsLongitudeDelta(pilotLongitude, longitude);
+
+  if (abs(dLat) < GPS_DEGREE && abs(dLon) < 2 * GPS_DEGREE && abs(pilotLatitude) < 80 * GPS_DEGREE) {
+    // the sin only corrects second order terms, Q15 is enough
+    int32_t pilotSin = gpsSin(pilotLatitude) >> 15;
+    // cos of the mean latitude, first order from the pilot one
+    int32_t meanCos = pilotCos - (int32_t)(((((int64_t)pilotSin * dLat) << 15 >> 20) * GPS_HALF_RAD_PER_UNIT) >> 20);
+    int32_t north = ((int64_t)dLat * GPS_CM_PER_UNIT) >> 16;
+    int32_t east = ((((int64_t)dLon * meanCos) >> 30) * GPS_CM_PER_UNIT) >> 16;
+    if (abs(north) < GPS_LOCAL_DISTANCE * 100 && abs(east) < GPS_LOCAL_DISTANCE * 100) {
+      uint32_t northDm = (abs(north) + 5) / 10;
+      uint32_t eastDm = (abs(east) + 5) / 10;
+      // in m below 6.5km, the squares would not fit in 32 bits
+      if (northDm < 46000 && eastDm < 46000)
+        *distance = (gpsSqrt(northDm * northDm + eastDm * eastDm) + 5) / 10;
+      else
+        *distance = gpsSqrt(((northDm + 5) / 10) * ((northDm + 5) / 10) + ((eastDm + 5) / 10) * ((eastDm + 5) / 10));
+      if (east == 0 && north == 0) {
+        *bearing = 0;
+      }
+      else {
+        // the projection gives the bearing at the mean longitude, the meridians
+        // converge by dLon.sin(lat) in between
+        int32_t convergence = ((int64_t)dLon * pilotSin * GPS_HALF_CENTIDEGREE_PER_SIN) >> 48;
+        int32_t angle = gpsAngle(east, north) - convergence + 36000;
+        *bearing = ((angle + 5) / 10) % 3600;
+      }
+      return;
+    }
+  }
+
+  // haversine formula, on the whole latitude as the cached cos is not precise
+  // enough near the poles
+  const float unit = DEG_TO_RADf / GPS_DEGREE;
+  float lat1 = pilotLatitude * unit;
+  float lat2 = latitude * unit;
+  float cos1 = MathUtil::cosf(lat1);
+  float sin1 = MathUtil::sinf(lat1);
+  float cos2 = MathUtil::cosf(lat2);
+  float sinHalfLat = MathUtil::sinf(dLat * unit / 2);
+  float sinHalfLon = MathUtil::sinf(dLon * unit / 2);
+  float a = sinHalfLat * sinHalfLat + cos1 * cos2 * sinHalfLon * sinHalfLon;
+  if (a > 1)
+    a = 1;
+  *distance = uint32_t(2 * GPS_EARTH_RADIUS * atan2f(sqrtf(a), sqrtf(1 - a)) + 0.5f);
+
+  // cos1.sin2 - sin1.cos2.cos(dLon) without the cancellation
+  float y = MathUtil::sinf(dLon * unit) * cos2;
+  float x = MathUtil::sinf(dLat * unit) + 2 * sin1 * cos2 * sinHalfLon * sinHalfLon;
+  float angle = atan2f(y, x) * RAD_TO_DEGf * 10;
+  if (angle < 0)
+    angle += 3600;
+  *bearing = uint32_t(angle + 0.5f) % 3600;
+}
+
+int16_t gpsGetMoveNorth(int32_t fromLatitude, int32_t toLatitude)
+{
+  int32_t dLat = toLatitude - fromLatitude;
+  if (abs(dLat) > 20000)
+    return GPS_MOVE_INVALID;
+  return (dLat * GPS_DM_PER_UNIT) >> 16;
+}
+
+int16_t gpsGetMoveEast(int32_t fromLongitude, int32_t toLongitude, int32_t pilotCos)
+{
+  int32_t dLon = gpsLongitudeDelta(fromLongitude, toLongitude);
+  if (abs(dLon) > 20 * GPS_DEGREE)
+    return GPS_MOVE_INVALID;
+  int32_t dLonAtEquator = ((int64_t)dLon * pilotCos) >> 30;
+  if (abs(dLonAtEquator) > 20000)
+    return GPS_MOVE_INVALID;
+  return (dLonAtEquator * GPS_DM_PER_UNIT) >> 16;
+}
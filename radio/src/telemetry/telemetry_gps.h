@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _TELEMETRY_GPS_H_
+#define _TELEMETRY_GPS_H_
+
+#include <inttypes.h>
+
+// Coordinates are in 1/10^6 degree, distances in meters and bearings in
+// 1/10 degree, clockwise from the north
+
+#define GPS_DEGREE                     1000000
+#define GPS_TRIG_ONE                   (1 << 30)  // 1.0 for gpsCos() and gpsSin()
+
+// Table based, for the pilot position which is then cached
+int32_t gpsCos(int32_t latitude);
+int32_t gpsSin(int32_t latitude);
+
+// Bearing (0..3599) of a vector, 0 for a null vector
+uint16_t gpsBearing(int32_t east, int32_t north);
+
+// Distance and bearing from the pilot position, which cos is given. Fixed
+// point equirectangular projection around the pilot while the plane is less
+// than GPS_LOCAL_DISTANCE away, haversine formula beyond
+#define GPS_LOCAL_DISTANCE             30000
+void gpsGetDistanceBearing(int32_t pilotLatitude, int32_t pilotLongitude, int32_t pilotCos,
+                           int32_t latitude, int32_t longitude, uint32_t * distance, uint16_t * bearing);
+
+// Move (dm) between two close points, INT16_MIN if more than a few km
+#define GPS_MOVE_INVALID               INT16_MIN
+int16_t gpsGetMoveNorth(int32_t fromLatitude, int32_t toLatitude);
+int16_t gpsGetMoveEast(int32_t fromLongitude, int32_t toLongitude, int32_t pilotCos);
+
+#endif // _TELEMETRY_GPS_H_
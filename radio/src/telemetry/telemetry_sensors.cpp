@@ -23,15 +23,6 @@
 TelemetryItem telemetryItems[MAX_TELEMETRY_SENSORS];
 uint8_t allowNewSensors;
 
-// TODO in maths
-uint32_t getDistFromEarthAxis(int32_t latitude)
-{
-  uint32_t lat = abs(latitude) / 10000;
-  uint32_t angle2 = (lat*lat) / 10000;
-  uint32_t angle4 = angle2 * angle2;
-  return 139*(((uint32_t)10000000-((angle2*(uint32_t)123370)/81)+(angle4/25))/12500);
-}
-
 void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32_t unit, uint32_t prec)
 {
   int32_t newVal = val;
@@ -96,13 +87,14 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32
 #if defined(INTERNAL_GPS)
     if (gpsData.fix) {
       pilotLatitude = gpsData.latitude;
-      distFromEarthAxis = getDistFromEarthAxis(pilotLatitude);
+      pilotCos = gpsCos(pilotLatitude);
     }
 #endif
     if (!pilotLatitude) {
       pilotLatitude = newVal;
-      distFromEarthAxis = getDistFromEarthAxis(newVal);
+      pilotCos = gpsCos(newVal);
     }
+    gps.moveNorth = gpsGetMoveNorth(gps.latitude, newVal);
     gps.latitude = newVal;
     lastReceived = now();
     return;
@@ -116,7 +108,7 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32
     if (!pilotLongitude) {
       pilotLongitude = newVal;
     }
-    gps.longitude = newVal;
+    setGpsFix(newVal);
     lastReceived = now();
     return;
   }
@@ -205,10 +197,97 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32
     }
   }
 
-  value = newVal;
+  storeValue(newVal);
   lastReceived = now();
 }
 
+// Called with the longitude, the latitude of the fix is received before
+void TelemetryItem::setGpsFix(int32_t longitude)
+{
+  uint16_t now = get_tmr10ms();
+  uint16_t elapsed = now - gps.lastFix;
+  int16_t moveEast = gpsGetMoveEast(gps.longitude, longitude, pilotCos);
+  if (gps.moveNorth != GPS_MOVE_INVALID && moveEast != GPS_MOVE_INVALID && elapsed > 0 && elapsed < 500) {
+    uint32_t move = MathUtil::isqrt32(gps.moveNorth*gps.moveNorth + moveEast*moveEast);
+    gps.speed = min<uint32_t>(move * 1000 / elapsed, 0xFFFF);
+  }
+  gps.lastFix = now;
+  gps.moveNorth = 0;
+  gps.longitude = longitude;
+
+  if (pilotLatitude) {
+    gpsGetDistanceBearing(pilotLatitude, pilotLongitude, pilotCos, gps.latitude, longitude, &gps.distance, &gps.bearing);
+  }
+}
+
+int32_t getTelemetryAnnouncedValue(int32_t value, uint8_t prec, uint8_t & attr)
+{
+  attr = 0;
+  if (prec == 2) {
+    if (value >= 5000) {
+      value = div_and_round(value, 100);
+    }
+    else {
+      value = div_and_round(value, 10);
+      attr = PREC1;
+    }
+  }
+  else if (prec == 1) {
+    if (value >= 500) {
+      value = div_and_round(value, 10);
+    }
+    else {
+      attr = PREC1;
+    }
+  }
+  return value;
+}
+
+#define PRESENTATION_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+// Used by the logs and by the mixer (announcements): the cache is copied then checked against
+// the current value, and when it is updated its version is stored last, so that a reader
+// never gets fields computed for another value
+TelemetryValuePresentation TelemetryItem::getPresentation(const TelemetrySensor & sensor)
+{
+  TelemetryValuePresentation result = presentation;
+  PRESENTATION_BARRIER();
+  uint16_t version = valueVersion;
+  int32_t val = value;
+
+  // text is never empty once computed, clear() empties it
+  if (result.version == version && result.value == val && result.prec == sensor.prec && result.text[0]) {
+    return result;
+  }
+
+  memclear(&result, sizeof(result));
+  result.version = version;
+  result.prec = sensor.prec;
+  result.value = val;
+  result.announcedValue = getTelemetryAnnouncedValue(val, sensor.prec, result.attr);
+  char * s = result.text;
+  if (sensor.prec > 0) {
+    div_t qr = div((int)val, sensor.prec == 2 ? 100 : 10);
+    if (val < 0) *s++ = '-';
+    s = strAppendUnsigned(s, abs(qr.quot));
+    *s++ = '.';
+    strAppendUnsigned(s, abs(qr.rem), sensor.prec);
+  }
+  else {
+    strAppendSigned(s, val);
+  }
+
+  presentation.prec = result.prec;
+  presentation.value = result.value;
+  presentation.attr = result.attr;
+  presentation.announcedValue = result.announcedValue;
+  memcpy(presentation.text, result.text, sizeof(presentation.text));
+  PRESENTATION_BARRIER();
+  presentation.version = result.version;
+
+  return result;
+}
+
 void TelemetryItem::per10ms(const TelemetrySensor & sensor)
 {
   switch (sensor.formula) {
@@ -288,7 +367,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
 
     case TELEM_FORMULA_DIST:
       if (sensor.dist.gps) {
-        TelemetryItem gpsItem = telemetryItems[sensor.dist.gps-1];
+        TelemetryItem & gpsItem = telemetryItems[sensor.dist.gps-1];
         TelemetryItem * altItem = NULL;
         if (!gpsItem.isAvailable()) {
           return;
@@ -307,21 +386,15 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
             return;
           }
         }
-        uint32_t angle = abs(gpsItem.gps.latitude - gpsItem.pilotLatitude);
-        uint32_t dist = EARTH_RADIUS * angle / 1000000;
-        uint32_t result = dist*dist;
-
-        angle = abs(gpsItem.gps.longitude - gpsItem.pilotLongitude);
-        dist = gpsItem.distFromEarthAxis * angle / 1000000;
-        result += dist*dist;
-
-        // Length on ground (ignoring curvature of the earth)
-        result = MathUtil::isqrt32(result);
+        // ground distance computed on each fix
+        uint32_t result = gpsItem.gps.distance;
 
         if (altItem) {
-          dist = abs(altItem->value) / g_model.telemetrySensors[sensor.dist.alt-1].getPrecDivisor();
-          result = dist*dist + result*result;
-          result = MathUtil::isqrt32(result);
+          uint32_t alt = abs(altItem->value) / g_model.telemetrySensors[sensor.dist.alt-1].getPrecDivisor();
+          if (result < 46000 && alt < 46000)
+            result = MathUtil::isqrt32(alt*alt + result*result);
+          else
+            result = 10 * MathUtil::isqrt32((alt/10)*(alt/10) + (result/10)*(result/10));
         }
 
         setValue(sensor, result, UNIT_METERS);
@@ -476,6 +549,12 @@ int setTelemetryValue(TelemetryProtocol protocol, uint16_t id,
                       uint8_t subId, uint8_t instance,
                       int32_t value, uint32_t unit, uint32_t prec)
 {
+#if defined(SIMU)
+  // a text is given char by char, it counts once
+  if (simuTelemetryHook && (unit != UNIT_TEXT || prec == 0))
+    simuTelemetryHook();
+#endif
+
   bool sensorFound = false;
 
   for (int index = 0; index < MAX_TELEMETRY_SENSORS; index++) {
@@ -22,18 +22,31 @@
 #define _TELEMETRY_SENSORS_H_
 
 #include "telemetry.h"
+#include "telemetry_gps.h"
 
 #define TELEMETRY_VALUE_TIMER_CYCLE    128 /* x160ms ~= 20.5s ; must be multiple of 2 to avoid the modulo */
 #define TELEMETRY_VALUE_OLD_THRESHOLD  62 /* x160ms ~= 10s */
 #define TELEMETRY_VALUE_UNAVAILABLE    255
 #define TELEMETRY_VALUE_OLD            254
 
+// Current value of a sensor as shown in logs and announced by voice, computed
+// once per new value instead of once per consumer
+struct TelemetryValuePresentation
+{
+  uint16_t version;             // valueVersion it was computed for
+  uint8_t  prec;                // sensor precision it was computed with
+  int32_t  value;               // value it was computed for, valueVersion wraps
+  uint8_t  attr;                // PREC1 when the announced value keeps a decimal
+  int32_t  announcedValue;      // value rounded for voice announcements
+  char     text[14];            // value with the sensor precision, as written in logs
+};
+
 class TelemetryItem
 {
   public:
     union {
       int32_t  value;           // value, stored as uint32_t but interpreted accordingly to type
-      uint32_t distFromEarthAxis;
+      int32_t  pilotCos;        // cos(pilotLatitude), 1.0 = GPS_TRIG_ONE
     };
 
     union {
@@ -48,6 +61,10 @@ class TelemetryItem
 
     uint8_t lastReceived;       // for detection of sensor loss
 
+    uint16_t valueVersion;      // incremented each time a new value is stored
+
+    TelemetryValuePresentation presentation;
+
     union {
       struct {
         int32_t  offsetAuto;
@@ -69,11 +86,16 @@ class TelemetryItem
         uint8_t  sec;
       } datetime;
       struct {
-        int32_t latitude;
-        int32_t longitude;
+        int32_t  latitude;
+        int32_t  longitude;
+        uint32_t distance;      // m from the pilot, updated on each fix
+        uint16_t bearing;       // 1/10 degree from the pilot
+        uint16_t speed;         // cm/s between the last two fixes
+        uint16_t lastFix;       // 10ms
+        int16_t  moveNorth;     // dm since the last fix, when the latitude is received first
         // pilot longitude is stored in min
         // pilot latitude is stored in max
-        // distFromEarthAxis is stored in value
+        // cos of the pilot latitude is stored in value
       } gps;
       char text[16];
     };
@@ -100,6 +122,16 @@ class TelemetryItem
 
     void setValue(const TelemetrySensor & sensor, int32_t newVal, uint32_t unit, uint32_t prec=0);
 
+    void setGpsFix(int32_t longitude);
+
+    inline void storeValue(int32_t newVal)
+    {
+      value = newVal;
+      valueVersion++;
+    }
+
+    TelemetryValuePresentation getPresentation(const TelemetrySensor & sensor);
+
     inline bool isAvailable()
     {
       return (lastReceived != TELEMETRY_VALUE_UNAVAILABLE);
@@ -138,5 +170,6 @@ extern TelemetryItem telemetryItems[MAX_TELEMETRY_SENSORS];
 extern uint8_t allowNewSensors;
 bool isFaiForbidden(source_t idx);
 bool isValidIdAndInstance(uint16_t id, uint8_t instance);
+int32_t getTelemetryAnnouncedValue(int32_t value, uint8_t prec, uint8_t & attr);
 
 #endif // _TELEMETRY_SENSORS_H_
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <QtCore/QCoreApplication>
+#include "gbench.h"
+
+void benchReset()
+{
+  generalDefault();
+  g_eeGeneral.templateSetup = 0;
+  for (int i=0; i<NUM_SWITCHES; i++) {
+    simuSetSwitch(i, -1);
+  }
+
+  memset(&g_model, 0, sizeof(g_model));
+  memset(&anaInValues, 0, sizeof(anaInValues));
+  extern uint8_t s_mixer_first_run_done;
+  s_mixer_first_run_done = false;
+#if defined(GVARS)
+  invalidateGVarsCache();
+#endif
+
+  memset(channelOutputs, 0, sizeof(channelOutputs));
+  memset(chans, 0, sizeof(chans));
+  memset(ex_chans, 0, sizeof(ex_chans));
+  memset(act, 0, sizeof(act));
+  memset(swOn, 0, sizeof(swOn));
+  mixerCurrentFlightMode = lastFlightMode = 0;
+  logicalSwitchesReset();
+
+  modelDefault(0);
+#if defined(PCBTARANIS) || defined(PCBHORUS)
+  g_eeGeneral.switchConfig = 0x00007bff;
+#endif
+}
+
+void benchLoadModel(int mixes, int logicalSwitches)
+{
+  benchReset();
+
+  // standard curves with 5, 9 and 17 points, the last one smooth
+  static const int8_t curvePoints[] = { 5, 9, 17 };
+  int8_t * point = g_model.points;
+  for (unsigned i=0; i<DIM(curvePoints); i++) {
+    g_model.curves[i].type = CURVE_TYPE_STANDARD;
+    g_model.curves[i].points = curvePoints[i] - 5;
+    g_model.curves[i].smooth = (i == DIM(curvePoints) - 1);
+    for (int j=0; j<curvePoints[i]; j++) {
+      int x = -100 + (200 * j) / (curvePoints[i] - 1);
+      *point++ = x * abs(x) / 100;
+    }
+  }
+  loadCurves();
+
+  logicalSwitches = min<int>(logicalSwitches, MAX_LOGICAL_SWITCHES);
+  for (int i=0; i<logicalSwitches; i++) {
+    LogicalSwitchData * ls = lswAddress(i);
+    switch (i % 4) {
+      case 0:
+        ls->func = LS_FUNC_VPOS;
+        ls->v1 = MIXSRC_Rud + (i / 4) % NUM_STICKS;
+        ls->v2 = -50 + (i * 7) % 100;
+        break;
+      case 1:
+        ls->func = LS_FUNC_APOS;
+        ls->v1 = MIXSRC_FIRST_INPUT + (i / 4) % NUM_STICKS;
+        ls->v2 = 30;
+        break;
+      case 2:
+        ls->func = LS_FUNC_AND;
+        ls->v1 = SWSRC_FIRST_LOGICAL_SWITCH + i - 2;
+        ls->v2 = SWSRC_FIRST_LOGICAL_SWITCH + i - 1;
+        break;
+      case 3:
+        ls->func = LS_FUNC_DIFFEGREATER;
+        ls->v1 = MIXSRC_Rud + (i / 4) % NUM_STICKS;
+        ls->v2 = 10;
+        break;
+    }
+  }
+
+  memclear(g_model.mixData, sizeof(g_model.mixData));
+  mixes = min<int>(mixes, min<int>(MAX_MIXERS, 2 * MAX_OUTPUT_CHANNELS));
+  for (int i=0; i<mixes; i++) {
+    MixData * mix = mixAddress(i);
+    mix->destCh = i / 2;
+    mix->srcRaw = (i % 2) ? MIXSRC_Rud + (i / 2) % NUM_STICKS : MIXSRC_FIRST_INPUT + (i / 2) % NUM_STICKS;
+    mix->weight = 100 - (i % 3) * 25;
+    switch (i % 4) {
+      case 0:
+        mix->curve.type = CURVE_REF_DIFF;
+        mix->curve.value = 20;
+        break;
+      case 1:
+        mix->curve.type = CURVE_REF_EXPO;
+        mix->curve.value = 40;
+        break;
+      case 2:
+        mix->curve.type = CURVE_REF_CUSTOM;
+        mix->curve.value = 1 + (i / 4) % DIM(curvePoints);
+        break;
+    }
+    if ((i % 2) && logicalSwitches > 0) {
+      mix->swtch = SWSRC_FIRST_LOGICAL_SWITCH + (i / 2) % logicalSwitches;
+    }
+    if (i % 8 == 7) {
+      mix->speedUp = mix->speedDown = 10;
+    }
+  }
+}
+
+void benchMoveSticks(int step)
+{
+  for (int i=0; i<NUM_STICKS; i++) {
+    // the simulator reads calibrated values, a triangle in [-1024..1024]
+    int phase = (step * (i + 1) * 16 + i * 512) % 4096;
+    anaInValues[i] = (phase < 2048 ? phase : 4096 - phase) - RESX;
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+  simuHeadlessStart(NULL, NULL, NULL);
+  // in memory EEPROM, as in the gtests
+  StartEepromThread(NULL);
+  menuLevel = 0;
+  menuHandlers[0] = menuMainView;
+
+  // use --benchmark_format=json or --benchmark_out=<file> for a machine
+  // readable output, tools/bench-compare.py compares two of them
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef _GBENCH_H_
+#define _GBENCH_H_
+
+#include <benchmark/benchmark.h>
+
+#define SWAP_DEFINED
+#include "opentx.h"
+#include "targets/simu/simuheadless.h"
+
+// Same radio / model state as the gtests fixture
+void benchReset();
+
+// Representative model: curves with 5, 9 and 17 points, the given number of
+// mixes (two per channel, with diff / expo / custom curves, switches and
+// slow-downs) and logical switches (comparisons and boolean operations)
+void benchLoadModel(int mixes, int logicalSwitches);
+
+// Moves the sticks along a deterministic path, one step per call
+void benchMoveSticks(int step);
+
+#endif // _GBENCH_H_
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gbench.h"
+
+static void benchClearLcd()
+{
+#if defined(COLORLCD)
+  lcd->clear();
+#else
+  lcdClear();
+#endif
+}
+
+// Arg: text length
+static void BM_lcdDrawText(benchmark::State & state)
+{
+  char text[64];
+  for (int i=0; i<state.range(0); i++) {
+    text[i] = 'A' + i % 26;
+  }
+  text[state.range(0)] = '\0';
+  benchClearLcd();
+  for (auto _ : state) {
+    lcdDrawText(0, 0, text, 0);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_lcdDrawText)->Arg(4)->Arg(16)->Arg(32);
+
+// Arg: value, the number of digits grows with it
+static void BM_lcdDrawNumber(benchmark::State & state)
+{
+  benchClearLcd();
+  for (auto _ : state) {
+    lcdDrawNumber(0, 0, state.range(0), LEFT|PREC1);
+  }
+}
+BENCHMARK(BM_lcdDrawNumber)->Arg(5)->Arg(-1234)->Arg(12345);
+
+// Arg: side of the square
+static void BM_lcdDrawSolidFilledRect(benchmark::State & state)
+{
+  coord_t size = min<coord_t>(state.range(0), LCD_H);
+  benchClearLcd();
+  for (auto _ : state) {
+    lcdDrawSolidFilledRect(0, 0, size, size, 0);
+  }
+  state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_lcdDrawSolidFilledRect)->Arg(8)->Arg(32)->Arg(LCD_H);
+
+// Arg: 0 horizontal, 1 vertical, 2 diagonal
+static void BM_lcdDrawLine(benchmark::State & state)
+{
+  static const coord_t ends[][2] = { { LCD_W - 1, 0 }, { 0, LCD_H - 1 }, { LCD_W - 1, LCD_H - 1 } };
+  const coord_t * end = ends[state.range(0)];
+  benchClearLcd();
+  for (auto _ : state) {
+    lcdDrawLine(0, 0, end[0], end[1], SOLID, 0);
+  }
+}
+BENCHMARK(BM_lcdDrawLine)->DenseRange(0, 2);
+
+#if !defined(COLORLCD) && defined(CPUARM)
+void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags);
+
+// Arg: glyph flags, 0 or INVERS
+static void BM_lcdPutPattern(benchmark::State & state)
+{
+  static const uint8_t pattern[] = { 0x3e, 0x51, 0x49, 0x45, 0x3e };
+  int i = 0;
+  benchClearLcd();
+  for (auto _ : state) {
+    lcdPutPattern((i * 6) % (LCD_W - 6), (i * 8) % (LCD_H - 8), pattern, 5, 7, state.range(0));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_lcdPutPattern)->Arg(0)->Arg(INVERS);
+#endif
+
+#if defined(COLORLCD)
+// Arg: text flags, 0 or INVERS
+static void BM_bitmapBufferDrawText(benchmark::State & state)
+{
+  const char * text = "The quick brown fox jumps over the lazy dog";
+  BitmapBuffer dc(BMP_RGB565, LCD_W, LCD_H);
+  int i = 0;
+  dc.clear(TEXT_BGCOLOR);
+  for (auto _ : state) {
+    dc.drawText(0, (i * 20) % (LCD_H - 20), text, TEXT_COLOR | state.range(0));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations() * strlen(text));
+}
+BENCHMARK(BM_bitmapBufferDrawText)->Arg(0)->Arg(INVERS);
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gbench.h"
+
+// Args: number of mixes, number of logical switches
+static void mixerArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->Args({4, 0})->Args({16, 8})->Args({32, 16})->Args({64, 32});
+}
+
+static void BM_evalMixes(benchmark::State & state)
+{
+  benchLoadModel(state.range(0), state.range(1));
+  int step = 0;
+  for (auto _ : state) {
+    benchMoveSticks(step++);
+    evalMixes(1);
+    benchmark::DoNotOptimize(channelOutputs);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_evalMixes)->Apply(mixerArgs);
+
+static void BM_evalLogicalSwitches(benchmark::State & state)
+{
+  benchLoadModel(0, state.range(0));
+  int step = 0;
+  for (auto _ : state) {
+    benchMoveSticks(step++);
+    evalInputs(e_perout_mode_normal);
+    evalLogicalSwitches();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_evalLogicalSwitches)->Arg(8)->Arg(MAX_LOGICAL_SWITCHES);
+
+// All the switch sources, physical switches, trims and logical switches
+static void BM_getSwitch(benchmark::State & state)
+{
+  benchLoadModel(0, state.range(0));
+  evalLogicalSwitches();
+  for (auto _ : state) {
+    for (int i=SWSRC_FIRST_SWITCH; i<=SWSRC_LAST_LOGICAL_SWITCH; i++) {
+      benchmark::DoNotOptimize(getSwitch(i));
+      benchmark::DoNotOptimize(getSwitch(-i));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * (SWSRC_LAST_LOGICAL_SWITCH - SWSRC_FIRST_SWITCH + 1));
+}
+BENCHMARK(BM_getSwitch)->Arg(0)->Arg(MAX_LOGICAL_SWITCHES);
+
+// Arg: index in the curves below, x goes through the whole range
+static const struct {
+  const char * name;
+  uint8_t type;
+  int8_t value;
+} benchCurves[] = {
+  { "diff", CURVE_REF_DIFF, 20 },
+  { "expo", CURVE_REF_EXPO, 40 },
+  { "func", CURVE_REF_FUNC, CURVE_ABS_X },
+  { "custom5", CURVE_REF_CUSTOM, 1 },
+  { "custom9", CURVE_REF_CUSTOM, 2 },
+  { "smooth17", CURVE_REF_CUSTOM, 3 },
+};
+
+static void BM_applyCurve(benchmark::State & state)
+{
+  benchLoadModel(0, 0);
+  CurveRef curve;
+  curve.type = benchCurves[state.range(0)].type;
+  curve.value = benchCurves[state.range(0)].value;
+  state.SetLabel(benchCurves[state.range(0)].name);
+  for (auto _ : state) {
+    for (int x=-RESX; x<=RESX; x+=16) {
+      benchmark::DoNotOptimize(applyCurve(x, curve));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (2 * RESX / 16 + 1));
+}
+BENCHMARK(BM_applyCurve)->DenseRange(0, DIM(benchCurves) - 1);
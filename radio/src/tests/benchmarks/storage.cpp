@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gbench.h"
+
+#if defined(RAMBACKUP)
+// Arg: number of mixes of the model, 0 for an empty one
+static void benchModel(int mixes)
+{
+  if (mixes)
+    benchLoadModel(mixes, mixes / 2);
+  else
+    memset(&g_model, 0, sizeof(g_model));
+}
+
+static void BM_compress(benchmark::State & state)
+{
+  static uint8_t buffer[2 * sizeof(g_model)];
+  benchModel(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(compress(buffer, sizeof(buffer), (const uint8_t *)&g_model, sizeof(g_model)));
+  }
+  state.SetBytesProcessed(state.iterations() * sizeof(g_model));
+}
+BENCHMARK(BM_compress)->Arg(0)->Arg(16)->Arg(64);
+
+static void BM_uncompress(benchmark::State & state)
+{
+  static uint8_t buffer[2 * sizeof(g_model)];
+  static ModelData model;
+  benchModel(state.range(0));
+  unsigned size = compress(buffer, sizeof(buffer), (const uint8_t *)&g_model, sizeof(g_model));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(uncompress((uint8_t *)&model, sizeof(model), buffer, size));
+  }
+  state.SetBytesProcessed(state.iterations() * sizeof(g_model));
+}
+BENCHMARK(BM_uncompress)->Arg(0)->Arg(16)->Arg(64);
+
+// Arg: 0 full snapshot, 1 incremental snapshot after a limit change
+static void BM_rambackupWrite(benchmark::State & state)
+{
+  benchLoadModel(16, 8);
+  ramBackup->size = 0;
+  rambackupWrite();
+  uint32_t bytes = 0;
+  for (auto _ : state) {
+    if (state.range(0))
+      g_model.limitData[0].offset = (g_model.limitData[0].offset == 100 ? 123 : 100);
+    else
+      ramBackup->size = 0;
+    rambackupWrite();
+    bytes += rambackupStats.bytesWritten;
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_rambackupWrite)->Arg(0)->Arg(1);
+#endif
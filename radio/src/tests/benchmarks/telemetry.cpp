@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gbench.h"
+
+#if defined(TELEMETRY_FRSKY_SPORT)
+// Frames captured on the S.PORT line (FLVSS cells, FAS current, RSSI, GPS...)
+static const uint8_t sportCapture[][FRSKY_SPORT_PACKET_SIZE] = {
+  { 0x98, 0x10, 0x06, 0x00, 0x07, 0xD0, 0x00, 0x00, 0x12 },
+  { 0x98, 0x10, 0x06, 0x00, 0x17, 0xD0, 0x00, 0x00, 0x02 },
+  { 0x98, 0x10, 0x06, 0x00, 0x27, 0xD0, 0x00, 0x00, 0xF1 },
+  { 0x98, 0x10, 0x10, 0x00, 0x7E, 0x02, 0x00, 0x00, 0x5F },
+  { 0x1C, 0x31, 0x00, 0x10, 0x85, 0x64, 0x00, 0x00, 0xD4 },
+  { 0x48, 0x10, 0x00, 0x03, 0x30, 0x15, 0x50, 0x81, 0xD5 },
+};
+
+// Arg: number of different frames in the stream
+static void BM_sportProcessTelemetryPacket(benchmark::State & state)
+{
+  benchReset();
+  allowNewSensors = true;
+  telemetryProtocol = PROTOCOL_TELEMETRY_FRSKY_SPORT;
+  for (auto _ : state) {
+    for (int i=0; i<state.range(0); i++) {
+      sportProcessTelemetryPacket(sportCapture[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sportProcessTelemetryPacket)->Arg(1)->Arg(DIM(sportCapture));
+
+// The same frames as received byte per byte from the UART, with byte stuffing
+static void BM_processFrskyTelemetryData(benchmark::State & state)
+{
+  uint8_t stream[DIM(sportCapture) * (1 + 2 * FRSKY_SPORT_PACKET_SIZE)];
+  unsigned count = 0;
+  for (int i=0; i<state.range(0); i++) {
+    stream[count++] = START_STOP;
+    for (int j=0; j<FRSKY_SPORT_PACKET_SIZE; j++) {
+      uint8_t byte = sportCapture[i][j];
+      if (byte == START_STOP || byte == BYTE_STUFF) {
+        stream[count++] = BYTE_STUFF;
+        byte ^= STUFF_MASK;
+      }
+      stream[count++] = byte;
+    }
+  }
+
+  benchReset();
+  allowNewSensors = true;
+  telemetryProtocol = PROTOCOL_TELEMETRY_FRSKY_SPORT;
+  for (auto _ : state) {
+    for (unsigned i=0; i<count; i++) {
+      processFrskyTelemetryData(stream[i]);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_processFrskyTelemetryData)->Arg(1)->Arg(DIM(sportCapture));
+#endif
+
+#if defined(CROSSFIRE)
+static unsigned appendCrossfireFrame(uint8_t * stream, uint8_t id, const uint8_t * payload, uint8_t size)
+{
+  stream[0] = RADIO_ADDRESS;
+  stream[1] = size + 2;
+  stream[2] = id;
+  memcpy(&stream[3], payload, size);
+  stream[3 + size] = crc8(&stream[2], size + 1);
+  return size + 4;
+}
+
+// Battery, link statistics and attitude frames, byte per byte
+static void BM_processCrossfireTelemetryData(benchmark::State & state)
+{
+  static const uint8_t battery[] = { 0x00, 0x7B, 0x00, 0x2A, 0x00, 0x03, 0xE8, 0x50 };
+  static const uint8_t link[] = { 0x4A, 0x4C, 0x64, 0x0A, 0x00, 0x02, 0x03, 0x50, 0x64, 0x08 };
+  static const uint8_t attitude[] = { 0x01, 0x2C, 0xFE, 0xD4, 0x11, 0x94 };
+  uint8_t stream[3 * TELEMETRY_RX_PACKET_SIZE];
+  unsigned count = 0;
+  count += appendCrossfireFrame(&stream[count], BATTERY_ID, battery, sizeof(battery));
+  count += appendCrossfireFrame(&stream[count], LINK_ID, link, sizeof(link));
+  count += appendCrossfireFrame(&stream[count], ATTITUDE_ID, attitude, sizeof(attitude));
+
+  benchReset();
+  allowNewSensors = true;
+  telemetryProtocol = PROTOCOL_TELEMETRY_CROSSFIRE;
+  telemetryRxBufferCount = 0;
+  for (auto _ : state) {
+    for (unsigned i=0; i<count; i++) {
+      processCrossfireTelemetryData(stream[i]);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_processCrossfireTelemetryData);
+#endif
+
+#if defined(CPUARM)
+// Arg: distance from the pilot in m (local path below GPS_LOCAL_DISTANCE)
+static void BM_gpsGetDistanceBearing(benchmark::State & state)
+{
+  const int32_t pilotLatitude = 48858370;
+  const int32_t pilotLongitude = 2294481;
+  const int32_t pilotCos = gpsCos(pilotLatitude);
+  // 1m is ~9 units of latitude
+  int32_t offset = state.range(0) * 9;
+  uint32_t distance;
+  uint16_t bearing;
+  int i = 0;
+  for (auto _ : state) {
+    gpsGetDistanceBearing(pilotLatitude, pilotLongitude, pilotCos, pilotLatitude + offset, pilotLongitude + (i++ & 0xFF) * 10, &distance, &bearing);
+    benchmark::DoNotOptimize(distance);
+    benchmark::DoNotOptimize(bearing);
+  }
+}
+BENCHMARK(BM_gpsGetDistanceBearing)->Arg(100)->Arg(20000)->Arg(500000);
+
+// A whole fix on the GPS sensor, latitude then longitude
+static void BM_gpsFix(benchmark::State & state)
+{
+  benchReset();
+  TelemetryItem & item = telemetryItems[0];
+  item.clear();
+  const TelemetrySensor & sensor = g_model.telemetrySensors[0];
+  int32_t latitude = 48858370;
+  int32_t longitude = 2294481;
+  for (auto _ : state) {
+    latitude += 3;
+    longitude += 5;
+    g_tmr10ms += 10;
+    item.setValue(sensor, latitude, UNIT_GPS_LATITUDE);
+    item.setValue(sensor, longitude, UNIT_GPS_LONGITUDE);
+  }
+  benchmark::DoNotOptimize(item.gps.distance);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_gpsFix);
+#endif
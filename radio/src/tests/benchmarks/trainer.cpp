@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gbench.h"
+
+#if defined(SBUS)
+// Arg: 0 reference decoder (one byte at a time), 1 decoder used by the radio
+static void BM_sbusUnpackChannels(benchmark::State & state)
+{
+  uint8_t frames[64][SBUS_FRAME_SIZE];
+  int16_t channels[SBUS_CHANNELS];
+  void (*unpack)(const uint8_t *, int16_t *) = (state.range(0) ? sbusUnpackChannels : sbusUnpackChannelsBitwise);
+
+  srand(0);
+  for (int i=0; i<64; i++) {
+    for (int j=0; j<SBUS_FRAME_SIZE; j++) {
+      frames[i][j] = rand();
+    }
+  }
+
+  unsigned i = 0;
+  for (auto _ : state) {
+    unpack(frames[i++ & 63] + 1, channels);
+    benchmark::DoNotOptimize(channels);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_sbusUnpackChannels)->Arg(0)->Arg(1);
+#endif
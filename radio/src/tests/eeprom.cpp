@@ -20,6 +20,10 @@
 
 #include "gtests.h"
 
+#if defined(COLORLCD)
+#include "storage/modelslist.h"
+#endif
+
 extern const char * eepromFile;
 
 #if !defined(EEPROM) && defined(SDCARD)
@@ -35,13 +39,138 @@ PACK(struct RamBackupUncompressed {
 extern Backup::RamBackupUncompressed ramBackupUncompressed;
 TEST(Storage, BackupAndRestore)
 {
+  MODEL_RESET();
+  modelDefault(0);
+
+  rambackupWrite();
+  Backup::RamBackupUncompressed ramBackupWritten;
+  memcpy(&ramBackupWritten, &ramBackupUncompressed, sizeof(ramBackupUncompressed));
+  memset(&ramBackupUncompressed, 0xFF, sizeof(ramBackupUncompressed));
+
+  EXPECT_TRUE(rambackupRestore());
+  EXPECT_EQ(memcmp(&ramBackupUncompressed, &ramBackupWritten, sizeof(ramBackupUncompressed)), 0);
+}
+
+TEST(Storage, BackupIncremental)
+{
+  MODEL_RESET();
+  modelDefault(0);
+  g_model.limitData[0].offset = 100;
+
+  ramBackup->size = 0;
+  rambackupWrite();
+  uint16_t fullSize = rambackupStats.bytesWritten;
+  EXPECT_GT(rambackupStats.chunksWritten, 1);
+
+  // nothing changed
+  rambackupWrite();
+  EXPECT_EQ(rambackupStats.chunksWritten, 0);
+  EXPECT_EQ(rambackupStats.bytesWritten, 0);
 
+  // same compressed size, only this chunk is written
+  g_model.limitData[0].offset = 123;
   rambackupWrite();
-  Backup::RamBackupUncompressed ramBackupRestored;
-  if (uncompress((uint8_t *)&ramBackupRestored, sizeof(ramBackupRestored), ramBackup->data, ramBackup->size) != sizeof(ramBackupUncompressed))
-    TRACE("ERROR uncompress");
-  if (memcmp(&ramBackupUncompressed, &ramBackupRestored, sizeof(ramBackupUncompressed)) != 0)
-    TRACE("ERROR restore");
+  EXPECT_EQ(rambackupStats.chunksWritten, 1);
+  EXPECT_LT(rambackupStats.bytesWritten, fullSize);
+
+  // a change of the compressed size moves the next chunks
+  g_model.limitData[0].offset = 0;
+  rambackupWrite();
+  EXPECT_EQ(rambackupStats.chunksWritten, 1);
+
+  g_model.limitData[0].offset = 77;
+  EXPECT_TRUE(rambackupRestore());
+  EXPECT_EQ(g_model.limitData[0].offset, 0);
+}
+#endif
+
+#if !defined(EEPROM)
+TEST(Storage, ModelIdIndex)
+{
+  ModelIdIndex index;
+
+  MODEL_RESET();
+  modelDefault(0);
+  g_model.moduleData[INTERNAL_MODULE].type = MODULE_TYPE_XJT_PXX1;
+  g_model.moduleData[INTERNAL_MODULE].rfProtocol = RF_PROTO_X16;
+
+  g_model.header.modelId[INTERNAL_MODULE] = 1;
+  index.update("model1.bin", &g_model);
+  g_model.header.modelId[INTERNAL_MODULE] = 2;
+  index.update("model2.bin", &g_model);
+  EXPECT_EQ(index.getOtherUsersCount("model2.bin", INTERNAL_MODULE), 0);
+  EXPECT_EQ(index.findNextUnusedModelId("model2.bin", INTERNAL_MODULE, 63), 2);
+
+  // same receiver number
+  index.duplicate("model2.bin", "model3.bin");
+  EXPECT_EQ(index.getOtherUsersCount("model2.bin", INTERNAL_MODULE), 1);
+  EXPECT_EQ(index.findNextUnusedModelId("model3.bin", INTERNAL_MODULE, 63), 3);
+
+  int others = 0;
+  index.forEachOtherUser("model3.bin", INTERNAL_MODULE, [&](const char * filename) {
+    EXPECT_STREQ(filename, "model2.bin");
+    others++;
+  });
+  EXPECT_EQ(others, 1);
+
+  // another protocol does not clash
+  g_model.moduleData[INTERNAL_MODULE].rfProtocol = RF_PROTO_LR12;
+  index.update("model3.bin", &g_model);
+  EXPECT_EQ(index.getOtherUsersCount("model2.bin", INTERNAL_MODULE), 0);
+
+  index.remove("model1.bin");
+  EXPECT_EQ(index.find("model1.bin"), nullptr);
+  EXPECT_EQ(index.findNextUnusedModelId("model3.bin", INTERNAL_MODULE, 63), 1);
+
+  // all numbers used
+  EXPECT_EQ(index.findNextUnusedModelId("model2.bin", INTERNAL_MODULE, 1), 1);
+  g_model.moduleData[INTERNAL_MODULE].rfProtocol = RF_PROTO_X16;
+  g_model.header.modelId[INTERNAL_MODULE] = 1;
+  index.update("model3.bin", &g_model);
+  EXPECT_EQ(index.findNextUnusedModelId("model2.bin", INTERNAL_MODULE, 1), 0);
+}
+#endif
+
+#if defined(COLORLCD)
+TEST(Storage, ModelIdIndexDeletion)
+{
+  MODEL_RESET();
+  modelDefault(0);
+  g_model.moduleData[INTERNAL_MODULE].type = MODULE_TYPE_XJT_PXX1;
+  g_model.moduleData[INTERNAL_MODULE].rfProtocol = RF_PROTO_X16;
+
+  modelIdIndex.clear();
+  g_model.header.modelId[INTERNAL_MODULE] = 1;
+  modelIdIndex.update("model1.bin", &g_model);
+  modelIdIndex.duplicate("model1.bin", "model2.bin");
+  modelIdIndex.duplicate("model1.bin", "model3.bin");
+  g_model.header.modelId[INTERNAL_MODULE] = 2;
+  modelIdIndex.update("model4.bin", &g_model);
+  EXPECT_EQ(modelIdIndex.getOtherUsersCount("model1.bin", INTERNAL_MODULE), 2);
+  EXPECT_EQ(modelIdIndex.findNextUnusedModelId("model1.bin", INTERNAL_MODULE, 2), 0);
+
+  ModelsList list;
+  ModelsCategory * first = list.createCategory();
+  list.addModel(first, "model1.bin");
+  ModelCell * model2 = list.addModel(first, "model2.bin");
+  ModelsCategory * second = list.createCategory();
+  list.addModel(second, "model3.bin");
+  list.addModel(second, "model4.bin");
+
+  // the deleted model no longer uses its receiver number
+  list.removeModel(first, model2);
+  EXPECT_EQ(modelIdIndex.find("model2.bin"), nullptr);
+  EXPECT_EQ(modelIdIndex.getOtherUsersCount("model1.bin", INTERNAL_MODULE), 1);
+  EXPECT_EQ(modelIdIndex.findNextUnusedModelId("model1.bin", INTERNAL_MODULE, 2), 0);
+
+  // neither do the models of a deleted category
+  list.removeCategory(second);
+  EXPECT_EQ(modelIdIndex.find("model3.bin"), nullptr);
+  EXPECT_EQ(modelIdIndex.find("model4.bin"), nullptr);
+  EXPECT_EQ(modelIdIndex.getOtherUsersCount("model1.bin", INTERNAL_MODULE), 0);
+  EXPECT_EQ(modelIdIndex.findNextUnusedModelId("model1.bin", INTERNAL_MODULE, 2), 1);
+
+  modelIdIndex.clear();
 }
 #endif
 
@@ -181,6 +181,38 @@ TEST(FrSky, HubAltNegative)
   EXPECT_EQ(telemetryItems[0].value, 120);
 }
 
+TEST(FrSky, ValuePresentation)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+
+  allowNewSensors = true;
+
+  processHubPacket(BARO_ALT_BP_ID, 0);
+  processHubPacket(BARO_ALT_AP_ID, 0);
+  processHubPacket(BARO_ALT_BP_ID, -12);  // set value of -12.3m
+  processHubPacket(BARO_ALT_AP_ID, 3);
+  EXPECT_EQ(g_model.telemetrySensors[0].prec, 1);
+  EXPECT_STREQ(telemetryItems[0].getPresentation(g_model.telemetrySensors[0]).text, "-12.3");
+
+  processHubPacket(BARO_ALT_BP_ID, 0);  // set value of 0.7m
+  processHubPacket(BARO_ALT_AP_ID, 7);
+  TelemetryValuePresentation presentation = telemetryItems[0].getPresentation(g_model.telemetrySensors[0]);
+  EXPECT_STREQ(presentation.text, "0.7");
+  EXPECT_EQ(presentation.announcedValue, 7);
+  EXPECT_EQ(presentation.attr, PREC1);
+
+  // precision changed by the user
+  g_model.telemetrySensors[0].prec = 0;
+  EXPECT_STREQ(telemetryItems[0].getPresentation(g_model.telemetrySensors[0]).text, "7");
+
+  // the value version wraps back to the cached one with another value
+  for (int i=0; i<65536; i++) {
+    telemetryItems[0].storeValue(8);
+  }
+  EXPECT_STREQ(telemetryItems[0].getPresentation(g_model.telemetrySensors[0]).text, "8");
+}
+
 TEST(FrSky, Gps)
 {
   MODEL_RESET();
@@ -422,6 +454,8 @@ TEST(FrSkySPORT, frskySetCellVoltageTwoSensors)
   g_model.telemetrySensors[2].calc.sources[0] = 1;
   g_model.telemetrySensors[2].calc.sources[1] = 2;
 
+  // calculated sensors are evaluated at the housekeeping deadline
+  telemetryScheduleTimer(TELEMETRY_TIMER_HOUSEKEEPING, 0);
   telemetryWakeup();
 
   EXPECT_EQ(telemetryItems[2].value, 287);
@@ -434,6 +468,12 @@ TEST(FrSkySPORT, frskySetCellVoltageTwoSensors)
   generateSportCellPacket(packet, 3, 0, _V(420), _V(410)); sportProcessTelemetryPacket(packet);
   generateSportCellPacket(packet, 4, 0, _V(410), _V(420), DATA_ID_FLVSS+1); sportProcessTelemetryPacket(packet);
 
+  // the RX wakeups before the housekeeping deadline only parse the received data
+  telemetryScheduleTimer(TELEMETRY_TIMER_HOUSEKEEPING, 1000);
+  telemetryWakeup();
+  EXPECT_EQ(telemetryItems[2].value, 287);
+
+  telemetryScheduleTimer(TELEMETRY_TIMER_HOUSEKEEPING, 0);
   telemetryWakeup();
 
   EXPECT_EQ(telemetryItems[2].value, 283);
@@ -553,4 +593,27 @@ TEST(FrSkySPORT, frskyCurrent)
   EXPECT_EQ(telemetryItems[0].valueMax, 505);
 }
 
+TEST(FrSkySPORT, telemetryTaskWakeup)
+{
+  telemetryScheduleInit(PROTOCOL_TELEMETRY_FRSKY_SPORT);
+  EXPECT_LE(telemetryGetWakeupDelay(), 12u);
+
+  // empty polling slots: the task is woken when the next slot starts
+  telemetryFlag = 0;
+  telemetryRxNotify(0x7E);
+  telemetryRxNotify(0x1B);
+  EXPECT_EQ(telemetryFlag, 0u);
+  telemetryRxNotify(0x7E);
+  EXPECT_EQ(telemetryFlag, 1u);
+
+  // a complete frame wakes the task without waiting for the next slot
+  telemetryFlag = 0;
+  const uint8_t frame[] = { 0x1B, 0x10, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0xDD };
+  for (unsigned i=0; i<DIM(frame); i++) {
+    EXPECT_EQ(telemetryFlag, 0u);
+    telemetryRxNotify(frame[i]);
+  }
+  EXPECT_EQ(telemetryFlag, 1u);
+}
+
 #endif  //#if defined(TELEMETRY_FRSKY_SPORT)
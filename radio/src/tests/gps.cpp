@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#if defined(CPUARM)
+// Reference computations in double precision
+static void gpsReference(int32_t lat1, int32_t lon1, int32_t lat2, int32_t lon2, double * distance, double * bearing)
+{
+  double p1 = lat1 * 1e-6 * M_PI / 180;
+  double p2 = lat2 * 1e-6 * M_PI / 180;
+  double dp = p2 - p1;
+  double dl = (lon2 - lon1) * 1e-6 * M_PI / 180;
+  double a = sin(dp/2) * sin(dp/2) + cos(p1) * cos(p2) * sin(dl/2) * sin(dl/2);
+  *distance = 2 * 6371000 * atan2(sqrt(a), sqrt(1 - a));
+  *bearing = fmod(atan2(sin(dl) * cos(p2), cos(p1) * sin(p2) - sin(p1) * cos(p2) * cos(dl)) * 180 / M_PI + 360, 360);
+}
+
+// Point at the given distance (m) and bearing (degrees)
+static void gpsDestination(int32_t lat, int32_t lon, double distance, double bearing, int32_t * lat2, int32_t * lon2)
+{
+  double p1 = lat * 1e-6 * M_PI / 180;
+  double l1 = lon * 1e-6 * M_PI / 180;
+  double d = distance / 6371000;
+  double t = bearing * M_PI / 180;
+  double p2 = asin(sin(p1) * cos(d) + cos(p1) * sin(d) * cos(t));
+  double l2 = l1 + atan2(sin(t) * sin(d) * cos(p1), cos(d) - sin(p1) * sin(p2));
+  *lat2 = lround(p2 * 180 / M_PI * 1e6);
+  int32_t result = lround(l2 * 180 / M_PI * 1e6);
+  if (result >= 180 * GPS_DEGREE)
+    result -= 360 * GPS_DEGREE;
+  else if (result < -180 * GPS_DEGREE)
+    result += 360 * GPS_DEGREE;
+  *lon2 = result;
+}
+
+static double gpsAngleError(double a, double b)
+{
+  double result = fabs(a - b);
+  return result > 180 ? 360 - result : result;
+}
+
+TEST(Gps, trigonometry)
+{
+  for (int32_t lat=-90*GPS_DEGREE; lat<=90*GPS_DEGREE; lat+=1234) {
+    double angle = lat * 1e-6 * M_PI / 180;
+    EXPECT_NEAR(cos(angle), double(gpsCos(lat)) / GPS_TRIG_ONE, 2e-6);
+    EXPECT_NEAR(sin(angle), double(gpsSin(lat)) / GPS_TRIG_ONE, 2e-6);
+  }
+}
+
+TEST(Gps, bearing)
+{
+  EXPECT_EQ(0, gpsBearing(0, 0));
+  EXPECT_EQ(0, gpsBearing(0, 100));
+  EXPECT_EQ(450, gpsBearing(100, 100));
+  EXPECT_EQ(900, gpsBearing(100, 0));
+  EXPECT_EQ(1800, gpsBearing(0, -100));
+  EXPECT_EQ(2250, gpsBearing(-100, -100));
+  EXPECT_EQ(2700, gpsBearing(-100, 0));
+  for (int angle=0; angle<3600; angle+=7) {
+    double radians = angle * M_PI / 1800;
+    EXPECT_NEAR(angle, gpsBearing(lround(1000000 * sin(radians)), lround(1000000 * cos(radians))), 1);
+  }
+}
+
+TEST(Gps, distanceBearingWorldwide)
+{
+  static const double distances[] = { 100, 1000, 5000, 15000, 29000, 60000, 500000, 5000000 };
+  for (int32_t lat=-88*GPS_DEGREE; lat<=88*GPS_DEGREE; lat+=4*GPS_DEGREE+123456) {
+    for (int32_t lon=-180*GPS_DEGREE; lon<180*GPS_DEGREE; lon+=45*GPS_DEGREE+654321) {
+      for (unsigned i=0; i<DIM(distances); i++) {
+        for (int direction=0; direction<360; direction+=40) {
+          int32_t lat2, lon2;
+          gpsDestination(lat, lon, distances[i], direction + 5, &lat2, &lon2);
+          double distance, bearing;
+          gpsReference(lat, lon, lat2, lon2, &distance, &bearing);
+          uint32_t result;
+          uint16_t resultBearing;
+          gpsGetDistanceBearing(lat, lon, gpsCos(lat), lat2, lon2, &result, &resultBearing);
+          if (distance < GPS_LOCAL_DISTANCE)
+            EXPECT_NEAR(distance, result, 2) << lat << " " << lon << " " << lat2 << " " << lon2;
+          else
+            EXPECT_NEAR(distance, result, distance * 1e-4) << lat << " " << lon << " " << lat2 << " " << lon2;
+          EXPECT_LE(gpsAngleError(bearing, resultBearing / 10.0), 0.2) << lat << " " << lon << " " << lat2 << " " << lon2;
+        }
+      }
+    }
+  }
+}
+
+TEST(Gps, distanceAcrossAntimeridian)
+{
+  uint32_t distance;
+  uint16_t bearing;
+  gpsGetDistanceBearing(0, 179999000, gpsCos(0), 0, -179999000, &distance, &bearing);
+  EXPECT_NEAR(222, distance, 1);
+  EXPECT_EQ(900, bearing);
+  gpsGetDistanceBearing(0, -179999000, gpsCos(0), 0, 179999000, &distance, &bearing);
+  EXPECT_NEAR(222, distance, 1);
+  EXPECT_EQ(2700, bearing);
+}
+
+TEST(Gps, sensorFix)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  TelemetryItem & item = telemetryItems[0];
+  item.clear();
+  const TelemetrySensor & sensor = g_model.telemetrySensors[0];
+
+  // the first fix is the pilot position
+  item.setValue(sensor, 48858370, UNIT_GPS_LATITUDE);
+  item.setValue(sensor, 2294481, UNIT_GPS_LONGITUDE);
+  EXPECT_EQ(48858370, item.pilotLatitude);
+  EXPECT_EQ(2294481, item.pilotLongitude);
+  EXPECT_EQ(0u, item.gps.distance);
+
+  // 20m North-East in 2s
+  int32_t lat, lon;
+  gpsDestination(48858370, 2294481, 20, 45, &lat, &lon);
+  g_tmr10ms += 200;
+  item.setValue(sensor, lat, UNIT_GPS_LATITUDE);
+  item.setValue(sensor, lon, UNIT_GPS_LONGITUDE);
+  EXPECT_NEAR(20, item.gps.distance, 1);
+  EXPECT_NEAR(450, item.gps.bearing, 10);
+  EXPECT_NEAR(1000, item.gps.speed, 30);
+
+  // 1km further in 10s, the pilot position is kept
+  gpsDestination(lat, lon, 1000, 45, &lat, &lon);
+  g_tmr10ms += 1000;
+  item.setValue(sensor, lat, UNIT_GPS_LATITUDE);
+  item.setValue(sensor, lon, UNIT_GPS_LONGITUDE);
+  EXPECT_NEAR(1020, item.gps.distance, 1);
+  EXPECT_NEAR(450, item.gps.bearing, 2);
+  EXPECT_NEAR(10000, item.gps.speed, 100);
+  EXPECT_EQ(48858370, item.pilotLatitude);
+}
+#endif
@@ -61,6 +61,9 @@ inline void MODEL_RESET()
   extern uint8_t s_mixer_first_run_done;
   s_mixer_first_run_done = false;
   lastFlightMode = 255;
+#if defined(GVARS) && !defined(PCBSTD)
+  invalidateGVarsCache();
+#endif
 }
 
 inline void MIXER_RESET()
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+class GVarsTest : public OpenTxTest {};
+
+#if defined(GVARS) && !defined(PCBSTD)
+// link to flight mode 'target' as stored in the model (the current one is skipped)
+static int16_t gvarLink(uint8_t fm, uint8_t target)
+{
+  return GVAR_MAX + 1 + (target > fm ? target - 1 : target);
+}
+
+static void checkGVarsResolution()
+{
+  for (uint8_t fm=0; fm<MAX_FLIGHT_MODES; fm++) {
+    for (uint8_t gv=0; gv<MAX_GVARS; gv++) {
+      uint8_t resolved = resolveGVarFlightMode(fm, gv);
+      EXPECT_EQ(getGVarFlightMode(fm, gv), resolved) << "FM" << (int)fm << " GV" << (int)gv + 1;
+      EXPECT_EQ(getGVarValue(gv, fm), GVAR_VALUE(gv, resolved)) << "FM" << (int)fm << " GV" << (int)gv + 1;
+      EXPECT_EQ(getGVarValue(-1-gv, fm), -GVAR_VALUE(gv, resolved)) << "FM" << (int)fm << " GV" << (int)gv + 1;
+    }
+  }
+}
+
+TEST_F(GVarsTest, FlightModeChain)
+{
+  setGVarValue(0, 100, 0);
+  GVAR_VALUE(0, 1) = gvarLink(1, 2);
+  GVAR_VALUE(0, 2) = gvarLink(2, 0);
+  storageDirty(EE_MODEL);
+  EXPECT_EQ(getGVarFlightMode(1, 0), 0);
+  EXPECT_EQ(getGVarValue(0, 1), 100);
+
+  setGVarValue(0, 50, 2);
+  EXPECT_EQ(getGVarFlightMode(1, 0), 2);
+  EXPECT_EQ(getGVarValue(0, 1), 50);
+  EXPECT_EQ(getGVarValue(0, 0), 100);
+
+  // a write through an inherited flight mode updates the flight mode owning the value
+  setGVarValue(0, 20, 1);
+  EXPECT_EQ(GVAR_VALUE(0, 2), 20);
+  EXPECT_EQ(getGVarValue(0, 1), 20);
+}
+
+TEST_F(GVarsTest, CacheMatchesChainResolution)
+{
+  srand(0x5EED);
+  for (int round=0; round < 200; round++) {
+    uint8_t fm = rand() % MAX_FLIGHT_MODES;
+    uint8_t gv = rand() % MAX_GVARS;
+    if (fm > 0 && rand() % 2) {
+      // link to another flight mode, loops are resolved to flight mode 0
+      GVAR_VALUE(gv, fm) = gvarLink(fm, (fm + 1 + rand() % (MAX_FLIGHT_MODES - 1)) % MAX_FLIGHT_MODES);
+      storageDirty(EE_MODEL);
+    }
+    else {
+      setGVarValue(gv, rand() % 200 - 100, fm);
+    }
+    checkGVarsResolution();
+  }
+}
+#endif
@@ -486,5 +486,151 @@ TEST(Lcd, lcdDrawLine)
 
   EXPECT_TRUE(checkScreenshot("lcdDrawLine"));
 }
+
+#if defined(CPUARM)
+void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags);
+
+// pixel by pixel glyph rendering, as lcdPutPattern() did before writing whole columns
+void referencePutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
+{
+  bool blink = false;
+  bool inv = false;
+  if (flags & BLINK) {
+    if (BLINK_ON_PHASE) {
+      if (flags & INVERS)
+        inv = true;
+      else
+        blink = true;
+    }
+  }
+  else if (flags & INVERS) {
+    inv = true;
+  }
+
+  uint8_t lines = (height+7)/8;
+
+  for (int8_t i=0; i<(int8_t)(width+2); i++) {
+    if (x<LCD_W) {
+      uint8_t b[5] = { 0 };
+      if (i==0) {
+        if (x==0 || !inv) {
+          lcdNextPos++;
+          continue;
+        }
+        else {
+          x--;
+        }
+      }
+      else if (i<=width) {
+        uint8_t skip = true;
+        for (uint8_t j=0; j<lines; j++) {
+          b[j] = *pattern++;
+          if (b[j] != 0xff) {
+            skip = false;
+          }
+        }
+        if (skip) {
+          if (flags & FIXEDWIDTH) {
+            for (uint8_t j=0; j<lines; j++) {
+              b[j] = 0;
+            }
+          }
+          else {
+            continue;
+          }
+        }
+#if LCD_W < 212
+        if ((flags & CONDENSED) && i==2) {
+          continue;
+        }
+#endif
+      }
+
+      for (int8_t j=-1; j<=(int8_t)height; j++) {
+        bool plot;
+        if (j < 0 || ((j == height) && !(FONTSIZE(flags) == SMLSIZE))) {
+          plot = false;
+          if (height >= 12) continue;
+          if (j<0 && !inv) continue;
+          if (y+j < 0) continue;
+        }
+        else {
+          plot = b[j / 8] & (1 << (j % 8));
+        }
+        if (inv) plot = !plot;
+        if (!blink) {
+          if (flags & VERTICAL)
+            lcdDrawPoint(y+j, LCD_H-x, plot ? FORCE : ERASE);
+          else
+            lcdDrawPoint(x, y+j, plot ? FORCE : ERASE);
+        }
+      }
+    }
+    x++;
+    lcdNextPos++;
+  }
+}
+
+struct GlyphFormat {
+  uint8_t width;
+  uint8_t height;
+  LcdFlags flags;
+};
+
+static const GlyphFormat glyphFormats[] = {
+  { 3, 5, TINSIZE },
+  { 5, 6, SMLSIZE },
+  { 5, 7, 0 },
+  { 8, 12, MIDSIZE },
+  { 10, 16, DBLSIZE },
+  { 22, 38, XXLSIZE },
+};
+
+TEST(Lcd, PatternColumnsMatchPixels)
+{
+  uint8_t pattern[22*5];
+  uint8_t background[DISPLAY_BUFFER_SIZE];
+  uint8_t expected[DISPLAY_BUFFER_SIZE];
+
+  srand(0x1CD);
+  for (int round=0; round<5000; round++) {
+    const GlyphFormat & format = glyphFormats[rand() % DIM(glyphFormats)];
+    for (unsigned int i=0; i<sizeof(pattern); i++) {
+      // some blank (0xff) columns to exercise the proportional spacing
+      pattern[i] = (rand() % 8 == 0) ? 0xff : rand();
+    }
+#if LCD_W < 212
+    // lcdDrawPoint() doesn't clip negative coordinates on this LCD
+    coord_t x = rand() % (LCD_W + 10);
+    coord_t y = rand() % (LCD_H + 10);
+#else
+    coord_t x = rand() % (LCD_W + 20) - 10;
+    coord_t y = rand() % (LCD_H + 20) - 10;
+#endif
+    LcdFlags flags = format.flags;
+    if (rand() % 2) flags |= INVERS;
+    if (rand() % 4 == 0) flags |= FIXEDWIDTH;
+#if LCD_W < 212
+    if (rand() % 4 == 0) flags |= CONDENSED;
+#endif
+    for (unsigned int i=0; i<sizeof(background); i++) {
+      background[i] = rand();
+    }
+
+    memcpy(displayBuf, background, sizeof(background));
+    lcdNextPos = 0;
+    referencePutPattern(x, y, pattern, format.width, format.height, flags);
+    coord_t expectedNextPos = lcdNextPos;
+    memcpy(expected, displayBuf, sizeof(expected));
+
+    memcpy(displayBuf, background, sizeof(background));
+    lcdNextPos = 0;
+    lcdPutPattern(x, y, pattern, format.width, format.height, flags);
+
+    ASSERT_EQ(memcmp(displayBuf, expected, sizeof(expected)), 0) << "x=" << x << " y=" << y << " flags=" << std::hex << flags;
+    ASSERT_EQ(lcdNextPos, expectedNextPos);
+  }
+}
+#endif // #if defined(CPUARM)
 #endif
 #endif
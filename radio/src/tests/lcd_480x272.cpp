@@ -170,4 +170,55 @@ TEST(Lcd_480x272, fonts)
 }
 
 
+// Draws the text glyph by glyph with the pixel by pixel pattern function
+static void referenceDrawText(BitmapBuffer * dc, coord_t x, coord_t y, const char * s, LcdFlags flags)
+{
+  uint32_t fontindex = FONTINDEX(flags);
+  const uint8_t * font = fontsTable[fontindex];
+  const uint16_t * fontspecs = fontspecsTable[fontindex];
+  while (*s) {
+    x += dc->drawCharWithoutCache(x-1, y, font, fontspecs, getMappedChar(*s++), flags);
+  }
+}
+
+static void fillBackground(BitmapBuffer * dc)
+{
+  for (int y=0; y<LCD_H; y++) {
+    for (int x=0; x<LCD_W; x++) {
+      dc->drawPixel(x, y, (x * 37 + y * 11) ^ (y << 8));
+    }
+  }
+}
+
+TEST(Lcd_480x272, textSpansMatchPattern)
+{
+  static const LcdFlags fonts[] = { 0, TINSIZE, SMLSIZE, MIDSIZE, DBLSIZE, BOLD };
+  static const LcdFlags colors[] = { TEXT_COLOR, TEXT_INVERTED_COLOR, ALARM_COLOR, TITLE_BGCOLOR };
+  const char * text = "The quick brown fox jumps 0123456789 %&@";
+
+  BitmapBuffer spans(BMP_RGB565, LCD_W, LCD_H);
+  BitmapBuffer pattern(BMP_RGB565, LCD_W, LCD_H);
+
+  for (unsigned f=0; f<DIM(fonts); f++) {
+    for (unsigned c=0; c<DIM(colors); c++) {
+      // the last cases are clipped on each side
+      for (int clip=0; clip<2; clip++) {
+        coord_t x = clip ? -7 : 3;
+        coord_t y = clip ? -5 : 40 + 10 * c;
+        fillBackground(&spans);
+        fillBackground(&pattern);
+        if (clip) {
+          spans.setClippingRect(20, 300, 2, 200);
+          pattern.setClippingRect(20, 300, 2, 200);
+        }
+        spans.drawText(x, y, text, fonts[f] | colors[c]);
+        referenceDrawText(&pattern, x, y, text, fonts[f] | colors[c]);
+        spans.clearClippingRect();
+        pattern.clearClippingRect();
+        ASSERT_EQ(0, memcmp(spans.getData(), pattern.getData(), LCD_W * LCD_H * sizeof(display_t))) << "font " << f << " color " << c << " clip " << clip;
+      }
+    }
+  }
+}
+
 #endif
\ No newline at end of file
@@ -25,6 +25,11 @@
 
 #define SWAP_DEFINED
 #include "opentx.h"
+#include "location.h"
+
+extern "C" {
+  #include <lundump.h>
+}
 
 extern const char * zchar2string(const char * zstring, int size);
 #define EXPECT_ZSTREQ(c_string, z_string)   EXPECT_STREQ(c_string, zchar2string(z_string, sizeof(z_string)))
@@ -165,4 +170,162 @@ TEST(Lua, testModelInputs)
 
 }
 
+static int luaTestDumpWriter(lua_State * L, const void * p, size_t size, void * u)
+{
+  ((std::string *)u)->append((const char *)p, size);
+  return 0;
+}
+
+static uint32_t luaTestHeapUsed(lua_State * L)
+{
+  return lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
+// heap used by the loaded function only, the parser buffers are collected
+static uint32_t luaTestLoadHeap(const std::string & chunk, lua_Number & result)
+{
+  lua_State * L = luaL_newstate();
+  lua_gc(L, LUA_GCCOLLECT, 0);
+  uint32_t before = luaTestHeapUsed(L);
+  EXPECT_EQ(LUA_OK, luaL_loadbuffer(L, chunk.data(), chunk.size(), "=test"));
+  lua_gc(L, LUA_GCCOLLECT, 0);
+  uint32_t used = luaTestHeapUsed(L) - before;
+  EXPECT_EQ(LUA_OK, lua_pcall(L, 0, 1, 0));
+  result = lua_tonumber(L, -1);
+  lua_close(L);
+  return used;
+}
+
+TEST(Lua, testBytecodeHeapUsage)
+{
+  static const char * const scripts[] = {
+    "local function sum(n) local s = 0 for i = 1, n do s = s + i end return s end "
+    "return sum(100)",
+
+    "local items = {} "
+    "local function add(name, value) items[#items+1] = { name = name, value = value } end "
+    "local function find(name) for i = 1, #items do if items[i].name == name then return items[i].value end end return 0 end "
+    "local function init() add('alt', 120) add('speed', 35) add('rssi', 87) add('vbat', 74) end "
+    "local function background() for i = 1, #items do items[i].value = items[i].value + 1 end end "
+    "local function run(event) if event == 1 then background() end return find('rssi') + find('alt') * 2 + find('vbat') end "
+    "init() background() "
+    "return run(1) + run(0) + #items",
+  };
+
+  for (unsigned i = 0; i < DIM(scripts); i++) {
+    // the bytecode as saved by luaDumpState(), with and without the debug info
+    std::string bytecode, stripped;
+    lua_State * L = luaL_newstate();
+    ASSERT_EQ(LUA_OK, luaL_loadbuffer(L, scripts[i], strlen(scripts[i]), "=test"));
+    luaU_dump(L, getproto(L->top - 1), luaTestDumpWriter, &bytecode, 0);
+    luaU_dump(L, getproto(L->top - 1), luaTestDumpWriter, &stripped, 1);
+    lua_close(L);
+
+    lua_Number result, binaryResult, strippedResult;
+    uint32_t heapSource = luaTestLoadHeap(scripts[i], result);
+    uint32_t heapBinary = luaTestLoadHeap(bytecode, binaryResult);
+    uint32_t heapStripped = luaTestLoadHeap(stripped, strippedResult);
+    EXPECT_EQ(result, binaryResult);
+    EXPECT_EQ(result, strippedResult);
+    EXPECT_LT(heapStripped, heapBinary);
+
+    char name[32];
+    sprintf(name, "script%u_heap_source", i);
+    RecordProperty(name, heapSource);
+    sprintf(name, "script%u_heap_binary", i);
+    RecordProperty(name, heapBinary);
+    sprintf(name, "script%u_heap_stripped", i);
+    RecordProperty(name, heapStripped);
+  }
+}
+
+#if defined(LUA_COMPILER)
+// heap used by a script file loaded with luaLoadScriptFileToState()
+static uint32_t luaTestFileHeap(const char * filename, const char * mode, lua_Number & result)
+{
+  lua_State * L = luaL_newstate();
+  lua_gc(L, LUA_GCCOLLECT, 0);
+  uint32_t before = luaTestHeapUsed(L);
+  EXPECT_EQ(SCRIPT_OK, luaLoadScriptFileToState(L, filename, mode));
+  lua_gc(L, LUA_GCCOLLECT, 0);
+  uint32_t used = luaTestHeapUsed(L) - before;
+  EXPECT_EQ(LUA_OK, lua_pcall(L, 0, 1, 0));
+  result = lua_tonumber(L, -1);
+  lua_close(L);
+  return used;
+}
+
+TEST(Lua, testCompiledScriptStripped)
+{
+  FILE * f = fopen("/tmp/luatest.lua", "w");
+  ASSERT_TRUE(f != NULL);
+  fputs("local function sum(n) local s = 0 for i = 1, n do s = s + i end return s end return sum(100)", f);
+  fclose(f);
+
+  // "c" compiles the source each time, "d" keeps the debug info
+  lua_Number debugResult, strippedResult;
+  uint32_t heapDebug = luaTestFileHeap("/tmp/luatest.lua", "tcd", debugResult);
+  uint32_t heapStripped = luaTestFileHeap("/tmp/luatest.lua", "tc", strippedResult);
+  EXPECT_EQ(5050, debugResult);
+  EXPECT_EQ(5050, strippedResult);
+  EXPECT_LT(heapStripped, heapDebug);
+
+  remove("/tmp/luatest.lua");
+  remove("/tmp/luatest.luac");
+}
+#endif
+
+TEST(Lua, testDisplayList)
+{
+  luaExecStr("list = lcd.newList(4)");
+  luaExecStr("if pcall(list.addGauge, list, 2, 40, 50, 8, 1, 0) then error('invalid maxfill') end");
+  luaExecStr("if pcall(list.addText, list, 2, 3) then error('missing text') end");
+  luaExecStr("if list:getCount() ~= 0 then error('failed add') end");
+  luaExecStr("i = list:addText(2, 3, 'Alt') if i ~= 1 then error('addText()') end");
+  luaExecStr("i = list:addNumber(2, 20, 42, LEFT) if i ~= 2 then error('addNumber()') end");
+  luaExecStr("i = list:addGauge(2, 40, 50, 8, 1, 2) if i ~= 3 then error('addGauge()') end");
+  luaExecStr("i = list:addLine(0, 0, 10, 10, SOLID, 0) if i ~= 4 then error('addLine()') end");
+  luaExecStr("if pcall(list.addText, list, 0, 0, 'full') then error('capacity') end");
+  luaExecStr("list:setText(1, 'Altitude') list:setValue(2, 43) list:setValue(3, 3, 4)");
+  luaExecStr("list:setPosition(4, 1000, 1000) list:setFlags(1, INVERS) list:setVisible(2, false)");
+  luaExecStr("if pcall(list.setValue, list, 5, 1) then error('invalid index') end");
+  luaExecStr("if pcall(list.setValue, list, 3, 1, 0) then error('invalid maxfill') end");
+  luaExecStr("lcd.drawList(list) lcd.drawList(list, 10, 10)");
+  luaExecStr("list:clear() if list:getCount() ~= 0 then error('clear()') end");
+}
+
+#if defined(COLORLCD)
+TEST(Lua, testBitmapsCache)
+{
+  luaFlushBitmapsCache();
+  LuaBitmapsCacheStats before = luaBitmapsCacheStats;
+  uint32_t memory = luaExtraMemoryUsage;
+
+  luaExecStr("b1 = Bitmap.open('" TESTS_PATH "/tests/4b_20x20.bmp')");
+  luaExecStr("b2 = Bitmap.open('" TESTS_PATH "/tests/4b_20x20.bmp')");
+  luaExecStr("w, h = Bitmap.getSize(b2) if w ~= 20 or h ~= 20 then error('getSize()') end");
+  EXPECT_EQ(before.misses + 1, luaBitmapsCacheStats.misses);
+  EXPECT_EQ(before.hits + 1, luaBitmapsCacheStats.hits);
+  EXPECT_EQ(before.entries + 1, luaBitmapsCacheStats.entries);
+  // the same bitmap is shared by both objects
+  EXPECT_EQ(memory + 20 * 20 * sizeof(display_t), luaExtraMemoryUsage);
+
+  luaExecStr("usage = Bitmap.getCacheUsage() if usage.entries < 1 or usage.hits < 1 or usage.bytes < 800 then error('getCacheUsage()') end");
+
+  // unused bitmaps stay in the cache
+  luaExecStr("b1 = nil b2 = nil collectgarbage()");
+  EXPECT_EQ(before.entries + 1, luaBitmapsCacheStats.entries);
+  luaExecStr("b3 = Bitmap.open('" TESTS_PATH "/tests/4b_20x20.bmp')");
+  EXPECT_EQ(before.hits + 2, luaBitmapsCacheStats.hits);
+
+  // and are freed when flushed, not the referenced ones
+  luaFlushBitmapsCache();
+  EXPECT_EQ(before.entries + 1, luaBitmapsCacheStats.entries);
+  luaExecStr("b3 = nil collectgarbage()");
+  luaFlushBitmapsCache();
+  EXPECT_EQ(before.entries, luaBitmapsCacheStats.entries);
+  EXPECT_EQ(memory, luaExtraMemoryUsage);
+}
+#endif
+
 #endif   // #if defined(LUA)
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+#if IS_TOUCH_ENABLED()
+
+#include "touch_manager.h"
+#include "targets/i8/touch_driver.h"
+#include "targets/simu/simutouch.h"
+
+using namespace Touch;
+
+static uint32_t touchEvents;
+static uint32_t touchPresses;
+static uint32_t touchReleases;
+static int32_t touchMovedX;
+static Event touchLastEvent;
+
+static bool countTouchEvent(const Event & ev)
+{
+  touchEvents++;
+  if (ev.gesture & GEST_PRESS)
+    touchPresses++;
+  else if (ev.gesture & GEST_RELEASE)
+    touchReleases++;
+  else
+    touchMovedX += ev.touchPoints[0].pos.x - ev.touchPoints[0].lastPos.x;
+  touchLastEvent = ev;
+  return true;
+}
+
+// what the touch task does with a sample
+static void touchSample(int16_t x, bool down, uint32_t ts)
+{
+  simuTouchSample(x, 32, down, ts);
+  if (touchReadData())
+    TouchManager::instance()->driverDataReady(touchData.status);
+}
+
+// the GUI runs a frame every framePeriod samples
+static void replaySlide(int16_t fromX, int16_t step, int samples, int framePeriod)
+{
+  TouchManager * manager = TouchManager::instance();
+  uint32_t ts = 1000;
+  for (int i = 0; i <= samples + 1; i++, ts += 10) {
+    touchSample(fromX + step * min(i, samples), i <= samples, ts);
+    if (i % framePeriod == 0)
+      manager->processQueue(countTouchEvent);
+  }
+  manager->processQueue(countTouchEvent);
+}
+
+static bool touchRefused;
+
+// does not take the first move, and the touch task gets a newer sample meanwhile
+static bool refuseFirstMove(const Event & ev)
+{
+  if (!touchRefused && !(ev.gesture & (GEST_PRESS | GEST_RELEASE))) {
+    touchRefused = true;
+    touchSample(60, true, ev.timestamp + 10);
+    return false;
+  }
+  return countTouchEvent(ev);
+}
+
+class TouchTest: public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+      // raw coordinates are screen coordinates in the simulator
+      tsPoint_t points[3] = {{10, 10}, {100, 20}, {50, 60}};
+      TouchManager::calcCalibrationMatrix(points, points, &g_eeGeneral.touchCalib);
+      touchInit();
+      TouchManager::instance()->clearQueue();
+      TouchManager::instance()->resetStats();
+      touchEvents = touchPresses = touchReleases = 0;
+      touchMovedX = 0;
+    }
+};
+
+TEST_F(TouchTest, slideCoalescedPerFrame)
+{
+  // 100Hz samples, 25Hz frames
+  replaySlide(10, 2, 40, 4);
+
+  const TouchManager::Stats & stats = TouchManager::instance()->stats();
+  EXPECT_EQ(touchPresses, 1u);
+  EXPECT_EQ(touchReleases, 1u);
+  EXPECT_EQ(stats.delivered, touchEvents);
+  EXPECT_LE(touchEvents, stats.frames + 1);
+  EXPECT_GT(stats.coalesced, 0u);
+  // the deltas of the coalesced moves add up to the whole slide
+  EXPECT_EQ(touchMovedX, 80);
+  EXPECT_EQ(touchLastEvent.touchPoints[0].pos.x, 90);
+}
+
+TEST_F(TouchTest, velocityAndInertia)
+{
+  replaySlide(10, 2, 40, 4);
+
+  // 2px every 10ms, kept after the release
+  const TouchPoint & point = touchLastEvent.touchPoints[0];
+  EXPECT_TRUE(touchLastEvent.gesture & GEST_RELEASE);
+  EXPECT_NEAR(point.velocity().x, 200.0f, 1.0f);
+  EXPECT_NEAR(point.velocity().y, 0.0f, 0.01f);
+  EXPECT_NEAR(point.inertia(0).x, 0.0f, 0.01f);
+  EXPECT_NEAR(point.inertia(TOUCH_INERTIA_TM * 20).x, 200.0f * TOUCH_INERTIA_TM / 1000, 1.0f);
+}
+
+TEST_F(TouchTest, unhandledMoveRequeued)
+{
+  TouchManager * manager = TouchManager::instance();
+  // recent enough not to expire in the queue
+  tTime_t ts = TouchManager::getTime();
+  touchRefused = false;
+  touchSample(20, true, ts);
+  touchSample(40, true, ts + 10);
+  manager->processQueue(refuseFirstMove);
+  EXPECT_TRUE(touchRefused);
+
+  // the refused move comes back before the newer position, which it does not overwrite
+  manager->processQueue(countTouchEvent);
+  EXPECT_EQ(touchPresses, 1u);
+  EXPECT_EQ(touchMovedX, 40);
+  EXPECT_EQ(touchLastEvent.touchPoints[0].pos.x, 60);
+
+  touchSample(60, false, ts + 30);
+  manager->processQueue(countTouchEvent);
+  EXPECT_EQ(touchReleases, 1u);
+}
+
+TEST_F(TouchTest, everySampleWithoutFrameDrops)
+{
+  // a GUI as fast as the samples gets every move
+  replaySlide(10, 2, 40, 1);
+
+  const TouchManager::Stats & stats = TouchManager::instance()->stats();
+  EXPECT_EQ(stats.coalesced, 0u);
+  EXPECT_EQ(touchEvents, 42u);
+  EXPECT_EQ(touchMovedX, 80);
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) OpenTX
+ *
+ * Based on code named
+ *   th9x - http://code.google.com/p/th9x 
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+
+// Pulses are captured with a 2MHz timer
+#define PPM_CAPTURE(us)  (capture += 2 * (us), captureTrainerPulses(capture))
+
+TEST(Trainer, ppmSnapshot)
+{
+  uint16_t capture = 0;
+
+  SYSTEM_RESET();
+  ppmInputValidityTimer = 0;
+
+  PPM_CAPTURE(5000);
+  for (int i=0; i<8; i++) {
+    PPM_CAPTURE(1500 + 50 * i);
+  }
+  trainerUpdateInput();
+  EXPECT_EQ(ppmInputValidityTimer, 0); // the frame is published on the next reset pulse
+
+  PPM_CAPTURE(5000);
+  EXPECT_EQ(ppmInputValidityTimer, PPM_IN_VALID_TIMEOUT);
+
+  TrainerSnapshot snapshot;
+  trainerReadSnapshot(snapshot);
+  EXPECT_EQ(snapshot.source, TRAINER_INPUT_PPM);
+  EXPECT_EQ(snapshot.count, 8);
+  EXPECT_EQ(snapshot.timestamp, get_tmr10ms());
+
+  trainerUpdateInput();
+  for (int i=0; i<8; i++) {
+    EXPECT_EQ(ppmInput[i], 50 * i);
+  }
+
+  // an invalid pulse drops the frame being received
+  PPM_CAPTURE(1000); // -500
+  PPM_CAPTURE(100);
+  PPM_CAPTURE(5000);
+  trainerUpdateInput();
+  EXPECT_EQ(ppmInput[0], 0);
+  EXPECT_EQ(ppmInput[1], 50);
+}
+
+#if defined(SBUS)
+TEST(Trainer, sbusUnpack)
+{
+  uint8_t frame[SBUS_FRAME_SIZE];
+  int16_t reference[SBUS_CHANNELS];
+  int16_t channels[SBUS_CHANNELS];
+
+  srand(0);
+  for (int i=0; i<10000; i++) {
+    for (int j=0; j<SBUS_FRAME_SIZE; j++) {
+      frame[j] = rand();
+    }
+    sbusUnpackChannelsBitwise(frame + 1, reference);
+    sbusUnpackChannels(frame + 1, channels);
+    for (int ch=0; ch<SBUS_CHANNELS; ch++) {
+      ASSERT_EQ(channels[ch], reference[ch]);
+    }
+  }
+}
+
+TEST(Trainer, sbusFrame)
+{
+  uint8_t frame[SBUS_FRAME_SIZE] = { 0x0F };
+
+  // all channels at 0x3E0 + 8 (5 after scaling)
+  for (int ch=0; ch<SBUS_CHANNELS; ch++) {
+    uint32_t bit = 8 + ch * SBUS_CH_BITS;
+    for (int b=0; b<SBUS_CH_BITS; b++) {
+      if ((0x3E8 >> b) & 1)
+        frame[(bit + b) / 8] |= 1 << ((bit + b) % 8);
+    }
+  }
+
+  ppmInputValidityTimer = 0;
+  frame[23] = 0x08; // failsafe
+  processSbusFrame(frame, trainerBeginSnapshot(), SBUS_FRAME_SIZE);
+  EXPECT_EQ(ppmInputValidityTimer, 0);
+
+  frame[23] = 0;
+  processSbusFrame(frame, trainerBeginSnapshot(), SBUS_FRAME_SIZE);
+  EXPECT_EQ(ppmInputValidityTimer, PPM_IN_VALID_TIMEOUT);
+  trainerUpdateInput();
+  for (int ch=0; ch<SBUS_CHANNELS; ch++) {
+    EXPECT_EQ(ppmInput[ch], 5);
+  }
+}
+#endif
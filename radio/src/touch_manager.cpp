@@ -26,22 +26,19 @@
   #include "CoOS.h"
 #endif
 
-#define MS_PER_TICK         (CFG_CPU_FREQ / CFG_SYSTICK_FREQ / (CFG_CPU_FREQ / 1000))
-#define TIME_TO_TICKS(_ms)  ((_ms) / MS_PER_TICK)
-#define TICKS_TO_TIME(_tk)  ((_tk) * MS_PER_TICK)
-
-#define TOUCH_TASK_PERIOD   TIME_TO_TICKS(2)    // 2ms (= 1 systick)
+#define TOUCH_TASK_PERIOD   2    // ms (= 1 systick)
 
 RTOS_TASK_HANDLE TouchManager::m_taskId;
-TaskStack<TOUCH_STACK_SIZE> __ALIGNED(8) TouchManager::m_taskStack;
+RTOS_DEFINE_STACK(TouchManager::m_taskStack, TOUCH_STACK_SIZE);
 
 using namespace Touch;
 
 // This is simply to trigger the TouchManager::run() function since CoOS/pthread can't seem to access it otherwise (compiler errors or warnings generated).
-void touchManagerTask(void * pdata)
+TASK_FUNCTION(touchManagerTask)
 {
   if (TouchManager::instance())
     TouchManager::instance()->run(pdata);
+  TASK_RETURN();
 }
 
 TouchManager * TouchManager::instance()
@@ -51,7 +48,9 @@ TouchManager * TouchManager::instance()
 }
 
 TouchManager::TouchManager() :
-  m_detectRotations(false)
+  m_detectRotations(false),
+  m_hasPendingUpdate(false),
+  m_stats()
 {
 }
 
@@ -64,9 +63,9 @@ bool TouchManager::init()
   touchData.reportMoveEvents = true;
   //touchData.touchManager = this;    // if this is set then the touch driver calls TouchManager::driverDataReady() (pushes data vs. pulling it)
 
-  m_taskId = CoCreateTask(touchManagerTask, NULL, TOUCH_TASK_PRIO, &m_taskStack.stack[TOUCH_STACK_SIZE-1], TOUCH_STACK_SIZE);
-  m_eventQueMtxId = CoCreateMutex();
-  m_callbackMtxId = CoCreateMutex();
+  RTOS_CREATE_MUTEX(m_eventQueMtxId);
+  RTOS_CREATE_MUTEX(m_callbackMtxId);
+  RTOS_CREATE_TASK(m_taskId, touchManagerTask, "Touch", m_taskStack, TOUCH_STACK_SIZE, TOUCH_TASK_PRIO);
 
   return touchData.initialized;
 }
@@ -77,7 +76,7 @@ void TouchManager::run(void * /*pdata*/)
   //tTime_t lastQueCheck = getTime();
 
   // wait for radio settings to be read and other vital startup tasks to complete
-  (void)CoWaitForSingleFlag(openTxInitCompleteFlag, 0);
+  (void)RTOS_WAIT_FLAG(openTxInitCompleteFlag, 0);
 
   while(1)
   {
@@ -90,7 +89,7 @@ void TouchManager::run(void * /*pdata*/)
     if ((tdStat = touchReadData())) {
       // touchReadData() returns -1 for delayed read, >0 for immediate read, 0 for no data
       // in case of delayed read (DMA), wait for ready flag
-      if (tdStat > 0 || CoWaitForSingleFlag(touchData.dataReadyFlag, TOUCH_TASK_PERIOD * 3) == E_OK)
+      if (tdStat > 0 || !RTOS_WAIT_FLAG(touchData.dataReadyFlag, TOUCH_TASK_PERIOD * 3))
         driverDataReady(touchData.status);
     }
 
@@ -105,7 +104,7 @@ void TouchManager::run(void * /*pdata*/)
     //      lastQueCheck = now;
     //    }
 
-    CoTickDelay(TOUCH_TASK_PERIOD);
+    RTOS_WAIT_MS(TOUCH_TASK_PERIOD);
   }
 }
 
@@ -138,6 +137,8 @@ bool TouchManager::rawEvent(const RawTrackingPoint & rtp)
     return false;
   }
 
+  ++m_stats.samples;
+
   const bool newEvt = ((rtp.state & ST_PRESS) || pt.serId != rtp.serId);
 
   if (newEvt) {
@@ -149,6 +150,7 @@ bool TouchManager::rawEvent(const RawTrackingPoint & rtp)
     pt.lastPos = {0, 0};
     pt.holdTm = 0;
     pt.moveStartTm = 0;
+    pt.speed = {0, 0};
     calibratedPoint(&pt.startPos, &rtp.pos, getCalibration());
     pt.pos = pt.startPos;
   }
@@ -164,11 +166,18 @@ bool TouchManager::rawEvent(const RawTrackingPoint & rtp)
         pt.holdTm = 0;
         if (!pt.moveStartTm)
           pt.moveStartTm = rtp.ts;
+        // smoothed here rather than in the GUI, which only sees one sample per frame
+        if (rtp.ts != pt.lastTm) {
+          Vector2F sample = Vector2F(pt.pos - pt.lastPos) * (1e3f / (rtp.ts - pt.lastTm));
+          pt.speed += (sample - pt.speed) * TOUCH_VELOCITY_WEIGHT;
+        }
       }
       else if (rtp.state & ST_HOLD) {
         pt.holdTm += rtp.ts - pt.lastTm;
+        pt.speed = {0, 0};
       }
     }
+    // on release the speed is kept for the inertia
   }
 
   pt.rawPos = rtp.pos;
@@ -359,19 +368,64 @@ void TouchManager::generateEvent(uint8_t numPoints)
   //event.debug(0);
 }
 
-void TouchManager::enqueue(const Event & ev)
+// moves and holds of a series in progress, only the latest one matters to the GUI
+static bool isUpdate(const Event & ev)
+{
+  return !(ev.gesture & (GEST_PRESS | GEST_RELEASE));
+}
+
+// queue mutex must be held
+void TouchManager::pushEvent(const Event & ev)
 {
-  RTOS_LOCK_MUTEX(m_eventQueMtxId);
   if (m_eventQue.isFull())
-    m_eventQue.pop();
+    m_eventQue.skip();
   m_eventQue.push(ev);
+}
+
+// queue mutex must be held
+void TouchManager::flushPendingUpdate()
+{
+  if (m_hasPendingUpdate) {
+    pushEvent(m_pendingUpdate);
+    m_hasPendingUpdate = false;
+  }
+}
+
+void TouchManager::enqueue(const Event & ev)
+{
+  RTOS_LOCK_MUTEX(m_eventQueMtxId);
+  if (isUpdate(ev)) {
+    if (m_hasPendingUpdate && m_pendingUpdate.seriesId == ev.seriesId && m_pendingUpdate.pointCount == ev.pointCount) {
+      // latest position wins, but the deltas start from the position of the last delivered event
+      for (uint8_t i=0; i < ev.pointCount; ++i) {
+        TouchPoint & pt = m_pendingUpdate.touchPoints[i];
+        const tTime_t lastTm = pt.lastTm;
+        const tVect_t lastPos = pt.lastPos;
+        pt = ev.touchPoints[i];
+        pt.lastTm = lastTm;
+        pt.lastPos = lastPos;
+      }
+      m_pendingUpdate.gesture = ev.gesture;
+      m_pendingUpdate.timestamp = ev.timestamp;
+      ++m_stats.coalesced;
+    }
+    else {
+      flushPendingUpdate();
+      m_pendingUpdate = ev;
+      m_hasPendingUpdate = true;
+    }
+  }
+  else {
+    flushPendingUpdate();
+    pushEvent(ev);
+  }
   RTOS_UNLOCK_MUTEX(m_eventQueMtxId);
 }
 
 void TouchManager::processQueue(eventCallback_t cb)
 {
   //processQueue((eventCallbackL_t)cb, NULL);
-  if (!cb || m_eventQue.isEmpty())
+  if (!cb)
     return;
 
   Event ev;
@@ -379,6 +433,8 @@ void TouchManager::processQueue(eventCallback_t cb)
   Fifo<Touch::Event, TOUCH_MAX_QUEUE_LEN> tempQ;
 
   RTOS_LOCK_MUTEX(m_eventQueMtxId);  // lock while copy
+  ++m_stats.frames;
+  flushPendingUpdate();  // the frame gets the latest position
   while (m_eventQue.pop(ev))
     tempQ.push(ev);
   RTOS_UNLOCK_MUTEX(m_eventQueMtxId);
@@ -389,8 +445,14 @@ void TouchManager::processQueue(eventCallback_t cb)
     RTOS_LOCK_MUTEX(m_callbackMtxId);  // current callback has priority
     const bool ret = cb(ev);
     RTOS_UNLOCK_MUTEX(m_callbackMtxId);
-    if (!ret && (now - ev.timestamp) < TOUCH_MAX_QUEUE_TIME)
-      enqueue(ev);   // if callback doesn't handle event and it is not too old, add it back to queue
+    ++m_stats.delivered;
+    if (!ret && (now - ev.timestamp) < TOUCH_MAX_QUEUE_TIME) {
+      // if callback doesn't handle event and it is not too old, add it back to queue,
+      // as is: it must not be merged into a newer pending update of its series
+      RTOS_LOCK_MUTEX(m_eventQueMtxId);
+      pushEvent(ev);
+      RTOS_UNLOCK_MUTEX(m_eventQueMtxId);
+    }
   }
 }
 
@@ -398,6 +460,7 @@ void TouchManager::clearQueue()
 {
   RTOS_LOCK_MUTEX(m_eventQueMtxId);
   m_eventQue.clear();
+  m_hasPendingUpdate = false;
   RTOS_UNLOCK_MUTEX(m_eventQueMtxId);
 }
 
@@ -408,7 +471,7 @@ void TouchManager::clearQueue()
 
 tTime_t TouchManager::getTime()
 {
-  return (tTime_t)TICKS_TO_TIME(CoGetOSTime());
+  return (tTime_t)RTOS_GET_MS();
 }
 
 
@@ -33,6 +33,12 @@
 #include <vector>
 //#include <functional>
 
+#if defined(SIMU)
+  typedef FakeTaskStack<TOUCH_STACK_SIZE> TouchTaskStack;
+#else
+  typedef TaskStack<TOUCH_STACK_SIZE> TouchTaskStack;
+#endif
+
 #ifndef TOUCH_COORD_UNIT_TYPE
   #define TOUCH_COORD_UNIT_TYPE  int16_t  //! size of type used for coordinates, should be signed or real
 #endif
@@ -47,6 +53,8 @@
 #define TOUCH_SWIPE_MIN_DIST     5     //! [px] Minimum distance for a move to count as a swipe.
 #define TOUCH_TAP_RADIUS_SZ      4     //! [px] Radius within which a touch is still a tap vs. drag, (consecutive taps must be within same radius).
 #define TOUCH_MIN_MOVE_DIST      2     //! [px] Minimum normalized distance before a move event is registered (prevents jitter).
+#define TOUCH_VELOCITY_WEIGHT    0.4f  //! Weight of the newest sample in the smoothed velocity (0..1, higher follows faster but is noisier).
+#define TOUCH_INERTIA_TM         325   //! [ms] Time constant of the glide after a release, the velocity decays by e in this time.
 
 
 namespace Touch {
@@ -155,11 +163,18 @@ struct TouchPoint {
   Touch::tVect_t lastPos;      //! [px] position of previous event in this series in calibrated coordinates (invalid on series start)
   Touch::tTime_t holdTm;       //! [ms] elapsed time w/out moving
   Touch::tTime_t moveStartTm;  //! [ms] time first move detected
+  Vector2F speed;              //! [px/s] smoothed velocity, computed by the touch task and kept after a release
 
-  //! Returns current speed of movement in each direction as absolute [px/s].
-  inline Touch::tVect_t velocity() const
+  //! Returns current speed of movement in each direction [px/s], negative values are to the left/top.
+  inline Vector2F velocity() const
   {
-    return pos.distVect(lastPos) / ((timestamp - lastTm) / 1e3f);
+    return speed;
+  }
+
+  //! Returns how far [px] a released point keeps gliding in \a elapsed [ms] since the release (eg. for scrolling lists).
+  inline Vector2F inertia(Touch::tTime_t elapsed) const
+  {
+    return speed * ((TOUCH_INERTIA_TM / 1e3f) * (1.0f - expf(-float(elapsed) / TOUCH_INERTIA_TM)));
   }
 
   //! Returns scale factor relative to another point since start of history. Values > 1 are outward (points are getting further apart), < 1 are inward.
@@ -232,6 +247,10 @@ PACK(struct CalibMatrix {
   currently in the queue. The callback function must return true or false to indicate if it handled the event or not.  If the event was not hanlded by the callback, it is added back
   to the queue, otherwise it is dicarded.
 
+  processQueue() is meant to be called once per GUI frame. Moves and holds of the same series are coalesced until then: the latest position wins, while
+  TouchPoint::lastPos and TouchPoint::lastTm still refer to the position delivered in the previous frame, so the deltas add up. Press and release
+  events are never coalesced.
+
   The callback function signature (typedef eventCallback_t) is: \e bool(*)(const Touch::Event &)
 
   Callbacks can be regular or lambda functions. If the lambda does not need to capture, then it can be used like any other function. (Note: Global and any static vars do not need to be captured.)
@@ -289,6 +308,15 @@ class TouchManager
     void processQueue(Touch::eventCallback_t cb);
     //! Remove all touch events from pending queue.
     void clearQueue();
+    //! Counters of the touch pipeline, to compare the events delivered with the frames (processQueue() calls).
+    struct Stats {
+      uint32_t samples;    //! raw samples from the driver
+      uint32_t coalesced;  //! move or hold events merged into a later one before delivery
+      uint32_t delivered;  //! events given to a callback
+      uint32_t frames;     //! processQueue() calls
+    };
+    const Stats & stats() const { return m_stats; }
+    void resetStats() { m_stats = {0, 0, 0, 0}; }
     //! Place an event in the queue
     void enqueue(const Touch::Event & ev);
     //! Used by touch driver to signal that new data has arrived.
@@ -312,7 +340,7 @@ class TouchManager
 
     // These functions are used by the main task management system to get process and stack info.
     static RTOS_TASK_HANDLE taskId() { return m_taskId; }
-    static TaskStack<TOUCH_STACK_SIZE> & taskStack() { return m_taskStack; }
+    static TouchTaskStack & taskStack() { return m_taskStack; }
     //! TouchManager task code. Do not call this directly, it's only public because it needs to be for task manager.
     void run(void * /*pdata*/);
 
@@ -366,15 +394,20 @@ class TouchManager
 
   protected:
     void generateEvent(uint8_t numPoints);
+    void pushEvent(const Touch::Event & ev);
+    void flushPendingUpdate();
 
     bool m_detectRotations;
     Touch::TouchPoint m_points[TOUCH_POINTS];
     Fifo<Touch::Event, TOUCH_MAX_QUEUE_LEN> m_eventQue;
+    Touch::Event m_pendingUpdate;  //! latest move or hold, queued when something else happens or at the next frame
+    bool m_hasPendingUpdate;
+    Stats m_stats;
 
-    OS_MutexID m_eventQueMtxId;
-    OS_MutexID m_callbackMtxId;
+    RTOS_MUTEX_HANDLE m_eventQueMtxId;
+    RTOS_MUTEX_HANDLE m_callbackMtxId;
     static RTOS_TASK_HANDLE m_taskId;
-    static TaskStack<TOUCH_STACK_SIZE> __ALIGNED(8) m_taskStack;
+    static RTOS_DEFINE_STACK(m_taskStack, TOUCH_STACK_SIZE);
 };
 
 
@@ -23,6 +23,37 @@
 int16_t ppmInput[MAX_TRAINER_CHANNELS];
 uint8_t ppmInputValidityTimer;
 
+TrainerSnapshot trainerSnapshots[2];
+volatile uint8_t trainerFrontSnapshot = 0;
+volatile uint16_t trainerSnapshotSequence = 0;
+
+// Decoders may publish from an ISR while the mixer copies the front snapshot,
+// the copy is retried when a publish happened in the meantime
+uint16_t trainerReadSnapshot(TrainerSnapshot & snapshot)
+{
+  uint16_t sequence;
+  do {
+    sequence = trainerSnapshotSequence;
+    TRAINER_SNAPSHOT_BARRIER();
+    snapshot = trainerSnapshots[trainerFrontSnapshot];
+    TRAINER_SNAPSHOT_BARRIER();
+  } while (sequence != trainerSnapshotSequence);
+  return sequence;
+}
+
+// Called by the mixer before evaluating the inputs, ppmInput then holds
+// a whole frame from a single decoder
+void trainerUpdateInput()
+{
+  static uint16_t lastSequence = 0;
+
+  if (trainerSnapshotSequence != lastSequence) {
+    TrainerSnapshot snapshot;
+    lastSequence = trainerReadSnapshot(snapshot);
+    memcpy(ppmInput, snapshot.channels, sizeof(ppmInput));
+  }
+}
+
 
 #if defined(CPUARM)
 #include "audio_arm.h"
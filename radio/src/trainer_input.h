@@ -32,6 +32,53 @@ extern uint8_t ppmInputValidityTimer;
 
 #define IS_TRAINER_INPUT_VALID() (ppmInputValidityTimer != 0)
 
+// Trainer input snapshots: decoders fill the back snapshot and publish it
+// when a frame is complete, the mixer copies the front one into ppmInput
+enum TrainerInputSource {
+  TRAINER_INPUT_NONE,
+  TRAINER_INPUT_PPM,
+  TRAINER_INPUT_SBUS,
+  TRAINER_INPUT_BLUETOOTH,
+  TRAINER_INPUT_MULTI,
+  TRAINER_INPUT_SIMU,
+};
+
+struct TrainerSnapshot {
+  int16_t channels[MAX_TRAINER_CHANNELS];
+  tmr10ms_t timestamp;
+  uint8_t source;
+  uint8_t count;
+};
+
+extern TrainerSnapshot trainerSnapshots[2];
+extern volatile uint8_t trainerFrontSnapshot;
+extern volatile uint16_t trainerSnapshotSequence;
+
+#define TRAINER_SNAPSHOT_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+// Returns the channels of the back snapshot, initialized with the current frame
+// so that decoders which only receive some channels keep the others
+inline int16_t * trainerBeginSnapshot()
+{
+  TrainerSnapshot & back = trainerSnapshots[trainerFrontSnapshot ^ 1];
+  memcpy(back.channels, trainerSnapshots[trainerFrontSnapshot].channels, sizeof(back.channels));
+  return back.channels;
+}
+
+inline void trainerPublishSnapshot(uint8_t source, uint8_t count)
+{
+  TrainerSnapshot & back = trainerSnapshots[trainerFrontSnapshot ^ 1];
+  back.timestamp = get_tmr10ms();
+  back.source = source;
+  back.count = count;
+  TRAINER_SNAPSHOT_BARRIER();
+  trainerFrontSnapshot ^= 1;
+  trainerSnapshotSequence++;
+}
+
+uint16_t trainerReadSnapshot(TrainerSnapshot & snapshot);
+void trainerUpdateInput();
+
 #if defined(CPUARM)
 void checkTrainerSignalWarning();
 #else
@@ -43,6 +90,7 @@ inline void captureTrainerPulses(uint16_t capture)
 {
   static uint16_t lastCapt = 0;
   static int8_t channelNumber = -1;
+  static int16_t * channels;
 
   uint16_t val = (uint16_t)(capture - lastCapt) / 2;
   lastCapt = capture;
@@ -53,18 +101,27 @@ inline void captureTrainerPulses(uint16_t capture)
   // G: Prioritize reset pulse. (Needed when less than 16 incoming pulses)
   //
   if (val > 4000 && val < 19000) {
+    if (channelNumber > 0) {
+      trainerPublishSnapshot(TRAINER_INPUT_PPM, channelNumber);
+      ppmInputValidityTimer = PPM_IN_VALID_TIMEOUT;
+    }
+    channels = trainerBeginSnapshot();
     channelNumber = 0; // triggered
   }
   else {
     if (channelNumber >= 0 && channelNumber < MAX_TRAINER_CHANNELS) {
       if (val > 800 && val < 2200) {
-        ppmInputValidityTimer = PPM_IN_VALID_TIMEOUT;
-        ppmInput[channelNumber++] =
+        channels[channelNumber++] =
           // +-500 != 512, but close enough.
           (int16_t)(val - 1500) * (g_eeGeneral.PPM_Multiplier+10) / 10;
+        if (channelNumber == MAX_TRAINER_CHANNELS) {
+          trainerPublishSnapshot(TRAINER_INPUT_PPM, channelNumber);
+          ppmInputValidityTimer = PPM_IN_VALID_TIMEOUT;
+          channelNumber = -1; // wait for the next reset pulse
+        }
       }
       else {
-        channelNumber = -1; // not triggered
+        channelNumber = -1; // not triggered, the partial frame is dropped
       }
     }
   }
@@ -601,6 +601,7 @@ const pm_char STR_DURATION[] PROGMEM = TR_DURATION;
 const pm_char STR_DELAY[] PROGMEM = TR_DELAY;
 const pm_char STR_SD_CARD[] PROGMEM = TR_SD_CARD;
 const pm_char STR_SDHC_CARD[] PROGMEM = TR_SDHC_CARD;
+const pm_char STR_SD_LOADING[] PROGMEM = TR_SD_LOADING;
 const pm_char STR_NO_SOUNDS_ON_SD[] PROGMEM = TR_NO_SOUNDS_ON_SD;
 const pm_char STR_NO_MODELS_ON_SD[] PROGMEM = TR_NO_MODELS_ON_SD;
 const pm_char STR_NO_BITMAPS_ON_SD[] PROGMEM = TR_NO_BITMAPS_ON_SD;
@@ -842,6 +842,7 @@ extern const pm_char STR_DURATION[];
 extern const pm_char STR_DELAY[];
 extern const pm_char STR_SD_CARD[];
 extern const pm_char STR_SDHC_CARD[];
+extern const pm_char STR_SD_LOADING[];
 extern const pm_char STR_NO_SOUNDS_ON_SD[];
 extern const pm_char STR_NO_MODELS_ON_SD[];
 extern const pm_char STR_NO_BITMAPS_ON_SD[];
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+
+"""
+Compares two Google Benchmark JSON outputs of the gbench target
+(radio/src/tests/benchmarks), typically from two builds:
+
+  ./gbench --benchmark_out=before.json --benchmark_repetitions=5
+  ...
+  ./gbench --benchmark_out=after.json --benchmark_repetitions=5
+  bench-compare.py before.json after.json --threshold 10
+
+When repetitions were used, the median of each benchmark is compared.
+Exits with 1 when a benchmark is slower than the threshold (in %).
+"""
+
+import argparse
+import json
+import sys
+
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    with open(path) as f:
+        data = json.load(f)
+    runs = {}
+    medians = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        value = bench[metric] * TIME_UNITS.get(bench.get("time_unit", "ns"), 1.0)
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[bench["run_name"]] = value
+        else:
+            runs.setdefault(bench.get("run_name", bench["name"]), value)
+    runs.update(medians)
+    return runs
+
+
+def format_time(ns):
+    for unit in ("ns", "us", "ms"):
+        if ns < 1000:
+            return "%.1f%s" % (ns, unit)
+        ns /= 1000.0
+    return "%.2fs" % ns
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flags the benchmark regressions between two gbench runs")
+    parser.add_argument("baseline", help="JSON output of the reference build")
+    parser.add_argument("contender", help="JSON output of the build to check")
+    parser.add_argument("--threshold", type=float, default=10.0, help="regression threshold in %% (default: 10)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time", help="compared time (default: cpu_time)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    contender = load(args.contender, args.metric)
+
+    regressions = 0
+    for name in sorted(set(baseline) | set(contender)):
+        if name not in contender:
+            print("%-60s removed" % name)
+            continue
+        if name not in baseline:
+            print("%-60s %10s new" % (name, format_time(contender[name])))
+            continue
+        old, new = baseline[name], contender[name]
+        change = (new - old) * 100.0 / old if old else 0
+        status = ""
+        if change > args.threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            status = "improvement"
+        print("%-60s %10s %10s %+7.1f%% %s" % (name, format_time(old), format_time(new), change, status))
+
+    print("%d regression(s) above %.1f%%" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+
+"""
+Host side of the CLI binary streaming mode (radio/src/cli_stream.cpp). It
+sends a "stream" command to the radio CLI and decodes the framed answer.
+
+  cli-stream.py --port /dev/ttyACM0 file /LOGS/flight.csv -o flight.csv
+  cli-stream.py --port /dev/ttyACM0 sd 0 2048 -o sectors.bin
+  cli-stream.py --port /dev/ttyACM0 mem 0xD0000000 0x100000 -o sdram.bin
+  cli-stream.py --port /dev/ttyACM0 test 1000000
+  cli-stream.py --port /dev/ttyACM0 traces
+  cli-stream.py --port /dev/ttyACM0 timers --interval 1
+
+--port needs pyserial. --simu runs the CLI stand-in of the simulator
+(simucli target, radio/src/targets/simu/simucli.cpp) and talks to it through
+pipes instead, for instance:
+
+  cli-stream.py --simu "simucli --sd sdcard" file /RADIO/radio.bin -o radio.bin
+  cli-stream.py --simu simucli test 10000000
+
+Frame: A5 5A <type> <seq> <length:16> <payload> <crc:16>, little endian, the
+CRC16 (CCITT, 0x1021, initial value 0) covers type to the end of the payload.
+"""
+
+import argparse
+import binascii
+import os
+import queue
+import shlex
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+SYNC = b"\xa5\x5a"
+HEADER_SIZE = 6
+CRC_SIZE = 2
+MAX_PAYLOAD = 4 + 512
+
+FRAME_DATA = 1
+FRAME_END = 2
+FRAME_TRACE = 3
+FRAME_TIMERS = 4
+
+STATUS = ["ok", "invalid argument", "read error", "timeout on the radio side", "unsupported"]
+
+
+class FrameDecoder(object):
+    """Splits the serial line into text and frames, resyncing on CRC errors"""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.crc_errors = 0
+        self.lost_frames = 0
+        self.last_sequence = None
+
+    def feed(self, data):
+        self.buffer += data
+        events = []
+        while True:
+            index = self.buffer.find(SYNC)
+            if index < 0:
+                # a sync byte at the end may be the start of the next frame
+                keep = 1 if self.buffer.endswith(SYNC[:1]) else 0
+                if len(self.buffer) > keep:
+                    events.append(("text", bytes(self.buffer[:len(self.buffer) - keep])))
+                    del self.buffer[:len(self.buffer) - keep]
+                break
+            if index > 0:
+                events.append(("text", bytes(self.buffer[:index])))
+                del self.buffer[:index]
+            if len(self.buffer) < HEADER_SIZE:
+                break
+            frame_type, sequence, length = struct.unpack_from("<BBH", self.buffer, 2)
+            if length > MAX_PAYLOAD:
+                self.crc_errors += 1
+                del self.buffer[:1]
+                continue
+            total = HEADER_SIZE + length + CRC_SIZE
+            if len(self.buffer) < total:
+                break
+            crc = struct.unpack_from("<H", self.buffer, HEADER_SIZE + length)[0]
+            if binascii.crc_hqx(bytes(self.buffer[2:HEADER_SIZE + length]), 0) != crc:
+                self.crc_errors += 1
+                del self.buffer[:1]
+                continue
+            if self.last_sequence is not None:
+                self.lost_frames += (sequence - self.last_sequence - 1) & 0xFF
+            self.last_sequence = sequence
+            events.append(("frame", frame_type, bytes(self.buffer[HEADER_SIZE:HEADER_SIZE + length])))
+            del self.buffer[:total]
+        return events
+
+
+class SerialLink(object):
+    def __init__(self, port, baudrate):
+        import serial
+        self.serial = serial.Serial(port, baudrate, timeout=0.1)
+
+    def write(self, data):
+        self.serial.write(data)
+
+    def read(self):
+        return self.serial.read(max(1, self.serial.in_waiting))
+
+    def close(self):
+        self.serial.close()
+
+
+class SimuLink(object):
+    def __init__(self, command):
+        self.process = subprocess.Popen(shlex.split(command), stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        self.queue = queue.Queue()
+        self.thread = threading.Thread(target=self.reader)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def reader(self):
+        while True:
+            data = os.read(self.process.stdout.fileno(), 65536)
+            self.queue.put(data)
+            if not data:
+                break
+
+    def write(self, data):
+        self.process.stdin.write(data)
+        self.process.stdin.flush()
+
+    def read(self):
+        try:
+            data = self.queue.get(timeout=0.1)
+        except queue.Empty:
+            return b""
+        if not data:
+            raise IOError("simulator CLI exited")
+        return data
+
+    def close(self):
+        self.process.stdin.close()
+        self.process.wait()
+
+
+class Session(object):
+    def __init__(self, link, args):
+        self.link = link
+        self.args = args
+        self.decoder = FrameDecoder()
+
+    def command(self, line, on_frame):
+        """Sends a stream command and calls on_frame() until its END frame, returns (status, bytes, duration ms)"""
+        self.link.write(line.encode() + b"\r")
+        last_activity = time.time()
+        while True:
+            data = self.link.read()
+            if data:
+                last_activity = time.time()
+            elif time.time() - last_activity > self.args.timeout:
+                raise IOError("no answer from the radio for %ds" % self.args.timeout)
+            for event in self.decoder.feed(data):
+                if event[0] == "text":
+                    if self.args.verbose:
+                        sys.stderr.write(event[1].decode(errors="replace"))
+                elif event[1] == FRAME_END:
+                    return struct.unpack("<BII", event[2])
+                elif event[1] == FRAME_TRACE:
+                    print_trace(event[2])
+                else:
+                    on_frame(event[1], event[2])
+
+
+def print_trace(payload):
+    sys.stdout.write(payload.decode(errors="replace").rstrip("\r\n") + "\n")
+    sys.stdout.flush()
+
+
+def test_pattern(offset, length):
+    return bytes(bytearray(((position ^ (position >> 8)) & 0xFF) for position in range(offset, offset + length)))
+
+
+def bulk(session, args):
+    output = open(args.output, "wb") if args.output else None
+    state = {"bytes": 0, "gaps": 0, "mismatches": 0, "next": 0}
+
+    def on_frame(frame_type, payload):
+        if frame_type != FRAME_DATA:
+            return
+        offset = struct.unpack_from("<I", payload)[0]
+        data = payload[4:]
+        if offset != state["next"]:
+            state["gaps"] += 1
+        state["next"] = offset + len(data)
+        state["bytes"] += len(data)
+        if output:
+            output.seek(offset)
+            output.write(data)
+        if args.what == "test" and data != test_pattern(offset, len(data)):
+            state["mismatches"] += 1
+
+    start = time.time()
+    status, total, duration = session.command(" ".join(["stream", args.what] + args.params), on_frame)
+    elapsed = time.time() - start
+    if output:
+        output.close()
+
+    print("%s: %d bytes received, %d announced, %.2fs (%d ms on the radio), %.1f kB/s" %
+          (STATUS[status] if status < len(STATUS) else status, state["bytes"], total, elapsed, duration,
+           state["bytes"] / 1024.0 / max(elapsed, 0.001)))
+    decoder = session.decoder
+    if decoder.crc_errors or decoder.lost_frames or state["gaps"] or state["mismatches"]:
+        print("%d CRC errors, %d lost frames, %d gaps, %d pattern mismatches" %
+              (decoder.crc_errors, decoder.lost_frames, state["gaps"], state["mismatches"]))
+        return 1
+    return 0 if status == 0 and state["bytes"] == total else 1
+
+
+def traces(session, args):
+    status = session.command("stream traces on", lambda frame_type, payload: None)[0]
+    if status != 0:
+        print("stream traces on: %s" % STATUS[status])
+        return 1
+    try:
+        while True:
+            for event in session.decoder.feed(session.link.read()):
+                if event[0] == "frame" and event[1] == FRAME_TRACE:
+                    print_trace(event[2])
+                elif event[0] == "text" and args.verbose:
+                    sys.stderr.write(event[1].decode(errors="replace"))
+    except KeyboardInterrupt:
+        pass
+    session.command("stream traces off", lambda frame_type, payload: None)
+    return 0
+
+
+def timers(session, args):
+    def on_frame(frame_type, payload):
+        if frame_type != FRAME_TIMERS:
+            return
+        position = 0
+        while position < len(payload):
+            length = bytearray(payload[position:position + 1])[0]
+            name = payload[position + 1:position + 1 + length].decode(errors="replace")
+            minimum, maximum = struct.unpack_from("<II", payload, position + 1 + length)
+            position += 1 + length + 8
+            if minimum == 0xFFFFFFFF:
+                print("%-24s -" % name)
+            else:
+                print("%-24s %8.3fms %8.3fms" % (name, minimum / 1000.0, maximum / 1000.0))
+        print()
+
+    count = 0
+    try:
+        while not args.count or count < args.count:
+            status = session.command("stream timers", on_frame)[0]
+            if status != 0:
+                print("stream timers: %s" % STATUS[status])
+                return 1
+            count += 1
+            time.sleep(args.interval)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="CLI binary streaming client")
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument("--port", help="serial port of the radio")
+    group.add_argument("--simu", help="command line of the simulator CLI stand-in")
+    parser.add_argument("--baudrate", type=int, default=115200, help="ignored by the USB serial")
+    parser.add_argument("--timeout", type=int, default=5, help="seconds without data before giving up")
+    parser.add_argument("-v", "--verbose", action="store_true", help="show the CLI text on stderr")
+    subparsers = parser.add_subparsers(dest="what")
+    for what, params, help in (("file", ["filename"], "file on the SD card"),
+                               ("sd", ["sector", "count"], "raw SD card sectors"),
+                               ("mem", ["address", "size"], "radio memory, SDRAM included")):
+        subparser = subparsers.add_parser(what, help=help)
+        for param in params:
+            subparser.add_argument(param)
+        subparser.add_argument("-o", "--output", help="output file")
+    subparser = subparsers.add_parser("test", help="known pattern to check the link speed")
+    subparser.add_argument("size")
+    subparser = subparsers.add_parser("traces", help="show the traces until Ctrl-C")
+    subparser = subparsers.add_parser("timers", help="show the debug timers")
+    subparser.add_argument("--interval", type=float, default=1, help="seconds between two reads")
+    subparser.add_argument("--count", type=int, default=0, help="number of reads (default: until Ctrl-C)")
+    args = parser.parse_args()
+    if not args.what:
+        parser.error("nothing to stream")
+
+    link = SerialLink(args.port, args.baudrate) if args.port else SimuLink(args.simu)
+    session = Session(link, args)
+    try:
+        if args.what == "traces":
+            return traces(session, args)
+        elif args.what == "timers":
+            return timers(session, args)
+        args.params = {"file": ["filename"], "sd": ["sector", "count"], "mem": ["address", "size"], "test": ["size"]}[args.what]
+        args.params = [getattr(args, param) for param in args.params]
+        if args.what == "test":
+            args.output = None
+        return bulk(session, args)
+    except IOError as e:
+        print(e)
+        return 1
+    finally:
+        link.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
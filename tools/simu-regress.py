@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+
+"""
+Runs a set of models through the headless simulator worker (simuregress
+target, radio/src/targets/simu/simuregress.cpp) in parallel, one process per
+model, and compares the traces with a golden set.
+
+  EEPROM radios:   simu-regress.py --worker simuregress --eeprom radio1.bin --eeprom radio2.bin ...
+  SD card radios:  simu-regress.py --worker simuregress --settings settings_dir ...
+
+Each job gets its own copy of the radio data, so that the workers never share
+a file. Use --update to (re)write the golden traces.
+"""
+
+import argparse
+import difflib
+import multiprocessing
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+
+def list_models(args, source):
+    # loading the radio data may write to it, so this runs on a copy too
+    tmpdir = tempfile.mkdtemp(prefix="simu-regress-")
+    try:
+        if args.eeprom:
+            path = os.path.join(tmpdir, "eeprom.bin")
+            shutil.copyfile(source, path)
+        else:
+            path = os.path.join(tmpdir, "settings")
+            shutil.copytree(source, path)
+        cmd = [args.worker] + source_args(args, path) + ["--list"]
+        output = subprocess.check_output(cmd, stderr=subprocess.DEVNULL)
+        return output.decode().split()
+    finally:
+        shutil.rmtree(tmpdir, ignore_errors=True)
+
+
+def source_args(args, path):
+    result = ["--eeprom" if args.eeprom else "--settings", path]
+    if args.sd:
+        result += ["--sd", args.sd]
+    return result
+
+
+def job_name(source, model):
+    base = os.path.splitext(os.path.basename(os.path.normpath(source)))[0]
+    return "%s-%s" % (base, os.path.splitext(model)[0])
+
+
+def private_copy(args, source, model, tmpdir):
+    if args.eeprom:
+        path = os.path.join(tmpdir, "eeprom.bin")
+        shutil.copyfile(source, path)
+        return path
+    path = os.path.join(tmpdir, "settings")
+    shutil.copytree(os.path.join(source, "RADIO"), os.path.join(path, "RADIO"))
+    os.makedirs(os.path.join(path, "MODELS"))
+    shutil.copyfile(os.path.join(source, "MODELS", model), os.path.join(path, "MODELS", model))
+    return path
+
+
+def timeline_for(args, name):
+    if args.timelines:
+        path = os.path.join(args.timelines, name + ".txt")
+        if os.path.exists(path):
+            return path
+    return args.timeline
+
+
+def run_job(args, source, model):
+    name = job_name(source, model)
+    tmpdir = tempfile.mkdtemp(prefix="simu-regress-")
+    try:
+        trace = os.path.join(tmpdir, "trace.txt")
+        cmd = [args.worker] + source_args(args, private_copy(args, source, model, tmpdir))
+        cmd += ["--model", model, "--timeline", timeline_for(args, name), "--trace", trace]
+        if args.duration:
+            cmd += ["--duration", str(args.duration)]
+        start = time.time()
+        proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+        _, err = proc.communicate()
+        wall = time.time() - start
+        stats = {}
+        for line in err.decode(errors="replace").splitlines():
+            fields = line.split()
+            if fields and fields[0] == "ticks":
+                stats = dict(zip(fields[::2], (int(v) for v in fields[1::2])))
+        if proc.returncode != 0 or not os.path.exists(trace):
+            return name, "error", wall, stats, err.decode(errors="replace").strip()
+        with open(trace) as f:
+            lines = f.readlines()
+        return name, compare(args, name, lines), wall, stats, ""
+    finally:
+        shutil.rmtree(tmpdir, ignore_errors=True)
+
+
+def compare(args, name, lines):
+    golden = os.path.join(args.golden, name + ".trace")
+    if args.update:
+        with open(golden, "w") as f:
+            f.writelines(lines)
+        return "updated"
+    if not os.path.exists(golden):
+        return "missing"
+    with open(golden) as f:
+        expected = f.readlines()
+    if expected == lines:
+        return "ok"
+    diff = list(difflib.unified_diff(expected, lines, "golden", "current", n=0))
+    return "diff:" + "".join(diff[2:2 + args.diff_lines])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Parallel simulator regression runner")
+    parser.add_argument("--worker", required=True, help="path to the simuregress executable")
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument("--eeprom", action="append", help="EEPROM image, all its models are run")
+    group.add_argument("--settings", action="append", help="settings dir with RADIO/ and MODELS/, all its models are run")
+    parser.add_argument("--sd", help="SD card dir (sounds, scripts)")
+    parser.add_argument("--timeline", required=True, help="default input timeline")
+    parser.add_argument("--timelines", help="dir of per model timelines, named <job>.txt")
+    parser.add_argument("--duration", type=int, default=0, help="simulated time in ms (default: last event + 1s)")
+    parser.add_argument("--golden", required=True, help="dir of the golden traces")
+    parser.add_argument("--update", action="store_true", help="write the golden traces instead of comparing")
+    parser.add_argument("-j", "--jobs", type=int, default=multiprocessing.cpu_count(), help="parallel workers")
+    parser.add_argument("--diff-lines", type=int, default=10, help="diff lines shown per failing model")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.golden):
+        os.makedirs(args.golden)
+
+    jobs = []
+    for source in (args.eeprom or args.settings):
+        for model in list_models(args, source):
+            jobs.append((source, model))
+
+    failures = 0
+    start = time.time()
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as executor:
+        futures = [executor.submit(run_job, args, source, model) for source, model in jobs]
+        for future in futures:
+            name, result, wall, stats, error = future.result()
+            ticks = stats.get("ticks", 0)
+            elapsed = stats.get("elapsed_us", 0)
+            speed = (ticks * 10000.0 / elapsed) if elapsed else 0
+            status = result.split(":", 1)[0]
+            print("%-40s %-8s %6.2fs wall  %8.1fx realtime" % (name, status, wall, speed))
+            if status == "diff":
+                print(result.split(":", 1)[1].rstrip())
+            elif status == "error":
+                print("  " + error)
+            if status in ("diff", "error", "missing"):
+                failures += 1
+
+    print("%d models, %d failed, %.2fs total wall time with %d workers" % (len(jobs), failures, time.time() - start, args.jobs))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+
+"""
+Replays a telemetry capture written by a LOG_TELEMETRY firmware (LOGS/telemetry.log)
+through the headless simulator worker (simutelemetry target,
+radio/src/targets/simu/simutelemetry.cpp), once per speed multiplier, and shows
+what the telemetry task costs and how late the sensors are.
+
+  telemetry-replay.py --worker simutelemetry --capture telemetry.log --speed 1 --speed 4 --speed 16
+  telemetry-replay.py --worker simutelemetry --capture crsf.log --protocol crossfire --speed 0
+
+Speed 0 replays as fast as the parsers go and never drops a byte. The model
+(--settings or --eeprom with --model) only matters for its sensors, the
+parsers discover the missing ones.
+"""
+
+import argparse
+import subprocess
+import sys
+
+
+def run(args, speed):
+    cmd = [args.worker, "--capture", args.capture, "--speed", str(speed)]
+    if args.protocol:
+        cmd += ["--protocol", args.protocol]
+    if args.model:
+        cmd += ["--eeprom" if args.eeprom else "--settings", args.eeprom or args.settings, "--model", args.model]
+        if args.sd:
+            cmd += ["--sd", args.sd]
+    output = subprocess.check_output(cmd).decode()
+    fields = output.split()
+    return dict(zip(fields[::2], (int(v) for v in fields[1::2])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Telemetry capture replay")
+    parser.add_argument("--worker", required=True, help="path to the simutelemetry executable")
+    parser.add_argument("--capture", required=True, help="telemetry.log written by the radio")
+    parser.add_argument("--speed", type=float, action="append", help="speed multiplier, repeat for several runs (default: 1)")
+    parser.add_argument("--protocol", help="sport, d, crossfire or ghost (default: the model one)")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument("--eeprom", help="EEPROM image")
+    group.add_argument("--settings", help="settings dir with RADIO/ and MODELS/")
+    parser.add_argument("--sd", help="SD card dir")
+    parser.add_argument("--model", help="model index or file")
+    args = parser.parse_args()
+    if args.model and not (args.eeprom or args.settings):
+        parser.error("--model needs --eeprom or --settings")
+
+    print("%8s %10s %8s %12s %12s %12s %12s %12s" % ("speed", "bytes", "dropped", "task us/s", "task max us",
+                                                  "updates", "latency us", "latency max"))
+    for speed in args.speed or [1]:
+        try:
+            stats = run(args, speed)
+        except subprocess.CalledProcessError as e:
+            print("%8s worker failed (%d)" % (speed, e.returncode))
+            return 1
+        print("%8s %10d %8d %12d %12d %12d %12d %12d" % (speed, stats["bytes"], stats["dropped"], stats["wakeup_us_per_s"],
+                                                      stats["wakeup_max_us"], stats["sensor_updates"],
+                                                      stats["latency_avg_us"], stats["latency_max_us"]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())